@@ -0,0 +1,11 @@
+# the core library: cube data, config storage and math, without any il2cpp or unity dependency
+# used by both the mod build and the host build in host/, expects RAPIDJSON_INCLUDE_DIR to be set
+file(GLOB_RECURSE core_file_list CONFIGURE_DEPENDS ${CMAKE_CURRENT_LIST_DIR}/src/core/*.cpp)
+
+add_library(qubes-core STATIC ${core_file_list})
+set_target_properties(qubes-core PROPERTIES POSITION_INDEPENDENT_CODE ON)
+
+target_include_directories(qubes-core PUBLIC ${CMAKE_CURRENT_LIST_DIR}/include)
+# for the plain data types other mods see in shared/
+target_include_directories(qubes-core PUBLIC ${CMAKE_CURRENT_LIST_DIR})
+target_include_directories(qubes-core PUBLIC ${RAPIDJSON_INCLUDE_DIR})
@@ -0,0 +1,61 @@
+#include "core/animation.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace Qubes;
+
+static AnimationBatch makeBatch(int count) {
+    AnimationBatch batch;
+    Math::Random random;
+    for(int i = 0; i < count; i++) {
+        // every motion, paths less often like they would be
+        Animation animation((Motion) (1 + i % 3));
+        if(i % 50 == 0) {
+            animation.motion = Motion::Path;
+            animation.path = {{0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0}};
+        }
+        animation.phase = random.value();
+        Pose base = {random.insideUnitSphere() * 10, Math::euler(0, random.range(0, 360), 0)};
+        batch.add(animation, base, 1);
+    }
+    return batch;
+}
+
+// a camera at the origin looking down -z, like Camera.cullingMatrix with an identity view
+static Math::Frustum makeFrustum() {
+    float near = 0.1, far = 100, f = 1 / std::tan(45 * Math::Deg2Rad);
+    float m[4][4] = {
+        {f, 0, 0, 0},
+        {0, f, 0, 0},
+        {0, 0, (far + near) / (near - far), 2 * far * near / (near - far)},
+        {0, 0, -1, 0}
+    };
+    return Math::Frustum::fromMatrix(m);
+}
+
+// the whole per frame kernel, poses and visibility
+static void BM_AnimationEvaluate(benchmark::State& state) {
+    auto batch = makeBatch(state.range(0));
+    auto frustum = makeFrustum();
+    float time = 0;
+    for(auto _ : state) {
+        time += 1 / 90.0f;
+        batch.evaluate(time, &frustum);
+        benchmark::DoNotOptimize(batch.getPose(0));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AnimationEvaluate)->Arg(100)->Arg(1000)->Arg(10000);
+
+// the same cubes one at a time through the reference, what per cube scripts would cost without the engine calls
+static void BM_AnimationScalar(benchmark::State& state) {
+    auto batch = makeBatch(state.range(0));
+    float time = 0;
+    for(auto _ : state) {
+        time += 1 / 90.0f;
+        for(int i = 0; i < batch.size(); i++)
+            benchmark::DoNotOptimize(animate(batch.getAnimation(i), batch.getBase(i), time));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_AnimationScalar)->Arg(100)->Arg(1000)->Arg(10000);
@@ -0,0 +1,39 @@
+#include "core/batching.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace Qubes;
+
+// freezing a whole layout, spread over a few colors
+static void BM_StaticBatchesFreeze(benchmark::State& state) {
+    std::vector<int> dirty;
+    for(auto _ : state) {
+        StaticBatches batches;
+        batches.setChunkLimit(64);
+        for(int i = 0; i < state.range(0); i++)
+            batches.add(colorKey({(i % 8) / 8.0f, 0.5, 1}));
+        batches.takeDirty(dirty);
+        benchmark::DoNotOptimize(dirty.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StaticBatchesFreeze)->Arg(100)->Arg(1000)->Arg(10000);
+
+// unlocking a cube and locking it again with another color, like one edit in the menu
+static void BM_StaticBatchesEdit(benchmark::State& state) {
+    StaticBatches batches;
+    batches.setChunkLimit(64);
+    std::vector<int> ids, dirty;
+    for(int i = 0; i < state.range(0); i++)
+        ids.push_back(batches.add(colorKey({(i % 8) / 8.0f, 0.5, 1})));
+    batches.takeDirty(dirty);
+    int i = 0;
+    for(auto _ : state) {
+        int& id = ids[i++ % ids.size()];
+        batches.remove(id);
+        id = batches.add(colorKey({(i % 8) / 8.0f, 0.5, 1}));
+        batches.takeDirty(dirty);
+        benchmark::DoNotOptimize(dirty.data());
+    }
+}
+BENCHMARK(BM_StaticBatchesEdit)->Arg(100)->Arg(1000)->Arg(10000);
@@ -0,0 +1,124 @@
+#include "common.hpp"
+#include "core/memory.hpp"
+#include "core/layouts.hpp"
+
+#include <cstdio>
+
+#include <benchmark/benchmark.h>
+
+using namespace Qubes;
+
+// parsing the config file and reading the cube array, what happens on boot
+static void BM_ConfigLoad(benchmark::State& state) {
+    std::string text = Bench::makeConfigText(state.range(0));
+    for(auto _ : state) {
+        Bench::MemoryStorage storage;
+        storage.doc.Parse(text.c_str());
+        QubesConfig config("qubes");
+        config.Init(&storage);
+        benchmark::DoNotOptimize(config.cubes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_ConfigLoad)->Arg(100)->Arg(1000)->Arg(10000);
+
+// rewriting the whole array, like SetValue
+static void BM_ConfigSave(benchmark::State& state) {
+    Bench::MemoryStorage storage;
+    QubesConfig config("qubes", Bench::makeLayout(state.range(0)));
+    config.Init(&storage);
+    for(auto _ : state) {
+        config.SetValue();
+        benchmark::DoNotOptimize(storage.buffer.GetSize());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConfigSave)->Arg(100)->Arg(1000)->Arg(10000);
+
+// a single cube edit, which currently writes the full file
+static void BM_ConfigSetCube(benchmark::State& state) {
+    Bench::MemoryStorage storage;
+    QubesConfig config("qubes", Bench::makeLayout(state.range(0)));
+    config.Init(&storage);
+    int i = 0;
+    for(auto _ : state) {
+        auto info = config.cubes[i];
+        info.size += 0.01;
+        config.SetCubeValue(i, info);
+        i = (i + 1) % config.cubes.size();
+    }
+}
+BENCHMARK(BM_ConfigSetCube)->Arg(100)->Arg(1000)->Arg(10000);
+
+// what the reload watcher does off the main thread after the file changed, one edit in every hundred cubes
+static void BM_ConfigReloadDiff(benchmark::State& state) {
+    auto live = Bench::makeLayout(state.range(0));
+    auto edited = live;
+    for(int i = 0; i < edited.size(); i += 100)
+        edited[i].color.r = 1 - edited[i].color.r;
+    edited.erase(edited.begin() + edited.size() / 2);
+    edited.push_back(live[0]);
+    for(auto _ : state) {
+        auto diff = diffLayouts(live, edited);
+        benchmark::DoNotOptimize(diff.source.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConfigReloadDiff)->Arg(100)->Arg(1000)->Arg(10000);
+
+// reading a named layout from its file, what the prefetch thread does during song selection
+static void BM_LayoutLoad(benchmark::State& state) {
+    std::string folder = "/tmp/qubes_bench_";
+    {
+        LayoutFile file(layoutPath(folder, "load"));
+        auto& doc = file.GetDocument();
+        doc.AddMember("qubes", rapidjson::Value(rapidjson::kArrayType), doc.GetAllocator());
+        for(auto& cube : Bench::makeLayout(state.range(0)))
+            doc["qubes"].PushBack(cube.ToJSON(doc.GetAllocator()), doc.GetAllocator());
+        file.Write();
+    }
+    for(auto _ : state) {
+        auto layout = loadLayout(folder, "load");
+        if(!layout.error.empty())
+            state.SkipWithError(layout.error.c_str());
+        benchmark::DoNotOptimize(layout.cubes.data());
+    }
+    remove(layoutPath(folder, "load").c_str());
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LayoutLoad)->Arg(100)->Arg(1000)->Arg(10000);
+
+// switching between two unrelated layouts, where nothing matches and every cube is paired up in order
+static void BM_LayoutSwitchDiff(benchmark::State& state) {
+    auto from = Bench::makeLayout(state.range(0));
+    auto to = Bench::makeLayout(state.range(0) + 1);
+    for(auto _ : state) {
+        auto diff = diffLayouts(from, to);
+        benchmark::DoNotOptimize(diff.source.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LayoutSwitchDiff)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_CubeInfoToJSON(benchmark::State& state) {
+    rapidjson::Document doc;
+    auto cubes = Bench::makeLayout(64);
+    int i = 0;
+    for(auto _ : state) {
+        auto v = cubes[i++ & 63].ToJSON(doc.GetAllocator());
+        benchmark::DoNotOptimize(v);
+    }
+}
+BENCHMARK(BM_CubeInfoToJSON);
+
+// walking the document for the memory estimate, done on every create when a limit is set
+static void BM_ConfigMemory(benchmark::State& state) {
+    Bench::MemoryStorage storage;
+    QubesConfig config("qubes", Bench::makeLayout(state.range(0)));
+    config.Init(&storage);
+    for(auto _ : state)
+        benchmark::DoNotOptimize(Memory::jsonBytes(storage.doc));
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ConfigMemory)->Arg(100)->Arg(1000)->Arg(10000);
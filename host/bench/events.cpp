@@ -0,0 +1,41 @@
+#include "core/events.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace Qubes;
+
+static void countCut(CutEvent const& event, void* context) {
+    *(int*) context += event.hitAction + 1;
+}
+
+// one cut delivered to many subscribers, each with its own context
+static void BM_CutDispatch(benchmark::State& state) {
+    CutBus bus;
+    std::vector<int> counts(state.range(0));
+    for(auto& count : counts)
+        bus.subscribe(countCut, &count);
+    CutEvent event = {};
+    for(auto _ : state) {
+        bus.dispatch(event);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CutDispatch)->Arg(1)->Arg(16)->Arg(256)->Arg(4096);
+
+// the edit menu's table, including ids no mod registered
+static void BM_HitActionRun(benchmark::State& state) {
+    HitActionTable table;
+    int count = 0;
+    table.addBuiltin(0, "None", nullptr);
+    for(int i = 1; i < 16; i++)
+        table.add("Action " + std::to_string(i), countCut, &count);
+    CutEvent event = {};
+    int i = 0;
+    for(auto _ : state) {
+        // table.id is -1 for the last few
+        table.run(table.id(i++ % 20), event);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_HitActionRun);
@@ -0,0 +1,102 @@
+#include "core/cut.hpp"
+#include "core/cubeindex.hpp"
+#include "core/stats.hpp"
+#include "core/allocations.hpp"
+#include "core/governor.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using namespace Qubes;
+
+static void BM_CutDirection(benchmark::State& state) {
+    Math::Random random(1);
+    std::vector<Math::Vec3> dirs;
+    for(int i = 0; i < 256; i++)
+        dirs.push_back(random.onUnitSphere());
+    int i = 0;
+    for(auto _ : state)
+        benchmark::DoNotOptimize(cutDirectionOk(dirs[i++ & 255]));
+}
+BENCHMARK(BM_CutDirection);
+
+// the debris mesh of a note has a few hundred vertices
+static void BM_DebrisCenter(benchmark::State& state) {
+    Math::Random random(2);
+    std::vector<Math::Vec3> vertices;
+    for(int i = 0; i < state.range(0); i++)
+        vertices.push_back(random.insideUnitSphere() * 0.25);
+    for(auto _ : state) {
+        auto plane = localCutPlane({0, 1, 0}, Math::euler(0, 30, 0), {0.1, 1.05, 0}, {0, 0.7, 0.7}, 0.2);
+        benchmark::DoNotOptimize(debrisCenter(vertices.data(), vertices.size(), plane));
+    }
+}
+BENCHMARK(BM_DebrisCenter)->Arg(96)->Arg(384);
+
+struct IndexedCube {
+    int index;
+};
+
+// deleting a cube near the start of the array, which renumbers everything after it
+static void BM_EraseIndexed(benchmark::State& state) {
+    std::vector<IndexedCube> storage(state.range(0));
+    for(auto _ : state) {
+        state.PauseTiming();
+        std::vector<IndexedCube*> cubes;
+        for(int i = 0; i < storage.size(); i++) {
+            storage[i].index = i;
+            cubes.push_back(&storage[i]);
+        }
+        state.ResumeTiming();
+        eraseIndexed(cubes, 1);
+        benchmark::DoNotOptimize(cubes.data());
+    }
+}
+BENCHMARK(BM_EraseIndexed)->Arg(1000)->Arg(10000);
+
+// what every timed hook pays while the overlay is shown
+static void BM_FrameTimer(benchmark::State& state) {
+    Stats::timing = state.range(0);
+    for(auto _ : state) {
+        FRAME_TIMER();
+        benchmark::ClobberMemory();
+    }
+    Stats::timing = false;
+}
+BENCHMARK(BM_FrameTimer)->Arg(0)->Arg(1);
+
+// one overlay refresh
+static void BM_FramePercentiles(benchmark::State& state) {
+    Math::Random random(1);
+    Stats::FrameTimes times;
+    for(int i = 0; i < 256; i++)
+        times.push(random.range(1e5, 2e6));
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(times.percentile(0.5));
+        benchmark::DoNotOptimize(times.percentile(0.99));
+    }
+}
+BENCHMARK(BM_FramePercentiles);
+
+// what a tracked allocation site adds on top of the allocation
+static void BM_TrackAlloc(benchmark::State& state) {
+    Allocations::enabled = state.range(0);
+    for(auto _ : state) {
+        TRACK_ALLOC("bench", 16);
+        benchmark::ClobberMemory();
+    }
+    Allocations::endFrame(UINT32_MAX);
+    Allocations::takeReport();
+    Allocations::enabled = false;
+}
+BENCHMARK(BM_TrackAlloc)->Arg(0)->Arg(1);
+
+// one frame of the quality governor, with a dropped frame every so often
+static void BM_GovernorUpdate(benchmark::State& state) {
+    Governor governor;
+    int i = 0;
+    for(auto _ : state)
+        benchmark::DoNotOptimize(governor.update((i++ % 16) ? 1 / 90.0f : 2 / 90.0f, 90));
+}
+BENCHMARK(BM_GovernorUpdate);
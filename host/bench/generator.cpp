@@ -0,0 +1,38 @@
+#include "common.hpp"
+#include "core/generator.hpp"
+#include "core/qubesconfig.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace Qubes;
+
+static void BM_Generate(benchmark::State& state) {
+    Generator generator;
+    generator.shape = (Shape) state.range(0);
+    generator.count = state.range(1);
+    for(auto _ : state) {
+        auto cubes = generator.generate();
+        benchmark::DoNotOptimize(cubes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * generator.count);
+    state.SetLabel(shapeName(generator.shape));
+}
+BENCHMARK(BM_Generate)->ArgsProduct({{0, 1, 2, 3}, {100, 1000, 5000, 10000}});
+
+// the config side of what the stress test's create step does, one write for all of them
+static void BM_GenerateAddCubes(benchmark::State& state) {
+    Generator generator;
+    generator.shape = Shape::Cloud;
+    generator.count = state.range(0);
+    auto cubes = generator.generate();
+    for(auto _ : state) {
+        state.PauseTiming();
+        Bench::MemoryStorage storage;
+        QubesConfig config("qubes");
+        config.Init(&storage);
+        state.ResumeTiming();
+        config.AddCubes(cubes);
+    }
+    state.SetItemsProcessed(state.iterations() * generator.count);
+}
+BENCHMARK(BM_GenerateAddCubes)->Arg(100)->Arg(1000)->Arg(5000)->Arg(10000);
@@ -0,0 +1,52 @@
+#include "common.hpp"
+#include "core/history.hpp"
+#include "core/qubesconfig.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace Qubes;
+
+// what recording adds to saving one moved cube
+static void BM_HistoryRecordMove(benchmark::State& state) {
+    Bench::MemoryStorage storage;
+    QubesConfig config("qubes", Bench::makeLayout(1000));
+    config.Init(&storage);
+    History history;
+    if(state.range(0))
+        config.history = &history;
+    int i = 0;
+    for(auto _ : state) {
+        auto info = config.cubes[i];
+        info.pos.x += 0.01;
+        config.SetCubeValue(i, info);
+        // a different cube each time, so nothing is merged
+        i = (i + 7) % config.cubes.size();
+    }
+    state.counters["history"] = history.memory();
+}
+BENCHMARK(BM_HistoryRecordMove)->Arg(0)->Arg(1);
+
+// undoing a recolor of a fifth of the layout, only those cubes are written
+static void BM_HistoryUndoBulk(benchmark::State& state) {
+    Bench::MemoryStorage storage;
+    QubesConfig config("qubes", Bench::makeLayout(state.range(0)));
+    config.Init(&storage);
+    std::vector<int> indices;
+    std::vector<CubeInfo> before, after;
+    for(int i = 0; i < state.range(0); i += 5) {
+        indices.push_back(i);
+        before.push_back(config.cubes[i]);
+        after.push_back(config.cubes[i]);
+        after.back().color.r = 1 - after.back().color.r;
+    }
+    auto op = setOp(indices, before, after);
+    size_t opBytes = op.bytes();
+    for(auto _ : state) {
+        auto inverse = invertOp(op, config.cubes);
+        config.SetCubeValues(op.indices, opValues(op, config.cubes));
+        op = std::move(inverse);
+    }
+    state.SetItemsProcessed(state.iterations() * indices.size());
+    state.counters["opBytes"] = opBytes;
+}
+BENCHMARK(BM_HistoryUndoBulk)->Arg(1000)->Arg(10000);
@@ -0,0 +1,59 @@
+#include "core/layoutindex.hpp"
+#include "core/snapshot.hpp"
+#include "common.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace Qubes;
+
+// the bench layout with every hit action and some locked cubes
+static void publishLayout(SnapshotPublisher& publisher, int count) {
+    auto cubes = Bench::makeLayout(count);
+    for(int i = 0; i < count; i++) {
+        cubes[i].hitAction = i % 5;
+        cubes[i].locked = i % 7 == 0;
+    }
+    publisher.publish(cubes);
+}
+
+static void BM_LayoutIndexBuild(benchmark::State& state) {
+    SnapshotPublisher publisher;
+    publishLayout(publisher, state.range(0));
+    auto snapshot = publisher.acquire();
+    for(auto _ : state) {
+        // a new index every time, building the same version again is skipped
+        LayoutIndex index;
+        index.build(*snapshot);
+        benchmark::DoNotOptimize(index.size());
+    }
+    SnapshotPublisher::release(snapshot);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LayoutIndexBuild)->Arg(100)->Arg(1000)->Arg(10000);
+
+// what changing one of the browser's filters costs, 0: everything, 1: locked arrows, 2: a hue range near the player
+static void BM_LayoutQuery(benchmark::State& state) {
+    SnapshotPublisher publisher;
+    publishLayout(publisher, 10000);
+    auto snapshot = publisher.acquire();
+    LayoutIndex index;
+    index.build(*snapshot);
+    SnapshotPublisher::release(snapshot);
+
+    LayoutFilter filter;
+    if(state.range(0) == 1) {
+        filter.type = 2;
+        filter.locked = 1;
+    } else if(state.range(0) == 2) {
+        filter.hueMin = 330;
+        filter.hueMax = 30;
+        filter.maxDistance = 5;
+    }
+    std::vector<int> results;
+    for(auto _ : state) {
+        index.query(filter, results);
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.counters["results"] = results.size();
+}
+BENCHMARK(BM_LayoutQuery)->Arg(0)->Arg(1)->Arg(2);
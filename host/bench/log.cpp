@@ -0,0 +1,37 @@
+#include "core/ringbuffer.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+
+using namespace Qubes;
+
+struct Entry {
+    int level;
+    char message[252];
+};
+
+// what a log call costs the main thread: formatting into a free slot
+static void BM_LogPush(benchmark::State& state) {
+    static RingBuffer<Entry, 256> queue;
+    int i = 0;
+    for(auto _ : state) {
+        queue.tryPush([&i](Entry& entry) {
+            entry.level = 1;
+            snprintf(entry.message, sizeof(entry.message), "Qube cut %i", i++);
+        });
+        queue.tryPop([](Entry& entry) { benchmark::DoNotOptimize(entry.message[0]); });
+    }
+}
+BENCHMARK(BM_LogPush);
+
+// producers on several threads with one consumer draining
+static void BM_LogContended(benchmark::State& state) {
+    static RingBuffer<Entry, 256> queue;
+    for(auto _ : state) {
+        queue.tryPush([](Entry& entry) { entry.level = 1; entry.message[0] = 0; });
+        if(state.thread_index() == 0)
+            while(queue.tryPop([](Entry& entry) { benchmark::DoNotOptimize(entry.level); }));
+    }
+}
+BENCHMARK(BM_LogContended)->Threads(1)->Threads(4);
@@ -0,0 +1,57 @@
+#include "core/math.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace Qubes;
+
+// the per frame grab update in Cube::LateUpdate
+static void BM_GrabFollow(benchmark::State& state) {
+    Math::Vec3 pos = {0, 1, 0}, target = {1, 1.5, 2};
+    Math::Quat rot = Math::Quat::identity(), ctrlRot = Math::euler(10, 45, 5);
+    Math::Quat grabRot = Math::euler(0, 30, 0);
+    for(auto _ : state) {
+        auto extraRot = Math::euler(0, 0.1, 0) * Math::euler(0.2, 0, 0);
+        grabRot = grabRot * extraRot;
+        pos = Math::lerp(pos, target, 10 * 0.0111f);
+        rot = Math::slerp(rot, ctrlRot * grabRot, 5 * 0.0111f);
+        benchmark::DoNotOptimize(pos);
+        benchmark::DoNotOptimize(rot);
+    }
+}
+BENCHMARK(BM_GrabFollow);
+
+static void BM_QuatMultiply(benchmark::State& state) {
+    Math::Quat a = Math::euler(10, 20, 30), b = Math::euler(-5, 60, 2);
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(a);
+        benchmark::DoNotOptimize(a * b);
+    }
+}
+BENCHMARK(BM_QuatMultiply);
+
+static void BM_Slerp(benchmark::State& state) {
+    Math::Quat a = Math::euler(10, 20, 30), b = Math::euler(-5, 60, 2);
+    float t = 0;
+    for(auto _ : state) {
+        t = t > 1 ? 0 : t + 0.001f;
+        benchmark::DoNotOptimize(Math::slerp(a, b, t));
+    }
+}
+BENCHMARK(BM_Slerp);
+
+// EditMenu::LateUpdate
+static void BM_MenuOffset(benchmark::State& state) {
+    float y = 0;
+    for(auto _ : state) {
+        y += 0.5f;
+        benchmark::DoNotOptimize(Math::angleAxis(y, Math::Vec3::up()) * Math::Vec3{1.5, 0, 0});
+    }
+}
+BENCHMARK(BM_MenuOffset);
+
+static void BM_OnUnitSphere(benchmark::State& state) {
+    Math::Random random(1);
+    for(auto _ : state)
+        benchmark::DoNotOptimize(random.onUnitSphere());
+}
+BENCHMARK(BM_OnUnitSphere);
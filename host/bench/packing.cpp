@@ -0,0 +1,37 @@
+#include "common.hpp"
+#include "core/packing.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace Qubes;
+
+// a packed file to the loaded cubes, compare with BM_ConfigLoad for the same cubes as json
+static void BM_PackedLoad(benchmark::State& state) {
+    Bench::MemoryStorage source;
+    source.doc.Parse(Bench::makeConfigText(state.range(0)).c_str());
+    auto data = Packing::packDocument(source.doc);
+    for(auto _ : state) {
+        Bench::MemoryStorage storage;
+        Packing::unpackDocument(data.data(), data.size(), storage.doc);
+        QubesConfig config("qubes");
+        config.Init(&storage);
+        benchmark::DoNotOptimize(config.cubes.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_PackedLoad)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_PackedSave(benchmark::State& state) {
+    Bench::MemoryStorage storage;
+    storage.doc.Parse(Bench::makeConfigText(state.range(0)).c_str());
+    size_t size = 0;
+    for(auto _ : state) {
+        auto data = Packing::packDocument(storage.doc);
+        size = data.size();
+        benchmark::DoNotOptimize(data.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["bytes"] = size;
+}
+BENCHMARK(BM_PackedSave)->Arg(100)->Arg(1000)->Arg(10000);
@@ -0,0 +1,42 @@
+#include "core/physics.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace Qubes;
+
+static PhysicsBatch makeBatch(int count, float speed) {
+    PhysicsBatch batch;
+    Math::Random random;
+    for(int i = 0; i < count; i++) {
+        Pose pose = {random.insideUnitSphere() * 10 + Math::Vec3{0, 11, 0}, Math::euler(0, random.range(0, 360), 0)};
+        batch.add(pose, random.onUnitSphere() * speed, random.onUnitSphere() * speed, 0.25);
+    }
+    return batch;
+}
+
+// one frame of cubes in flight, with gravity so some of them hit the floor
+static void BM_PhysicsStep(benchmark::State& state) {
+    auto batch = makeBatch(state.range(0), 5);
+    PhysicsSettings settings;
+    settings.gravity = 9.81;
+    // rested cubes aren't removed, so the count stays the same
+    std::vector<int> rested;
+    for(auto _ : state) {
+        batch.step(1 / 90.0f, settings, rested);
+        benchmark::DoNotOptimize(batch.getPose(0));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PhysicsStep)->Arg(100)->Arg(1000)->Arg(10000);
+
+// velocity from a full tracker, done once per release
+static void BM_ThrowVelocity(benchmark::State& state) {
+    ThrowTracker tracker;
+    for(int i = 0; i < 10; i++)
+        tracker.push({{i * 0.01f, 0, 0}, Math::euler(0, i * 2.0f, 0)}, 1 / 90.0f);
+    for(auto _ : state) {
+        benchmark::DoNotOptimize(tracker.velocity());
+        benchmark::DoNotOptimize(tracker.angularVelocity());
+    }
+}
+BENCHMARK(BM_ThrowVelocity);
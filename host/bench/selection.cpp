@@ -0,0 +1,82 @@
+#include "common.hpp"
+#include "core/selection.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace Qubes;
+
+// recoloring a fifth of the layout through the selection, with one write for all of them
+static void BM_BulkEdit(benchmark::State& state) {
+    Bench::MemoryStorage storage;
+    QubesConfig config("qubes", Bench::makeLayout(state.range(0)));
+    config.Init(&storage);
+    Selection selection;
+    for(int i = 0; i < state.range(0); i += 5)
+        selection.set(i);
+    std::vector<int> selected;
+    std::vector<CubeInfo> values;
+    BulkEdit edit;
+    edit.fields = BulkEdit::Color;
+    for(auto _ : state) {
+        edit.color.r = 1 - edit.color.r;
+        selection.indices(selected);
+        values.clear();
+        for(int i : selected) {
+            values.push_back(config.cubes[i]);
+            edit.apply(values.back());
+        }
+        config.SetCubeValues(selected, values);
+    }
+    state.SetItemsProcessed(state.iterations() * selection.count());
+}
+BENCHMARK(BM_BulkEdit)->Arg(100)->Arg(1000)->Arg(10000);
+
+// the same edit made one cube at a time, like through each cube's own menu
+static void BM_BulkEditPerCube(benchmark::State& state) {
+    Bench::MemoryStorage storage;
+    QubesConfig config("qubes", Bench::makeLayout(state.range(0)));
+    config.Init(&storage);
+    int count = 0;
+    for(auto _ : state) {
+        count = 0;
+        for(int i = 0; i < state.range(0); i += 5, count++) {
+            auto info = config.cubes[i];
+            info.color.r = 1 - info.color.r;
+            config.SetCubeValue(i, info);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_BulkEditPerCube)->Arg(100)->Arg(1000);
+
+static void BM_SelectBox(benchmark::State& state) {
+    auto cubes = Bench::makeLayout(state.range(0));
+    Selection selection;
+    std::vector<int> selected;
+    for(auto _ : state) {
+        selection.clear();
+        selectBox(cubes, {-5, 0, -5}, {5, 2, 5}, 0.25, selection);
+        selection.indices(selected);
+        benchmark::DoNotOptimize(selected.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SelectBox)->Arg(1000)->Arg(10000);
+
+// deleting the selection, one pass over the arrays instead of one erase per cube
+static void BM_RemoveCubes(benchmark::State& state) {
+    auto layout = Bench::makeLayout(state.range(0));
+    std::vector<int> removed;
+    for(int i = 0; i < state.range(0); i += 5)
+        removed.push_back(i);
+    for(auto _ : state) {
+        state.PauseTiming();
+        Bench::MemoryStorage storage;
+        QubesConfig config("qubes", layout);
+        config.Init(&storage);
+        state.ResumeTiming();
+        config.RemoveCubes(removed);
+    }
+    state.SetItemsProcessed(state.iterations() * removed.size());
+}
+BENCHMARK(BM_RemoveCubes)->Arg(1000)->Arg(10000);
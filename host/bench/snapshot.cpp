@@ -0,0 +1,66 @@
+#include "core/snapshot.hpp"
+#include "common.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace Qubes;
+
+// publishing copies every cube, done after each saved change
+static void BM_SnapshotPublish(benchmark::State& state) {
+    SnapshotPublisher publisher;
+    auto cubes = Bench::makeLayout(state.range(0));
+    for(auto _ : state)
+        publisher.publish(cubes);
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SnapshotPublish)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_SnapshotAcquire(benchmark::State& state) {
+    SnapshotPublisher publisher;
+    publisher.publish(Bench::makeLayout(100));
+    for(auto _ : state) {
+        auto snapshot = publisher.acquire();
+        benchmark::DoNotOptimize(snapshot->cubes);
+        SnapshotPublisher::release(snapshot);
+    }
+}
+BENCHMARK(BM_SnapshotAcquire);
+
+// shared by the threads of the stress benchmark, the first one writes and the rest read
+static SnapshotPublisher stressPublisher;
+
+// a writer publishing as fast as it can while readers check that every snapshot they hold stays whole,
+// each snapshot has every cube at x = its version, so a torn or freed one shows up as a mismatch
+// the publisher carries over between sizes, so readers may see some of the last size's snapshots first
+static void BM_SnapshotStress(benchmark::State& state) {
+    int count = state.range(0);
+    if(state.thread_index() == 0) {
+        auto cubes = Bench::makeLayout(count);
+        float version = stressPublisher.acquire()->version;
+        for(auto _ : state) {
+            version++;
+            for(auto& cube : cubes)
+                cube.pos.x = version;
+            stressPublisher.publish(cubes);
+        }
+        state.counters["retired"] = stressPublisher.retiredCount();
+        state.SetLabel("writer");
+        return;
+    }
+    int64_t checked = 0;
+    for(auto _ : state) {
+        auto snapshot = stressPublisher.acquire();
+        float expected = snapshot->version;
+        bool whole = true;
+        for(int i = 0; i < snapshot->count; i++)
+            whole &= snapshot->cubes[i].pos[0] == expected;
+        checked += snapshot->count;
+        SnapshotPublisher::release(snapshot);
+        if(!whole) {
+            state.SkipWithError("snapshot changed while it was held");
+            break;
+        }
+    }
+    state.SetItemsProcessed(checked);
+}
+BENCHMARK(BM_SnapshotStress)->Arg(100)->Arg(1000)->Threads(2)->Threads(4)->Threads(8)->UseRealTime();
@@ -0,0 +1,77 @@
+#include "core/sweep.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using namespace Qubes;
+
+// cubes spread around the player like a big layout
+static std::vector<OBB> makeBoxes(int count) {
+    Math::Random random(count);
+    std::vector<OBB> boxes;
+    boxes.reserve(count);
+    for(int i = 0; i < count; i++) {
+        float half = random.range(0.1, 0.3);
+        boxes.push_back({{random.range(-10, 10), random.range(0, 3), random.range(-10, 10)}, Math::euler(random.range(0, 360), random.range(0, 360), 0), {half, half, half}});
+    }
+    return boxes;
+}
+
+// a fast swing in front of the player
+static BladeSweep makeSwing(Math::Random& random) {
+    Math::Vec3 hand = {random.range(-0.5, 0.5), random.range(0.8, 1.6), random.range(0, 0.5)};
+    Math::Vec3 dir = Math::normalized(Math::Vec3{0, 0.3, 1} + random.insideUnitSphere() * 0.5);
+    Math::Vec3 move = random.onUnitSphere() * 0.3;
+    return {hand, hand + dir, hand + move, hand + move + dir};
+}
+
+static void BM_SweepBuild(benchmark::State& state) {
+    auto boxes = makeBoxes(state.range(0));
+    SweepBVH bvh;
+    for(auto _ : state) {
+        bvh.build(boxes);
+        benchmark::DoNotOptimize(bvh.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SweepBuild)->Arg(100)->Arg(1000)->Arg(10000);
+
+// one saber for one frame
+static void BM_SweepQuery(benchmark::State& state) {
+    SweepBVH bvh;
+    bvh.build(makeBoxes(state.range(0)));
+    Math::Random random(1);
+    std::vector<BladeSweep> swings;
+    for(int i = 0; i < 256; i++)
+        swings.push_back(makeSwing(random));
+    std::vector<SweepHit> hits;
+    int i = 0;
+    for(auto _ : state) {
+        hits.clear();
+        bvh.sweep(swings[i++ & 255], hits);
+        benchmark::DoNotOptimize(hits.data());
+    }
+}
+BENCHMARK(BM_SweepQuery)->Arg(100)->Arg(1000)->Arg(10000);
+
+// a frame with a fraction of the layout animated, range(1) in percent, against rebuilding it all
+static void BM_SweepRefit(benchmark::State& state) {
+    auto boxes = makeBoxes(state.range(0));
+    SweepBVH bvh;
+    bvh.build(boxes);
+    int moving = boxes.size() * state.range(1) / 100;
+    float time = 0;
+    for(auto _ : state) {
+        time += 0.011f;
+        for(int i = 0; i < moving; i++) {
+            auto box = boxes[i];
+            box.center.y += std::sin(time + i) * 0.2f;
+            bvh.update(i, box);
+        }
+        bvh.refit();
+        benchmark::DoNotOptimize(bvh.size());
+    }
+    state.SetItemsProcessed(state.iterations() * moving);
+}
+BENCHMARK(BM_SweepRefit)->ArgsProduct({{1000, 10000}, {1, 10, 100}});
@@ -0,0 +1,26 @@
+#include "core/trace.hpp"
+
+#include <benchmark/benchmark.h>
+
+using namespace Qubes;
+
+// what a zone costs when tracing is off
+static void BM_TraceZoneDisabled(benchmark::State& state) {
+    Trace::stop();
+    for(auto _ : state) {
+        TRACE_ZONE("disabled");
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_TraceZoneDisabled);
+
+// two clock reads and a ring buffer push, with the writer draining to nowhere
+static void BM_TraceZoneEnabled(benchmark::State& state) {
+    Trace::start("/dev/null");
+    for(auto _ : state) {
+        TRACE_ZONE("enabled");
+        benchmark::ClobberMemory();
+    }
+    Trace::stop();
+}
+BENCHMARK(BM_TraceZoneEnabled);
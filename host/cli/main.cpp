@@ -0,0 +1,315 @@
+// checks, converts and summarizes config and layout files, reading and writing them through the same code as the mod
+// usage: qubes-cli <command> ...
+//   validate <file>              checks every cube array, after moving cubes out of the old "cubes" array
+//   convert <in> <out>           json or packed in, packed out unless out ends in .json
+//   merge <out> <in> <in>...     arrays with the same name are appended in order, everything else comes from the first
+//   split <in> <folder>          one layout file per cube array, named after it
+//   generate <out> [--shape grid|sphere|spiral|cloud] [--count N] [--seed S] [--spacing M] [--array NAME]
+//   stats <file>                 cubes per array, their bounds, and how long loading and saving take
+
+#include "core/generator.hpp"
+#include "core/layouts.hpp"
+#include "core/packing.hpp"
+#include "core/qubesconfig.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+
+using namespace Qubes;
+
+using Clock = std::chrono::steady_clock;
+
+static double millisSince(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static long fileSize(std::string const& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if(!file)
+        return -1;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+// array members, which are where configs and layouts keep cubes, in the document's order
+static std::vector<std::string> cubeArrays(rapidjson::Document& doc) {
+    std::vector<std::string> names;
+    for(auto member = doc.MemberBegin(); member != doc.MemberEnd(); ++member) {
+        if(member->value.IsArray())
+            names.emplace_back(member->name.GetString(), member->name.GetStringLength());
+    }
+    return names;
+}
+
+// reads like the mod does, migrating old configs, and prints every cube that the mod would refuse
+static bool load(LayoutFile& file, bool* migrated = nullptr) {
+    std::string error;
+    if(!file.Read(&error)) {
+        fprintf(stderr, "%s: %s\n", file.getPath().c_str(), error.c_str());
+        return false;
+    }
+    auto& doc = file.GetDocument();
+    bool moved = migrateDocument(doc);
+    if(migrated)
+        *migrated = moved;
+    bool valid = true;
+    for(auto& name : cubeArrays(doc)) {
+        auto cubes = doc[name].GetArray();
+        for(int i = 0; i < cubes.Size(); i++) {
+            if(!validCube(cubes[i], &error)) {
+                fprintf(stderr, "%s: %s[%i]: %s\n", file.getPath().c_str(), name.c_str(), i, error.c_str());
+                valid = false;
+            }
+        }
+    }
+    return valid;
+}
+
+// json through LayoutFile::Write like the mod's layouts, otherwise packed
+static bool save(std::string const& path, rapidjson::Document& doc) {
+    if(path.ends_with(".json")) {
+        LayoutFile file(path);
+        file.GetDocument().Swap(doc);
+        file.Write();
+        file.GetDocument().Swap(doc);
+        return fileSize(path) >= 0;
+    }
+    auto data = Packing::packDocument(doc);
+    FILE* file = fopen(path.c_str(), "wb");
+    if(!file)
+        return false;
+    bool ok = fwrite(data.data(), 1, data.size(), file) == data.size();
+    ok &= fclose(file) == 0;
+    return ok;
+}
+
+#pragma region commands
+static int validate(std::string const& path) {
+    LayoutFile file(path);
+    bool migrated;
+    bool valid = load(file, &migrated);
+    if(migrated)
+        printf("migrated the old cubes array\n");
+    for(auto& name : cubeArrays(file.GetDocument()))
+        printf("%s: %i qubes\n", name.c_str(), (int) file.GetDocument()[name].Size());
+    printf(valid ? "valid\n" : "invalid\n");
+    return valid ? 0 : 1;
+}
+
+static int convert(std::string const& in, std::string const& out) {
+    LayoutFile file(in);
+    if(!load(file))
+        return 1;
+    if(!save(out, file.GetDocument())) {
+        fprintf(stderr, "Could not write %s\n", out.c_str());
+        return 1;
+    }
+    printf("%s (%li bytes) -> %s (%li bytes)\n", in.c_str(), fileSize(in), out.c_str(), fileSize(out));
+    return 0;
+}
+
+static int merge(std::string const& out, std::vector<std::string> const& ins) {
+    // values are moved between documents, so each one's allocator has to live until the result is written
+    std::vector<std::unique_ptr<LayoutFile>> files;
+    for(auto& in : ins) {
+        files.push_back(std::make_unique<LayoutFile>(in));
+        if(!load(*files.back()))
+            return 1;
+    }
+    auto& merged = files[0]->GetDocument();
+    auto& allocator = merged.GetAllocator();
+    for(int i = 1; i < files.size(); i++) {
+        auto& doc = files[i]->GetDocument();
+        for(auto& name : cubeArrays(doc)) {
+            if(!merged.HasMember(name)) {
+                merged.AddMember(rapidjson::Value(name, allocator).Move(), rapidjson::Value(rapidjson::kArrayType), allocator);
+            }
+            auto target = merged[name].GetArray();
+            for(auto& cube : doc[name].GetArray())
+                target.PushBack(cube, allocator);
+        }
+    }
+    if(!save(out, merged)) {
+        fprintf(stderr, "Could not write %s\n", out.c_str());
+        return 1;
+    }
+    for(auto& name : cubeArrays(merged))
+        printf("%s: %i qubes\n", name.c_str(), (int) merged[name].Size());
+    return 0;
+}
+
+static int split(std::string const& in, std::string folder) {
+    LayoutFile file(in);
+    if(!load(file))
+        return 1;
+    if(!folder.ends_with("/"))
+        folder += "/";
+    auto& doc = file.GetDocument();
+    for(auto& name : cubeArrays(doc)) {
+        // names become file names, the same rules as the mod's layouts keep them safe
+        if(!validLayoutName(name)) {
+            fprintf(stderr, "Skipping %s, it can't be a file name\n", name.c_str());
+            continue;
+        }
+        LayoutFile part(layoutPath(folder, name));
+        auto& partDoc = part.GetDocument();
+        partDoc.AddMember(rapidjson::Value(name, partDoc.GetAllocator()).Move(), doc[name], partDoc.GetAllocator());
+        part.Write();
+        if(fileSize(part.getPath()) < 0) {
+            fprintf(stderr, "Could not write %s\n", part.getPath().c_str());
+            return 1;
+        }
+        printf("%s: %i qubes\n", part.getPath().c_str(), (int) partDoc[name].Size());
+    }
+    return 0;
+}
+
+static int generate(std::string const& out, int argc, char** argv) {
+    Generator generator;
+    // the mod's own default cube
+    generator.base = CubeInfo({}, {}, {0.5, 0.5, 0.5, 1}, 2, 0, 1, false);
+    std::string array = "qubes";
+    for(int i = 0; i < argc; i++) {
+        if(!strcmp(argv[i], "--shape") && i + 1 < argc) {
+            i++;
+            generator.shape = Shape::Count;
+            for(int shape = 0; shape < (int) Shape::Count; shape++) {
+                if(!strcasecmp(argv[i], shapeName((Shape) shape)))
+                    generator.shape = (Shape) shape;
+            }
+            if(generator.shape == Shape::Count) {
+                fprintf(stderr, "Unknown shape %s\n", argv[i]);
+                return 1;
+            }
+        } else if(!strcmp(argv[i], "--count") && i + 1 < argc)
+            generator.count = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--seed") && i + 1 < argc)
+            generator.seed = strtoul(argv[++i], nullptr, 10);
+        else if(!strcmp(argv[i], "--spacing") && i + 1 < argc)
+            generator.spacing = atof(argv[++i]);
+        else if(!strcmp(argv[i], "--array") && i + 1 < argc)
+            array = argv[++i];
+        else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 1;
+        }
+    }
+    auto start = Clock::now();
+    auto cubes = generator.generate();
+    double generateMs = millisSince(start);
+    // through QubesConfig, so the file is what the mod would have saved
+    LayoutFile file(out);
+    QubesConfig config(array, cubes);
+    start = Clock::now();
+    config.Init(&file);
+    double initMs = millisSince(start);
+    if(!out.ends_with(".json") && !save(out, file.GetDocument())) {
+        fprintf(stderr, "Could not write %s\n", out.c_str());
+        return 1;
+    }
+    printf("%i qubes in a %s, generated in %.2f ms, saved in %.2f ms\n", (int) cubes.size(), shapeName(generator.shape), generateMs, initMs);
+    return 0;
+}
+
+static int stats(std::string const& path) {
+    LayoutFile file(path);
+    auto start = Clock::now();
+    bool valid = load(file);
+    double readMs = millisSince(start);
+    if(!valid)
+        return 1;
+    auto& doc = file.GetDocument();
+    printf("%s: %li bytes, read and checked in %.2f ms\n", path.c_str(), fileSize(path), readMs);
+
+    // the mod's load, each array into CubeInfo through QubesConfig
+    auto names = cubeArrays(doc);
+    std::vector<QubesConfig> configs;
+    configs.reserve(names.size());
+    start = Clock::now();
+    for(auto& name : names) {
+        configs.emplace_back(name);
+        configs.back().Init(&file);
+    }
+    double loadMs = millisSince(start);
+    int total = 0;
+    for(auto& config : configs) {
+        auto& cubes = config.cubes;
+        total += cubes.size();
+        Math::Vec3 min = cubes.empty() ? Math::Vec3() : cubes[0].pos, max = min;
+        int locked = 0, animated = 0;
+        std::map<int, int> types, actions;
+        for(auto& cube : cubes) {
+            min = {std::min(min.x, cube.pos.x), std::min(min.y, cube.pos.y), std::min(min.z, cube.pos.z)};
+            max = {std::max(max.x, cube.pos.x), std::max(max.y, cube.pos.y), std::max(max.z, cube.pos.z)};
+            locked += cube.locked;
+            animated += cube.animation.moves();
+            types[cube.type]++;
+            actions[cube.hitAction]++;
+        }
+        printf("%s: %i qubes, %i locked, %i animated\n", config.name.c_str(), (int) cubes.size(), locked, animated);
+        if(cubes.empty())
+            continue;
+        printf("  bounds (%.2f, %.2f, %.2f) to (%.2f, %.2f, %.2f)\n", min.x, min.y, min.z, max.x, max.y, max.z);
+        printf("  types:");
+        for(auto [type, count] : types)
+            printf(" %i x%i", type, count);
+        printf("\n  hit actions:");
+        for(auto [action, count] : actions)
+            printf(" %i x%i", action, count);
+        printf("\n");
+    }
+    printf("%i qubes loaded in %.2f ms\n", total, loadMs);
+
+    // saving to the side, so the file itself isn't touched
+    std::string temp = path + ".stats.json";
+    start = Clock::now();
+    save(temp, doc);
+    double saveMs = millisSince(start);
+    remove(temp.c_str());
+    start = Clock::now();
+    auto packed = Packing::packDocument(doc);
+    double packMs = millisSince(start);
+    rapidjson::Document unpacked;
+    start = Clock::now();
+    Packing::unpackDocument(packed.data(), packed.size(), unpacked);
+    double unpackMs = millisSince(start);
+    printf("json saved in %.2f ms, packed to %zu bytes in %.2f ms, unpacked in %.2f ms\n", saveMs, packed.size(), packMs, unpackMs);
+    return 0;
+}
+#pragma endregion
+
+static int usage() {
+    fprintf(stderr,
+        "usage: qubes-cli <command> ...\n"
+        "  validate <file>\n"
+        "  convert <in> <out>\n"
+        "  merge <out> <in> <in>...\n"
+        "  split <in> <folder>\n"
+        "  generate <out> [--shape grid|sphere|spiral|cloud] [--count N] [--seed S] [--spacing M] [--array NAME]\n"
+        "  stats <file>\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    if(argc < 3)
+        return usage();
+    std::string command = argv[1];
+    if(command == "validate" && argc == 3)
+        return validate(argv[2]);
+    if(command == "convert" && argc == 4)
+        return convert(argv[2], argv[3]);
+    if(command == "merge" && argc >= 5)
+        return merge(argv[2], std::vector<std::string>(argv + 3, argv + argc));
+    if(command == "split" && argc == 4)
+        return split(argv[2], argv[3]);
+    if(command == "generate")
+        return generate(argv[2], argc - 3, argv + 3);
+    if(command == "stats" && argc == 3)
+        return stats(argv[2]);
+    return usage();
+}
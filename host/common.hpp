@@ -0,0 +1,47 @@
+#pragma once
+
+#include "core/qubesconfig.hpp"
+
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+#include <string>
+
+namespace Bench {
+    // keeps the document in memory, writing serializes it like the config file would be
+    class MemoryStorage : public Qubes::ConfigStorage {
+        public:
+        rapidjson::Document doc;
+        rapidjson::StringBuffer buffer;
+
+        MemoryStorage() { doc.SetObject(); }
+        rapidjson::Document& GetDocument() override { return doc; }
+        void Write() override {
+            buffer.Clear();
+            rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+            doc.Accept(writer);
+        }
+    };
+
+    // deterministic layout of count cubes in a grid
+    inline std::vector<Qubes::CubeInfo> makeLayout(int count) {
+        std::vector<Qubes::CubeInfo> cubes;
+        cubes.reserve(count);
+        Qubes::Math::Random random(count);
+        for(int i = 0; i < count; i++) {
+            Qubes::Math::Vec3 pos = {(float) (i % 20) - 10, (float) (i / 400), (float) ((i / 20) % 20) - 10};
+            Qubes::Math::Quat rot = Qubes::Math::euler(0, random.range(0, 360), 0);
+            Qubes::Math::Color color = {random.value(), random.value(), random.value(), 1};
+            cubes.emplace_back(pos, rot, color, i % 3, 0, 1, false);
+        }
+        return cubes;
+    }
+
+    // the json text of a config file with one "qubes" array of count cubes
+    inline std::string makeConfigText(int count) {
+        MemoryStorage storage;
+        Qubes::QubesConfig config("qubes", makeLayout(count));
+        config.Init(&storage);
+        return storage.buffer.GetString();
+    }
+}
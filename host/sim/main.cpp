@@ -0,0 +1,260 @@
+// replays recorded controller input against the mod's per frame logic on mock objects, and reports frame times
+// usage: qubes-sim [--cubes N] [--frames N] [--direct] [--smoothing S] [--write out.qrec] [recording.qrec]
+// without a recording, a synthetic one is generated so runs stay reproducible
+
+#include "common.hpp"
+#include "sim/mock.hpp"
+
+#include "core/cubeindex.hpp"
+#include "core/trace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+using namespace Sim;
+
+// default bindings from the mod config: 0 side trigger, 1 lower button, 2 top button
+constexpr int BtnMake = 0, BtnEdit = 2, BtnDel = 1;
+constexpr GrabSettings settings = {1, 1, false};
+
+std::vector<InputFrame> syntheticInput(int frames) {
+    std::vector<InputFrame> input;
+    input.reserve(frames);
+    for(int i = 0; i < frames; i++) {
+        float time = i / 90.0f;
+        InputFrame frame = {};
+        frame.deltaTime = 1 / 90.0f;
+        // sweep across the layout, which sits in front of and around the player
+        frame.pos = {0.2, 1.2, 0};
+        frame.rot = Math::euler(10 * std::sin(time * 0.7f), 120 * std::sin(time * 0.25f), 0);
+        // hold the trigger for a second every four, moving the cube around while held
+        bool holding = std::fmod(time, 4) < 1;
+        frame.trigger = holding ? 1 : 0;
+        frame.vertical = holding ? std::sin(time * 3) : 0;
+        frame.horizontal = holding ? std::cos(time * 2) * 0.5f : 0;
+        frame.lastUsedRight = 1;
+        // create every seven seconds, delete every eleven, open a menu every five
+        if(std::fmod(time, 7) < 0.05f)
+            frame.setHeld(BtnMake, true);
+        if(std::fmod(time, 11) < 0.05f)
+            frame.setHeld(BtnDel, true);
+        if(std::fmod(time, 5) < 0.05f)
+            frame.setHeld(BtnEdit, true);
+        input.push_back(frame);
+    }
+    return input;
+}
+
+struct Simulation {
+    Bench::MemoryStorage storage;
+    QubesConfig config = QubesConfig("qubes");
+    std::vector<std::unique_ptr<MockCube>> owned;
+    std::vector<MockCube*> cubes;
+    MockPointer pointer;
+    // the mod's Direct Grab setting, which poses held cubes right before rendering
+    bool directGrab = false;
+    float grabSmoothing = 0;
+    GrabLatency latency;
+    double latencyTotal = 0;
+    int latencyFrames = 0;
+    // when the controller pose was last read
+    uint64_t sampled = 0;
+    // direct grabs, moved in beforeRender
+    std::vector<MockCube*> held;
+    // poses applied this frame, with their targets
+    std::vector<std::pair<Math::Vec3, Math::Vec3>> pending;
+
+    MockCube* makeCube(CubeInfo const& info, int index) {
+        auto cube = std::make_unique<MockCube>();
+        cube->index = index;
+        cube->info = info;
+        cube->transform = {{info.pos, info.rot}, info.size};
+        cubes.push_back(cube.get());
+        owned.push_back(std::move(cube));
+        return cubes.back();
+    }
+
+    void init(int count) {
+        config.defCubes = Bench::makeLayout(count);
+        config.Init(&storage);
+        for(auto& info : config.cubes)
+            makeCube(info, cubes.size());
+    }
+
+    // AnUpdate, the button shortcuts
+    void buttons() {
+        bool isRight = pointer.lastUsedRight;
+        if(pointer.down(BtnDel, isRight)) {
+            if(auto hit = raycast(pointer, cubes, 100)) {
+                int position = findIndexed(cubes, [hit](MockCube* cube) { return cube == hit; });
+                config.RemoveCube(hit->index);
+                eraseIndexed(cubes, position);
+            }
+        }
+        if(pointer.down(BtnMake, isRight)) {
+            auto pos = pointer.controller.pos + Math::normalized(pointer.forward()) * 1.5;
+            CubeInfo info(pos, pointer.controller.rot, {0.5, 0.5, 0.5, 1}, 2, 0, 1, false);
+            makeCube(info, cubes.size());
+            config.AddCube(info);
+        }
+        if(pointer.down(BtnEdit, isRight)) {
+            if(auto hit = raycast(pointer, cubes, 100))
+                hit->menu.active = !hit->menu.active;
+        }
+    }
+
+    // Cube::Update, given the cube the pointer is currently on
+    void update(MockCube* cube, MockCube* pointed) {
+        auto& t = cube->transform;
+        t.pose.pos = clampAboveFloor(t.pose.pos);
+        if(cube->info.locked)
+            return;
+        bool wasGrabbing = cube->grabbed;
+        if(pointer.trigger > GrabTrigger) {
+            if(cube->grabbed)
+                return;
+            if(pointed == cube) {
+                cube->grabbed = true;
+                cube->grab.begin(pointer.controller, t.pose);
+            }
+        } else
+            cube->grabbed = false;
+        if(wasGrabbing && !cube->grabbed) {
+            latency.reset();
+            cube->info.pos = t.pose.pos;
+            cube->info.rot = t.pose.rot;
+            config.SetCubeValue(cube->index, cube->info);
+        }
+    }
+
+    // Cube::LateUpdate
+    void lateUpdate(MockCube* cube, float deltaTime) {
+        if(!cube->grabbed || cube->info.locked)
+            return;
+        cube->grab.applyThumbsticks(pointer.horizontal, pointer.vertical, pointer.lastUsedRight, settings, cube->info.size, deltaTime);
+        if(directGrab) {
+            held.push_back(cube);
+            return;
+        }
+        auto target = cube->grab.target(pointer.controller);
+        auto& pose = cube->transform.pose;
+        pose = followGrab(pose, target, deltaTime);
+        pending.emplace_back(pose.pos, target.pos);
+    }
+
+    // the onBeforeRender callback, latency is measured here for both grab modes
+    void beforeRender(float deltaTime) {
+        if(!held.empty()) {
+            // reading the controller again, a recording only has one pose per frame so just its time changes
+            sampled = Trace::now();
+            for(auto cube : held) {
+                auto target = cube->grab.target(pointer.controller);
+                auto& pose = cube->transform.pose;
+                pose = smoothGrab(pose, target, grabSmoothing, deltaTime);
+                pending.emplace_back(pose.pos, target.pos);
+            }
+            held.clear();
+        }
+        float poseAge = (Trace::now() - sampled) / 1e9;
+        for(auto [applied, target] : pending) {
+            latency.record(poseAge, applied, target, deltaTime);
+            latencyTotal += latency.get();
+            latencyFrames++;
+        }
+        pending.clear();
+    }
+
+    // EditMenu::LateUpdate
+    void menuLateUpdate(MockCube* cube) {
+        auto& menu = cube->menu.transform.pose;
+        float y = std::atan2(2 * (menu.rot.w * menu.rot.y + menu.rot.x * menu.rot.z), 1 - 2 * (menu.rot.x * menu.rot.x + menu.rot.y * menu.rot.y)) * Math::Rad2Deg;
+        menu.rot = Math::euler(0, y, 0);
+        menu.pos = Math::angleAxis(y, Math::Vec3::up()) * Math::Vec3{1.5, 0, 0} + cube->transform.pose.pos;
+    }
+
+    void frame(InputFrame const& input) {
+        // the pointer was just given this frame's pose
+        sampled = Trace::now();
+        buttons();
+        // the pointer raycasts on its own every frame, the game pays for that rather than the mod
+        auto pointed = raycast(pointer, cubes, 100);
+        for(auto cube : cubes)
+            update(cube, pointed);
+        for(auto cube : cubes)
+            lateUpdate(cube, input.deltaTime);
+        for(auto cube : cubes) {
+            if(cube->menu.active)
+                menuLateUpdate(cube);
+        }
+        beforeRender(input.deltaTime);
+    }
+};
+
+double percentile(std::vector<double>& sorted, double p) {
+    return sorted[std::min<size_t>(sorted.size() - 1, p * sorted.size())];
+}
+
+int main(int argc, char** argv) {
+    int cubeCount = 1000, frameCount = 0;
+    bool directGrab = false;
+    float grabSmoothing = 0;
+    std::string recordingPath, writePath;
+    for(int i = 1; i < argc; i++) {
+        if(!strcmp(argv[i], "--cubes") && i + 1 < argc)
+            cubeCount = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--frames") && i + 1 < argc)
+            frameCount = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--direct"))
+            directGrab = true;
+        else if(!strcmp(argv[i], "--smoothing") && i + 1 < argc)
+            grabSmoothing = atof(argv[++i]);
+        else if(!strcmp(argv[i], "--write") && i + 1 < argc)
+            writePath = argv[++i];
+        else
+            recordingPath = argv[i];
+    }
+
+    std::vector<InputFrame> input;
+    if(!recordingPath.empty()) {
+        if(!readRecording(recordingPath, input) || input.empty()) {
+            fprintf(stderr, "Could not read recording %s\n", recordingPath.c_str());
+            return 1;
+        }
+    } else
+        input = syntheticInput(frameCount > 0 ? frameCount : 90 * 60);
+    if(!writePath.empty() && !writeRecording(writePath, input))
+        fprintf(stderr, "Could not write recording %s\n", writePath.c_str());
+    if(frameCount <= 0)
+        frameCount = input.size();
+
+    Simulation sim;
+    sim.directGrab = directGrab;
+    sim.grabSmoothing = grabSmoothing;
+    sim.init(cubeCount);
+
+    std::vector<double> times;
+    times.reserve(frameCount);
+    for(int i = 0; i < frameCount; i++) {
+        auto& frame = input[i % input.size()];
+        sim.pointer.update(frame);
+        auto start = std::chrono::steady_clock::now();
+        sim.frame(frame);
+        auto end = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double, std::micro>(end - start).count());
+    }
+
+    std::sort(times.begin(), times.end());
+    double total = 0;
+    for(double time : times)
+        total += time;
+    printf("frames: %i, cubes: %i at start, %i at end\n", frameCount, cubeCount, (int) sim.cubes.size());
+    printf("frame time (us): mean %.2f, p50 %.2f, p90 %.2f, p99 %.2f, max %.2f\n",
+        total / times.size(), percentile(times, 0.5), percentile(times, 0.9), percentile(times, 0.99), times.back());
+    if(sim.latencyFrames > 0)
+        printf("grab latency (ms): mean %.3f over %i held frames\n", sim.latencyTotal / sim.latencyFrames * 1000, sim.latencyFrames);
+    return 0;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "core/cubeinfo.hpp"
+#include "core/grab.hpp"
+#include "core/recording.hpp"
+
+#include <vector>
+
+// stand ins for the unity objects the mod's frame logic touches
+namespace Sim {
+    using namespace Qubes;
+
+    struct MockTransform {
+        Pose pose;
+        float scale = 1;
+    };
+
+    struct MockMenu {
+        bool active = false;
+        MockTransform transform;
+    };
+
+    struct MockCube {
+        int index;
+        MockTransform transform;
+        MockMenu menu;
+        CubeInfo info;
+        bool grabbed = false;
+        Grab grab;
+    };
+
+    struct MockPointer {
+        Pose controller;
+        float trigger = 0;
+        float horizontal = 0;
+        float vertical = 0;
+        bool lastUsedRight = true;
+        InputFrame last = {};
+        InputFrame current = {};
+
+        void update(InputFrame const& frame) {
+            last = current;
+            current = frame;
+            controller = {frame.pos, frame.rot};
+            trigger = frame.trigger;
+            horizontal = frame.horizontal;
+            vertical = frame.vertical;
+            lastUsedRight = frame.lastUsedRight;
+        }
+        // OVRInput.GetDown
+        bool down(int button, bool right) const { return current.held(button, right) && !last.held(button, right); }
+        Math::Vec3 forward() const { return controller.rot * Math::Vec3::forward(); }
+    };
+
+    // distance along the ray to a cube's hitbox, or a negative number if it misses
+    inline float raycastCube(Math::Vec3 origin, Math::Vec3 dir, MockCube const& cube) {
+        // the hitbox is resized to 0.5 before scaling
+        float half = 0.25 * cube.transform.scale;
+        Math::Quat inv = Math::inverse(cube.transform.pose.rot);
+        Math::Vec3 o = inv * (origin - cube.transform.pose.pos);
+        Math::Vec3 d = inv * dir;
+        float tmin = 0, tmax = 1e30;
+        for(int axis = 0; axis < 3; axis++) {
+            float oa = reinterpret_cast<float*>(&o)[axis], da = reinterpret_cast<float*>(&d)[axis];
+            if(Math::abs(da) < 1e-8f) {
+                if(oa < -half || oa > half)
+                    return -1;
+                continue;
+            }
+            float t1 = (-half - oa) / da, t2 = (half - oa) / da;
+            if(t1 > t2)
+                std::swap(t1, t2);
+            tmin = std::max(tmin, t1);
+            tmax = std::min(tmax, t2);
+            if(tmin > tmax)
+                return -1;
+        }
+        return tmin;
+    }
+
+    // nearest cube hit by the pointer, like Physics.Raycast or the pointer's own raycast
+    inline MockCube* raycast(MockPointer const& pointer, std::vector<MockCube*> const& cubes, float maxDistance) {
+        MockCube* nearest = nullptr;
+        float best = maxDistance;
+        Math::Vec3 dir = pointer.forward();
+        for(auto cube : cubes) {
+            float dist = raycastCube(pointer.controller.pos, dir, *cube);
+            if(dist >= 0 && dist < best) {
+                best = dist;
+                nearest = cube;
+            }
+        }
+        return nearest;
+    }
+}
@@ -0,0 +1,48 @@
+#include "core/animation.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace Qubes;
+
+static Animation parse(const char* json) {
+    rapidjson::Document doc;
+    doc.Parse(json);
+    return Animation(doc);
+}
+
+TEST(Animation, RoundTrip) {
+    Animation animation(Motion::Path);
+    animation.speed = 0.5;
+    animation.amount = 0.3;
+    animation.phase = 0.7;
+    animation.axis = {1, 0, 0};
+    animation.path = {{0, 0, 0}, {0, 1, 2}};
+    rapidjson::Document doc;
+    auto value = animation.ToJSON(doc.GetAllocator());
+    EXPECT_EQ(Animation(value), animation);
+}
+
+TEST(Animation, MissingMembers) {
+    EXPECT_EQ(parse("{}"), Animation());
+    EXPECT_EQ(parse("[]"), Animation());
+    auto animation = parse(R"({"motion": 2, "speed": 1})");
+    EXPECT_EQ(animation.motion, Motion::Spin);
+    EXPECT_EQ(animation.speed, 1);
+    EXPECT_EQ(animation.amount, Animation().amount);
+    EXPECT_EQ(animation.axis, Animation().axis);
+}
+
+TEST(Animation, WrongTypes) {
+    auto animation = parse(R"({"motion": "Bob", "speed": "fast", "amount": null, "axis": [1, 2], "path": [[1, 2, 3], [1, "a", 3], 4]})");
+    Animation expected;
+    expected.path = {{1, 2, 3}};
+    EXPECT_EQ(animation, expected);
+}
+
+TEST(Animation, MotionOutOfRange) {
+    EXPECT_EQ(parse(R"({"motion": 99})").motion, Motion::None);
+    EXPECT_EQ(parse(R"({"motion": -1})").motion, Motion::None);
+    EXPECT_STREQ(motionName(Motion::Orbit), "Orbit");
+    EXPECT_STREQ(motionName(Motion::Count), "Unknown");
+    EXPECT_STREQ(motionName((Motion) -3), "Unknown");
+}
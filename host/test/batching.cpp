@@ -0,0 +1,134 @@
+#include "core/batching.hpp"
+
+#include <map>
+
+#include <gtest/gtest.h>
+
+using namespace Qubes;
+
+static const uint32_t Red = colorKey({1, 0, 0, 1}), Blue = colorKey({0, 0, 1, 1});
+
+// every chunk within the limit, and every member in exactly one chunk of its color
+static void expectConsistent(StaticBatches const& batches, std::map<int, uint32_t> const& colors) {
+    std::map<int, int> seen;
+    for(int i = 0; i < batches.chunkCount(); i++) {
+        auto& chunk = batches.getChunk(i);
+        EXPECT_LE((int) chunk.members.size(), batches.getChunkLimit());
+        for(int id : chunk.members) {
+            seen[id]++;
+            auto color = colors.find(id);
+            ASSERT_NE(color, colors.end()) << "removed id " << id << " is still in chunk " << i;
+            EXPECT_EQ(chunk.color, color->second);
+        }
+    }
+    EXPECT_EQ(seen.size(), colors.size());
+    for(auto [id, count] : seen)
+        EXPECT_EQ(count, 1) << "id " << id;
+    EXPECT_EQ(batches.size(), (int) colors.size());
+}
+
+TEST(StaticBatches, ColorKey) {
+    // closer than one step of an 8 bit channel is the same material
+    EXPECT_EQ(colorKey({0.5, 0.5, 0.5, 1}), colorKey({0.501, 0.5, 0.5, 1}));
+    EXPECT_NE(colorKey({0.5, 0.5, 0.5, 1}), colorKey({0.51, 0.5, 0.5, 1}));
+    // out of range values are clamped
+    EXPECT_EQ(colorKey({2, -1, 0, 1}), Red);
+}
+
+TEST(StaticBatches, ChunkLimit) {
+    StaticBatches batches;
+    batches.setChunkLimit(4);
+    std::map<int, uint32_t> colors;
+    for(int i = 0; i < 9; i++)
+        colors[batches.add(Red)] = Red;
+    EXPECT_EQ(batches.chunkCount(), 3);
+    expectConsistent(batches, colors);
+    std::vector<int> dirty;
+    batches.takeDirty(dirty);
+    EXPECT_EQ(dirty.size(), 3u);
+    batches.takeDirty(dirty);
+    EXPECT_TRUE(dirty.empty());
+}
+
+TEST(StaticBatches, RemoveSwapsLast) {
+    StaticBatches batches;
+    int a = batches.add(Red), b = batches.add(Red), c = batches.add(Red);
+    std::vector<int> dirty;
+    batches.takeDirty(dirty);
+    batches.remove(a);
+    // the last member takes the removed one's slot
+    EXPECT_EQ(batches.getChunk(0).members, (std::vector<int>{c, b}));
+    batches.takeDirty(dirty);
+    EXPECT_EQ(dirty, std::vector<int>{0});
+    // and can be removed from there
+    batches.remove(c);
+    EXPECT_EQ(batches.getChunk(0).members, std::vector<int>{b});
+    // ids are reused
+    EXPECT_EQ(batches.add(Red), c);
+}
+
+TEST(StaticBatches, TakesOverEmptiedChunks) {
+    StaticBatches batches;
+    batches.setChunkLimit(2);
+    int a = batches.add(Red), b = batches.add(Red);
+    batches.remove(a);
+    batches.remove(b);
+    // the red chunk is empty, so blue uses it instead of making another
+    int c = batches.add(Blue);
+    EXPECT_EQ(batches.chunkCount(), 1);
+    EXPECT_EQ(batches.getChunk(0).color, Blue);
+    // and red makes a new one once it's needed again
+    int d = batches.add(Red);
+    EXPECT_EQ(batches.chunkCount(), 2);
+    expectConsistent(batches, {{c, Blue}, {d, Red}});
+}
+
+TEST(StaticBatches, SetColor) {
+    StaticBatches batches;
+    int a = batches.add(Red), b = batches.add(Red);
+    std::vector<int> dirty;
+    batches.takeDirty(dirty);
+    batches.setColor(a, Blue);
+    expectConsistent(batches, {{a, Blue}, {b, Red}});
+    batches.takeDirty(dirty);
+    EXPECT_EQ(dirty.size(), 2u);
+    // the same color changes nothing
+    batches.setColor(b, Red);
+    batches.takeDirty(dirty);
+    EXPECT_TRUE(dirty.empty());
+}
+
+TEST(StaticBatches, RandomEdits) {
+    StaticBatches batches;
+    batches.setChunkLimit(5);
+    Math::Random random(37);
+    const uint32_t palette[] = {Red, Blue, colorKey({0, 1, 0, 1}), colorKey({1, 1, 1, 1})};
+    std::map<int, uint32_t> colors;
+    std::vector<int> dirty;
+    for(int step = 0; step < 2000; step++) {
+        uint32_t color = palette[(int) random.range(0, 3.99f)];
+        float action = random.value();
+        if(colors.empty() || action < 0.45f)
+            colors[batches.add(color)] = color;
+        else {
+            auto it = colors.begin();
+            std::advance(it, (int) random.range(0, colors.size() - 0.01f));
+            if(action < 0.8f) {
+                batches.remove(it->first);
+                colors.erase(it);
+            } else {
+                batches.setColor(it->first, color);
+                it->second = color;
+            }
+        }
+        if(step % 7 == 0)
+            batches.takeDirty(dirty);
+        if(step % 100 == 0)
+            expectConsistent(batches, colors);
+    }
+    expectConsistent(batches, colors);
+    batches.clear();
+    EXPECT_EQ(batches.size(), 0);
+    for(int i = 0; i < batches.chunkCount(); i++)
+        EXPECT_TRUE(batches.getChunk(i).members.empty());
+}
@@ -0,0 +1,97 @@
+#include "core/events.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace Qubes;
+
+static void count(CutEvent const&, void* context) {
+    (*(int*) context)++;
+}
+
+TEST(CutBus, SubscribeOnce) {
+    CutBus bus;
+    int cuts = 0;
+    EXPECT_TRUE(bus.subscribe(count, &cuts));
+    EXPECT_FALSE(bus.subscribe(count, &cuts));
+    bus.dispatch({});
+    EXPECT_EQ(cuts, 1);
+    EXPECT_TRUE(bus.unsubscribe(count, &cuts));
+    EXPECT_FALSE(bus.unsubscribe(count, &cuts));
+    bus.dispatch({});
+    EXPECT_EQ(cuts, 1);
+}
+
+struct Nested {
+    CutBus* bus;
+    int calls = 0;
+    int* removedCuts;
+};
+
+// cuts another cube the first time, and unsubscribes a counter from inside the inner dispatch
+static void cutAgain(CutEvent const& event, void* context) {
+    auto nested = (Nested*) context;
+    if(nested->calls++ > 0)
+        return;
+    nested->bus->unsubscribe(count, nested->removedCuts);
+    nested->bus->dispatch(event);
+}
+
+TEST(CutBus, NestedDispatch) {
+    CutBus bus;
+    int before = 0, removed = 0, after = 0;
+    Nested nested = {&bus, 0, &removed};
+    bus.subscribe(count, &before);
+    bus.subscribe(cutAgain, &nested);
+    bus.subscribe(count, &removed);
+    bus.subscribe(count, &after);
+    bus.dispatch({});
+    // the outer dispatch still reaches everyone after the callback that nested
+    EXPECT_EQ(before, 2);
+    EXPECT_EQ(nested.calls, 2);
+    EXPECT_EQ(removed, 0);
+    EXPECT_EQ(after, 2);
+    // and the removed one is only compacted away once both are done
+    EXPECT_EQ(bus.size(), 3);
+    bus.dispatch({});
+    EXPECT_EQ(before, 3);
+    EXPECT_EQ(after, 3);
+}
+
+TEST(HitActionTable, IdsFromNames) {
+    int cuts = 0;
+    HitActionTable first, second;
+    first.addBuiltin(0, "None", nullptr);
+    second.addBuiltin(0, "None", nullptr);
+    // different load orders, and a mod missing from the second
+    int a = first.add("Mod A", count, &cuts);
+    int b = first.add("Mod B", count, &cuts);
+    first.add("Mod C", count, &cuts);
+    EXPECT_EQ(second.add("Mod B", count, &cuts), b);
+    EXPECT_EQ(second.add("Mod A", count, &cuts), a);
+    EXPECT_EQ(a, hitActionId("Mod A"));
+    EXPECT_GE(a, HitActionTable::FirstAddedId);
+    EXPECT_EQ(second.name(hitActionId("Mod C")), "Unknown");
+    second.run(hitActionId("Mod C"), {});
+    EXPECT_EQ(cuts, 0);
+    second.run(b, {});
+    EXPECT_EQ(cuts, 1);
+}
+
+TEST(HitActionTable, MenuOrder) {
+    HitActionTable table;
+    table.addBuiltin(0, "None", nullptr);
+    table.addBuiltin(1, "Pause", nullptr);
+    int id = table.add("Mod", nullptr);
+    EXPECT_EQ(table.size(), 3);
+    EXPECT_EQ(table.id(1), 1);
+    EXPECT_EQ(table.id(2), id);
+    EXPECT_EQ(table.index(id), 2);
+    EXPECT_EQ(table.id(3), -1);
+    EXPECT_EQ(table.index(5), -1);
+    // adding it again replaces the callback and keeps the id
+    int cuts = 0;
+    EXPECT_EQ(table.add("Mod", count, &cuts), id);
+    EXPECT_EQ(table.size(), 3);
+    table.run(id, {});
+    EXPECT_EQ(cuts, 1);
+}
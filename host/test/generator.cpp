@@ -0,0 +1,58 @@
+#include "core/generator.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+using namespace Qubes;
+
+static Generator makeGenerator(Shape shape, int count, float size = 1) {
+    Generator generator;
+    generator.shape = shape;
+    generator.count = count;
+    generator.base = CubeInfo({}, {}, {0.5, 0.5, 0.5, 1}, 2, 0, size, false);
+    return generator;
+}
+
+// no corner of any cube in the floor, and none too close to the player's head
+TEST(Generator, AboveFloor) {
+    for(float size : {0.5f, 1.0f, 2.0f}) {
+        for(int count : {10, 500, 1000, 5000}) {
+            for(int shape = 0; shape < (int) Shape::Count; shape++) {
+                auto generator = makeGenerator((Shape) shape, count, size);
+                auto cubes = generator.generate();
+                ASSERT_EQ((int) cubes.size(), count) << shapeName((Shape) shape);
+                float lowest = size * 0.25f * std::sqrt(3.0f);
+                float below = 0;
+                for(auto& cube : cubes) {
+                    below = std::max(below, lowest - cube.pos.y);
+                    EXPECT_GE(Math::magnitude(cube.pos - Math::Vec3{0, 1.5, 0}), generator.clearance - 1e-4f) << shapeName((Shape) shape);
+                }
+                EXPECT_LE(below, 1e-4f) << shapeName((Shape) shape) << " with " << count << " cubes of size " << size;
+            }
+        }
+    }
+}
+
+TEST(Generator, SameSeedSameCubes) {
+    auto generator = makeGenerator(Shape::Cloud, 300);
+    auto first = generator.generate(), second = generator.generate();
+    ASSERT_EQ(first.size(), second.size());
+    for(size_t i = 0; i < first.size(); i++)
+        EXPECT_EQ(first[i], second[i]);
+    generator.seed = 2;
+    EXPECT_NE(generator.generate()[0].pos, first[0].pos);
+}
+
+// the band of the sphere that's kept still leaves about spacing between neighbours
+TEST(Generator, SphereSpacing) {
+    auto generator = makeGenerator(Shape::Sphere, 1000);
+    auto cubes = generator.generate();
+    float closest = INFINITY;
+    for(size_t i = 0; i < cubes.size(); i++) {
+        for(size_t j = i + 1; j < cubes.size(); j++)
+            closest = std::min(closest, Math::magnitude(cubes[i].pos - cubes[j].pos));
+    }
+    EXPECT_GT(closest, generator.spacing * 0.75f);
+}
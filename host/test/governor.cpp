@@ -0,0 +1,89 @@
+#include "core/governor.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace Qubes;
+
+static constexpr float RefreshRate = 90;
+static constexpr float OnTime = 1 / RefreshRate;
+// every other refresh missed
+static constexpr float Overloaded = 2 / RefreshRate;
+
+// runs frames of deltaTime for seconds, returns whether the tier changed on any of them
+static bool run(Governor& governor, float deltaTime, float seconds) {
+    bool changed = false;
+    for(float time = 0; time < seconds; time += deltaTime)
+        changed |= governor.update(deltaTime, RefreshRate);
+    return changed;
+}
+
+TEST(Governor, HoldsWhenOnTime) {
+    Governor governor;
+    EXPECT_FALSE(run(governor, OnTime, 30));
+    EXPECT_EQ(governor.getTier(), QualityTier::Full);
+    EXPECT_FLOAT_EQ(governor.refreshInterval(), OnTime);
+}
+
+TEST(Governor, StepsDownUnderLoad) {
+    Governor governor;
+    run(governor, OnTime, 3);
+    EXPECT_TRUE(run(governor, Overloaded, 1));
+    EXPECT_EQ(governor.getTier(), QualityTier::LightDebris);
+    // one step at a time, each new tier measured from scratch
+    run(governor, Overloaded, 10);
+    EXPECT_EQ(governor.getTier(), QualityTier::NoDebris);
+}
+
+TEST(Governor, NoStepUpWhileOverBudget) {
+    Governor governor;
+    run(governor, OnTime, 3);
+    run(governor, Overloaded, 10);
+    ASSERT_EQ(governor.getTier(), QualityTier::NoDebris);
+    // constant slow frames are still missed frames, however long they last
+    EXPECT_FALSE(run(governor, Overloaded, 60));
+    EXPECT_EQ(governor.getTier(), QualityTier::NoDebris);
+    EXPECT_GT(governor.missedFraction(), 0.9f);
+}
+
+TEST(Governor, StepsUpAfterRecovery) {
+    Governor governor;
+    run(governor, Overloaded, 10);
+    ASSERT_EQ(governor.getTier(), QualityTier::NoDebris);
+    // stepping up is slower than stepping down, so not straight away
+    run(governor, OnTime, 2);
+    EXPECT_EQ(governor.getTier(), QualityTier::NoDebris);
+    run(governor, OnTime, 30);
+    EXPECT_EQ(governor.getTier(), QualityTier::Full);
+}
+
+TEST(Governor, FollowsRefreshRate) {
+    Governor governor;
+    // 72hz frames fit a 72hz display but miss a 120hz one
+    for(float time = 0; time < 10; time += 1 / 72.0f)
+        governor.update(1 / 72.0f, 72);
+    EXPECT_EQ(governor.getTier(), QualityTier::Full);
+    for(float time = 0; time < 1; time += 1 / 72.0f)
+        governor.update(1 / 72.0f, 120);
+    EXPECT_EQ(governor.getTier(), QualityTier::LightDebris);
+}
+
+TEST(Governor, UnknownRefreshRate) {
+    Governor governor;
+    for(float time = 0; time < 10; time += Overloaded)
+        EXPECT_FALSE(governor.update(Overloaded, 0));
+    EXPECT_EQ(governor.getTier(), QualityTier::Full);
+    EXPECT_EQ(governor.missedFraction(), 0);
+}
+
+TEST(Governor, Reset) {
+    Governor governor;
+    run(governor, Overloaded, 10);
+    ASSERT_NE(governor.getTier(), QualityTier::Full);
+    governor.reset();
+    EXPECT_EQ(governor.getTier(), QualityTier::Full);
+    EXPECT_EQ(governor.missedFraction(), 0);
+    EXPECT_EQ(governor.refreshInterval(), 0);
+    // starts over, on time frames afterwards don't change anything
+    EXPECT_FALSE(run(governor, OnTime, 10));
+    EXPECT_EQ(governor.getTier(), QualityTier::Full);
+}
@@ -0,0 +1,112 @@
+#include "core/math.hpp"
+
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+using namespace Qubes;
+
+// the expected values are what unity gives for the same calls
+// on arm64 the quaternion product, dot and slerp go through the neon paths, everywhere else through the scalar ones
+
+static constexpr float Tolerance = 1e-5f;
+
+static void expectVec(Math::Vec3 const& actual, Math::Vec3 const& expected) {
+    EXPECT_NEAR(actual.x, expected.x, Tolerance);
+    EXPECT_NEAR(actual.y, expected.y, Tolerance);
+    EXPECT_NEAR(actual.z, expected.z, Tolerance);
+}
+
+static void expectQuat(Math::Quat const& actual, Math::Quat const& expected) {
+    EXPECT_NEAR(actual.x, expected.x, Tolerance);
+    EXPECT_NEAR(actual.y, expected.y, Tolerance);
+    EXPECT_NEAR(actual.z, expected.z, Tolerance);
+    EXPECT_NEAR(actual.w, expected.w, Tolerance);
+}
+
+// q and -q are the same rotation, and unity doesn't promise which one it returns from a matrix
+static void expectRotation(Math::Quat const& actual, Math::Quat const& expected) {
+    if(Math::dot(actual, expected) < 0)
+        expectQuat({-actual.x, -actual.y, -actual.z, -actual.w}, expected);
+    else
+        expectQuat(actual, expected);
+}
+
+TEST(Math, Euler) {
+    expectQuat(Math::euler(0, 0, 0), Math::Quat::identity());
+    expectQuat(Math::euler(90, 0, 0), {0.707107f, 0, 0, 0.707107f});
+    expectQuat(Math::euler(30, 45, 60), {0.391904f, 0.200562f, 0.360423f, 0.822363f});
+    expectQuat(Math::euler(-90, 10, 200), {0.183013f, 0.683013f, 0.683013f, -0.183013f});
+    expectQuat(Math::euler(Math::Vec3{30, 45, 60}), Math::euler(30, 45, 60));
+}
+
+TEST(Math, AngleAxis) {
+    expectQuat(Math::angleAxis(72, {1, 2, 3}), {0.157092f, 0.314184f, 0.471277f, 0.809017f});
+    // the axis doesn't have to be normalized
+    expectQuat(Math::angleAxis(-30, {0, 0, 2}), {0, 0, -0.258819f, 0.965926f});
+    expectQuat(Math::angleAxis(0, Math::Vec3::up()), Math::Quat::identity());
+}
+
+TEST(Math, LookRotation) {
+    expectRotation(Math::lookRotation(Math::Vec3::forward()), Math::Quat::identity());
+    expectRotation(Math::lookRotation({0, 0, -1}), {0, 1, 0, 0});
+    expectRotation(Math::lookRotation({1, 1, 1}), {-0.279848f, 0.364705f, 0.115917f, 0.880476f});
+    expectRotation(Math::lookRotation({-0.3f, -0.8f, 0.2f}), {0.478510f, -0.396317f, 0.256091f, 0.740525f});
+    expectRotation(Math::lookRotation(Math::Vec3::right(), Math::Vec3::forward()), {0.5f, 0.5f, 0.5f, 0.5f});
+    // forward parallel to up has no defined roll, it falls back to the identity
+    expectRotation(Math::lookRotation(Math::Vec3::up()), Math::Quat::identity());
+}
+
+TEST(Math, Slerp) {
+    auto a = Math::euler(10, 20, 30), b = Math::euler(-5, 60, 2);
+    expectQuat(Math::slerp(a, b, 0.3f), {0.081955f, 0.257946f, 0.181869f, 0.945342f});
+    expectQuat(Math::slerp(Math::Quat::identity(), Math::euler(0, 90, 0), 0.5f), {0, 0.382683f, 0, 0.923880f});
+    // t is clamped
+    expectQuat(Math::slerp(a, b, -1), a);
+    expectQuat(Math::slerp(a, b, 2), b);
+    // the negated quaternion is the same rotation, the shorter way round is taken
+    auto far = Math::euler(0, 170, 0);
+    expectRotation(Math::slerp(Math::Quat::identity(), {-far.x, -far.y, -far.z, -far.w}, 0.5f), {0, 0.675590f, 0, 0.737277f});
+    // nearly parallel goes through the linear fallback
+    auto near = Math::euler(0, 0.01f, 0);
+    expectRotation(Math::slerp(Math::Quat::identity(), near, 0.5f), Math::euler(0, 0.005f, 0));
+}
+
+TEST(Math, RotateVector) {
+    expectVec(Math::euler(0, 90, 0) * Math::Vec3::forward(), {1, 0, 0});
+    expectVec(Math::euler(90, 0, 0) * Math::Vec3::forward(), {0, -1, 0});
+    expectVec(Math::angleAxis(90, Math::Vec3::up()) * Math::Vec3::right(), {0, 0, -1});
+    expectVec(Math::euler(30, 45, 60) * Math::Vec3{1, 2, 3}, {1.625665f, 0.116025f, 3.368048f});
+}
+
+TEST(Math, Multiply) {
+    auto a = Math::euler(10, 20, 30), b = Math::euler(-5, 60, 2);
+    expectQuat(a * b, {-0.031569f, 0.589487f, 0.310099f, 0.745216f});
+    expectQuat(a * Math::Quat::identity(), a);
+    expectQuat(a * Math::inverse(a), Math::Quat::identity());
+    // rotating by a product is rotating by each in turn
+    Math::Vec3 v = {0.3f, -1, 2};
+    expectVec((a * b) * v, a * (b * v));
+}
+
+// the plain formulas, so the neon paths are checked against them on arm64
+TEST(Math, MatchesScalar) {
+    Math::Random random(27);
+    for(int i = 0; i < 1000; i++) {
+        Math::Quat a = Math::normalized(Math::Quat{random.range(-1, 1), random.range(-1, 1), random.range(-1, 1), random.range(-1, 1)});
+        Math::Quat b = Math::normalized(Math::Quat{random.range(-1, 1), random.range(-1, 1), random.range(-1, 1), random.range(-1, 1)});
+        expectQuat(a * b, {
+            a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+            a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+            a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+        });
+        EXPECT_NEAR(Math::dot(a, b), a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w, Tolerance);
+        // slerp ends on unit quaternions on the arc between a and b
+        float t = random.value();
+        auto mid = Math::slerp(a, b, t);
+        EXPECT_NEAR(Math::dot(mid, mid), 1, Tolerance);
+        float angle = std::acos(std::min(1.0f, std::abs(Math::dot(a, b))));
+        EXPECT_NEAR(std::acos(std::min(1.0f, std::abs(Math::dot(a, mid)))), angle * t, 1e-3f);
+    }
+}
@@ -0,0 +1,96 @@
+#include "core/snapshot.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace Qubes;
+
+static std::vector<CubeInfo> makeCubes(int count) {
+    std::vector<CubeInfo> cubes;
+    for(int i = 0; i < count; i++)
+        cubes.emplace_back(Math::Vec3{0, 1, (float) i}, Math::Quat::identity(), Math::Color{1, 0, 0, 1}, 2, 0, 1, false);
+    return cubes;
+}
+
+TEST(Snapshot, PublishAndAcquire) {
+    SnapshotPublisher publisher;
+    auto empty = publisher.acquire();
+    EXPECT_EQ(empty->count, 0);
+    auto cubes = makeCubes(3);
+    publisher.publish(cubes);
+    // a held snapshot stays as it was after the next publish
+    auto first = publisher.acquire();
+    cubes[1].pos.x = 5;
+    publisher.publish(cubes);
+    auto second = publisher.acquire();
+    EXPECT_GT(first->version, empty->version);
+    EXPECT_GT(second->version, first->version);
+    ASSERT_EQ(first->count, 3);
+    EXPECT_EQ(first->cubes[1].pos[0], 0);
+    EXPECT_EQ(second->cubes[1].pos[0], 5);
+    EXPECT_EQ(SnapshotPublisher::cubeInfos(second)[1].pos.x, 5);
+    SnapshotPublisher::release(empty);
+    SnapshotPublisher::release(first);
+    SnapshotPublisher::release(second);
+}
+
+// the same check as BM_SnapshotStress, bounded so it runs with the other tests
+// every cube of a snapshot has x = its version, so a torn or freed one shows up as a mismatch
+TEST(Snapshot, ConcurrentReaders) {
+    constexpr int Readers = 4, Publishes = 50000, Count = 16;
+    SnapshotPublisher publisher;
+    std::atomic<bool> done = false;
+    std::atomic<int> torn = 0, backwards = 0;
+    std::atomic<int64_t> reads = 0;
+
+    std::vector<std::thread> readers;
+    for(int i = 0; i < Readers; i++) {
+        readers.emplace_back([&]() {
+            uint64_t last = 0;
+            int64_t count = 0;
+            // at least a few reads even if the writer finishes first
+            while(!done.load(std::memory_order_acquire) || count < 100) {
+                auto snapshot = publisher.acquire();
+                float expected = snapshot->version;
+                for(int cube = 0; cube < snapshot->count; cube++) {
+                    if(snapshot->cubes[cube].pos[0] != expected) {
+                        torn++;
+                        break;
+                    }
+                }
+                if(snapshot->count > 0 && SnapshotPublisher::cubeInfos(snapshot)[snapshot->count - 1].pos.x != expected)
+                    torn++;
+                if(snapshot->version < last)
+                    backwards++;
+                last = snapshot->version;
+                SnapshotPublisher::release(snapshot);
+                count++;
+            }
+            reads += count;
+        });
+    }
+
+    auto cubes = makeCubes(Count);
+    auto initial = publisher.acquire();
+    uint64_t version = initial->version;
+    SnapshotPublisher::release(initial);
+    for(int i = 0; i < Publishes; i++) {
+        version++;
+        for(auto& cube : cubes)
+            cube.pos.x = version;
+        publisher.publish(cubes);
+    }
+    done.store(true, std::memory_order_release);
+    for(auto& reader : readers)
+        reader.join();
+
+    EXPECT_EQ(torn, 0);
+    EXPECT_EQ(backwards, 0);
+    EXPECT_GE(reads, Readers * 100);
+    auto last = publisher.acquire();
+    EXPECT_EQ(last->version, version);
+    SnapshotPublisher::release(last);
+}
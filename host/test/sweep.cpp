@@ -0,0 +1,78 @@
+#include "core/sweep.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+using namespace Qubes;
+
+static std::vector<OBB> makeBoxes(int count, Math::Random& random) {
+    std::vector<OBB> boxes;
+    for(int i = 0; i < count; i++) {
+        float half = random.range(0.1, 0.3);
+        boxes.push_back({{random.range(-3, 3), random.range(0, 3), random.range(-3, 3)}, Math::euler(random.range(0, 360), random.range(0, 360), 0), {half, half, half}});
+    }
+    return boxes;
+}
+
+static std::vector<int> hitIds(SweepBVH const& bvh, BladeSweep const& blade) {
+    std::vector<SweepHit> hits;
+    bvh.sweep(blade, hits);
+    std::vector<int> ids;
+    for(auto& hit : hits)
+        ids.push_back(hit.id);
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+TEST(Sweep, HitsBoxInPath) {
+    SweepBVH bvh;
+    bvh.build({{{0, 1, 1}, Math::Quat::identity(), {0.1, 0.1, 0.1}}, {{5, 1, 1}, Math::Quat::identity(), {0.1, 0.1, 0.1}}});
+    // a vertical blade moving sideways through the first box
+    BladeSweep blade = {{-0.5, 0.5, 1}, {-0.5, 1.5, 1}, {0.5, 0.5, 1}, {0.5, 1.5, 1}};
+    EXPECT_EQ(hitIds(bvh, blade), std::vector<int>{0});
+}
+
+// a swing covering a metre in one frame still finds a box two centimetres wide
+TEST(Sweep, FastSwingHitsSmallBox) {
+    SweepBVH bvh;
+    bvh.build({{{0.03, 1, 1}, Math::Quat::identity(), {0.01, 0.01, 0.01}}, {{0.5, 1, 1}, Math::Quat::identity(), {0.3, 0.3, 0.3}}});
+    BladeSweep blade = {{-0.5, 0.5, 1}, {-0.5, 1.5, 1}, {0.5, 0.5, 1}, {0.5, 1.5, 1}};
+    EXPECT_EQ(hitIds(bvh, blade), (std::vector<int>{0, 1}));
+}
+
+// a jump between frames isn't a swing, and positions that aren't finite don't loop forever
+TEST(Sweep, IgnoresTeleports) {
+    SweepBVH bvh;
+    bvh.build({{{0, 1, 1}, Math::Quat::identity(), {0.001, 0.001, 0.001}}});
+    BladeSweep blade = {{-5, 0.5, 1}, {-5, 1.5, 1}, {5, 0.5, 1}, {5, 1.5, 1}};
+    EXPECT_TRUE(hitIds(bvh, blade).empty());
+    blade.prevTop.x = INFINITY;
+    EXPECT_TRUE(hitIds(bvh, blade).empty());
+    blade.prevTop.x = NAN;
+    EXPECT_TRUE(hitIds(bvh, blade).empty());
+}
+
+// moved boxes are found where they are now and not where they were
+TEST(Sweep, RefitMatchesBuild) {
+    Math::Random random(39);
+    auto boxes = makeBoxes(500, random);
+    SweepBVH refitted, rebuilt;
+    refitted.build(boxes);
+    for(int frame = 0; frame < 20; frame++) {
+        for(int i = 0; i < boxes.size(); i += 3) {
+            boxes[i].center += random.insideUnitSphere() * 0.5f;
+            boxes[i].rot = Math::euler(random.range(0, 360), random.range(0, 360), 0);
+            refitted.update(i, boxes[i]);
+        }
+        refitted.refit();
+        rebuilt.build(boxes);
+        for(int swing = 0; swing < 50; swing++) {
+            Math::Vec3 hand = {random.range(-3, 3), random.range(0, 2), random.range(-3, 3)};
+            Math::Vec3 dir = random.onUnitSphere(), move = random.onUnitSphere() * 0.3f;
+            BladeSweep blade = {hand, hand + dir, hand + move, hand + move + dir};
+            EXPECT_EQ(hitIds(refitted, blade), hitIds(rebuilt, blade));
+        }
+    }
+}
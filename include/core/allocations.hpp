@@ -0,0 +1,54 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// opt-in counting of managed allocations made by mod code, attributed to the call site that made them
+// when disabled a tracked site costs one relaxed load
+namespace Qubes::Allocations {
+    extern std::atomic<bool> enabled;
+
+    constexpr int MaxSites = 32;
+
+    // returns -1 once all sites are taken, which record ignores
+    int registerSite(const char* name);
+    void record(int site, size_t bytes);
+
+    struct Frame {
+        uint32_t count;
+        uint32_t bytes;
+        // the site with the most bytes this frame, or -1
+        int topSite;
+        bool overBudget;
+    };
+    // call once per frame, moves the current frame into the totals
+    Frame endFrame(uint32_t budgetBytes);
+
+    struct SiteReport {
+        const char* name;
+        uint64_t count, bytes;
+        // most bytes from this site in a single frame
+        uint32_t peakBytes;
+    };
+    struct Report {
+        int frames;
+        int framesOverBudget;
+        std::vector<SiteReport> sites;
+    };
+    // sites that allocated since the last report, sorted by bytes, and resets the totals
+    Report takeReport();
+
+    const char* siteName(int site);
+}
+
+#define ALLOC_CONCAT_INNER(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_INNER(a, b)
+// name must be a string literal, bytes is an estimate of the managed size
+#define TRACK_ALLOC(name, bytes) do { \
+    if(Qubes::Allocations::enabled.load(std::memory_order_relaxed)) { \
+        static const int ALLOC_CONCAT(allocSite, __LINE__) = Qubes::Allocations::registerSite(name); \
+        Qubes::Allocations::record(ALLOC_CONCAT(allocSite, __LINE__), bytes); \
+    } \
+} while(0)
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "core/grab.hpp"
+
+#include "rapidjson/document.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Qubes {
+    enum class Motion { None, Bob, Spin, Orbit, Path, Count };
+    // "Unknown" for values outside the enum
+    const char* motionName(Motion motion);
+
+    // a looping motion relative to the pose saved in the config
+    struct Animation {
+        Motion motion = Motion::None;
+        // loops per second
+        float speed = 0.25;
+        // bob height and orbit radius, in meters
+        float amount = 0.1;
+        // bob direction, spin axis and orbit axis, in the cube's space
+        Math::Vec3 axis = Math::Vec3::up();
+        // 0 to 1, so that cubes with the same motion don't all move in sync
+        float phase = 0;
+        // offsets from the saved position in the cube's space, visited in order and looped
+        std::vector<Math::Vec3> path;
+
+        Animation() = default;
+        Animation(Motion motion) : motion(motion) {}
+        // anything missing or of the wrong type keeps its default
+        Animation(rapidjson::Value const& obj);
+
+        // paths need two points to go anywhere
+        bool moves() const { return motion != Motion::None && (motion != Motion::Path || path.size() >= 2); }
+
+        rapidjson::Value ToJSON(rapidjson::Document::AllocatorType& allocator) const;
+
+        bool operator==(Animation const& o) const = default;
+    };
+
+    // one cube at a time, the batch below does the same for all of them
+    Pose animate(Animation const& animation, Pose const& base, float time);
+    // the base pose that animates to the given one at time, for saving a cube moved while animated
+    Pose unanimate(Animation const& animation, Pose const& animated, float time);
+
+    // every animated cube as a structure of arrays, evaluated in one pass per frame
+    class AnimationBatch {
+        public:
+
+        // returns the slot, which changes when others are removed
+        int add(Animation const& animation, Pose const& base, float radius);
+        // moves the last slot into this one, returns the slot that moved or -1 if it was this one
+        int remove(int slot);
+        void clear();
+        void setBase(int slot, Pose const& base);
+        void setRadius(int slot, float radius) { radii[slot] = radius; }
+
+        int size() const { return animations.size(); }
+        Animation const& getAnimation(int slot) const { return animations[slot]; }
+        Pose getBase(int slot) const { return bases[slot]; }
+
+        // time in seconds, visibility is only checked with a frustum and is true for all otherwise
+        void evaluate(float time, Math::Frustum const* frustum = nullptr);
+        Pose getPose(int slot) const {
+            return {{posX[slot], posY[slot], posZ[slot]}, {rotX[slot], rotY[slot], rotZ[slot], rotW[slot]}};
+        }
+        bool isVisible(int slot) const { return visible[slot]; }
+
+        private:
+
+        // recomputes the world space vectors of a slot from its base and animation
+        void prepare(int slot);
+
+        std::vector<Animation> animations;
+        std::vector<Pose> bases;
+        std::vector<std::vector<Math::Vec3>> paths;
+
+        // position = base + (cos - 1) * u + sin * v, for bob and orbit
+        // rotation = base * (axis * sin(spin), cos(spin)), spin is 0 for everything but spin
+        std::vector<float> baseX, baseY, baseZ;
+        std::vector<float> baseRotX, baseRotY, baseRotZ, baseRotW;
+        std::vector<float> uX, uY, uZ, vX, vY, vZ;
+        std::vector<float> axisX, axisY, axisZ;
+        std::vector<float> speed, phase, spin, radii;
+
+        std::vector<float> posX, posY, posZ;
+        std::vector<float> rotX, rotY, rotZ, rotW;
+        std::vector<uint8_t> visible;
+    };
+}
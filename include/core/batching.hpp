@@ -0,0 +1,62 @@
+#pragma once
+
+#include "core/math.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Qubes {
+    // colors that look the same share a material and a batch
+    uint32_t colorKey(Math::Color color);
+
+    // groups static cubes by color into chunks that each become one combined mesh
+    // only does the bookkeeping, the caller builds a mesh for every chunk takeDirty returns
+    class StaticBatches {
+        public:
+
+        struct Chunk {
+            uint32_t color;
+            std::vector<int> members;
+            bool dirty;
+        };
+
+        // combined meshes have 16 bit indices, so this depends on the vertices of one cube
+        void setChunkLimit(int cubes) { limit = cubes > 0 ? cubes : 1; }
+        int getChunkLimit() const { return limit; }
+
+        // returns the id of the new member
+        int add(uint32_t color);
+        void remove(int id);
+        void setColor(int id, uint32_t color);
+        // its chunk has to be rebuilt, e.g. after it was hidden or resized
+        void markDirty(int id);
+        void clear();
+
+        // chunks that changed since the last call, also clears their flags
+        void takeDirty(std::vector<int>& out);
+        Chunk const& getChunk(int chunk) const { return chunks[chunk]; }
+        int chunkCount() const { return chunks.size(); }
+        int size() const { return members; }
+
+        private:
+
+        struct Entry {
+            int chunk = -1;
+            int slot = -1;
+        };
+
+        void place(int id, uint32_t color);
+        void unplace(int id);
+        void setDirty(int chunk);
+
+        int limit = 256;
+        int members = 0;
+        std::vector<Entry> entries;
+        std::vector<int> freeIds;
+        std::vector<Chunk> chunks;
+        std::vector<int> dirtyChunks;
+        // chunks of each color, they keep emptied ones until another color takes them
+        std::unordered_map<uint32_t, std::vector<int>> byColor;
+    };
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <vector>
+
+namespace Qubes {
+    // cube objects store their index in the config, which has to stay in sync with their position in the array
+    // removes the object at position and moves the indices of all later objects down by one
+    template<class T>
+    void eraseIndexed(std::vector<T*>& objects, int position) {
+        objects.erase(objects.begin() + position);
+        for(int i = position; i < objects.size(); i++) {
+            objects[i]->index--;
+        }
+    }
+
+    // position of the first object matching pred, or -1
+    template<class T, class F>
+    int findIndexed(std::vector<T*> const& objects, F&& pred) {
+        for(int i = 0; i < objects.size(); i++) {
+            if(pred(objects[i]))
+                return i;
+        }
+        return -1;
+    }
+}
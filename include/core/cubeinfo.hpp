@@ -0,0 +1,51 @@
+#pragma once
+
+#include "core/math.hpp"
+#include "core/animation.hpp"
+
+#include "rapidjson/document.h"
+
+#include <string>
+#include <vector>
+
+namespace Qubes {
+    struct CubeInfo {
+        Math::Vec3 pos;
+        Math::Quat rot;
+        Math::Color color;
+        int type = 0;
+        int hitAction = 0;
+        float size = 1;
+        bool locked = false;
+        // only saved when it has a motion
+        Animation animation;
+
+        CubeInfo() = default;
+        CubeInfo(Math::Vec3 pos, Math::Quat rot, Math::Color color, int type, int hitAction, float size, bool locked);
+        CubeInfo(rapidjson::Value& obj);
+
+        rapidjson::Value ToJSON(rapidjson::Document::AllocatorType& allocator) const;
+
+        bool operator==(CubeInfo const& o) const = default;
+    };
+
+    // whether obj has everything CubeInfo reads, for configs edited outside the game
+    // error gets what was wrong with it
+    bool validCube(rapidjson::Value const& obj, std::string* error = nullptr);
+
+    // how to turn one cube array into another while keeping as many of the old cubes as possible
+    struct LayoutDiff {
+        // for each new cube, the old cube it reuses, or -1 if it has to be made
+        std::vector<int> source;
+        // new cubes whose reused old cube has different info
+        std::vector<int> changed;
+        // old cubes that nothing reuses, in increasing order
+        std::vector<int> removed;
+
+        // nothing added, removed, changed or moved
+        bool empty() const;
+    };
+
+    // identical cubes are matched first, wherever they moved in the array, the rest are paired in order
+    LayoutDiff diffLayouts(std::vector<CubeInfo> const& from, std::vector<CubeInfo> const& to);
+}
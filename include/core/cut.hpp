@@ -0,0 +1,20 @@
+#pragma once
+
+#include "core/math.hpp"
+
+namespace Qubes {
+    // whether a cut direction in the local space of an arrow cube goes along the arrow, same as the game's check for notes
+    bool cutDirectionOk(Math::Vec3 localDir, float angleTolerance = 50);
+
+    // a cut plane in the local space of a note, laid out like the Vector4 the debris shader takes
+    struct CutPlane {
+        Math::Vec3 normal;
+        float offset;
+    };
+
+    // the cut point is kept within maxCenterDistance of the note center
+    CutPlane localCutPlane(Math::Vec3 notePos, Math::Quat noteRot, Math::Vec3 cutPoint, Math::Vec3 cutNormal, float maxCenterDistance);
+
+    // the center of the debris half of a mesh, used to offset the debris so it rotates around itself
+    Math::Vec3 debrisCenter(Math::Vec3 const* vertices, int count, CutPlane const& plane);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "shared/events.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Qubes {
+    // everyone listening for cuts, main thread only
+    // dispatching doesn't allocate, only adding subscribers does
+    class CutBus {
+        public:
+
+        // the same callback and context only subscribe once, returns false if it already was
+        bool subscribe(CutCallback callback, void* context);
+        bool unsubscribe(CutCallback callback, void* context);
+        int size() const { return subscribers.size(); }
+
+        // subscribers added by a callback get the next cut, ones removed by it don't get this one
+        void dispatch(CutEvent const& event);
+
+        private:
+
+        struct Subscriber {
+            CutCallback callback;
+            void* context;
+        };
+        std::vector<Subscriber> subscribers;
+        // a callback can cause another cut, so dispatches can nest
+        int depth = 0;
+        // removed during a dispatch, compacted once the outermost one is done
+        bool removed = false;
+    };
+
+    // what a cube does when cut in gameplay, by the hit action id saved with each cube
+    // ids of added actions come from their names, so they don't depend on which mods are installed or their load order
+    class HitActionTable {
+        public:
+
+        // the built in ones keep the ids cubes have always saved them with, added actions are at least this
+        static constexpr int FirstAddedId = 1 << 16;
+
+        // returns the id, adding a name that exists replaces its callback and keeps the id
+        int add(std::string name, CutCallback callback, void* context = nullptr);
+        // for the built in actions, with their fixed ids below FirstAddedId
+        void addBuiltin(int id, std::string name, CutCallback callback, void* context = nullptr);
+        int size() const { return actions.size(); }
+        // for stepping through the actions in menus, in the order they were added
+        int id(int index) const;
+        // -1 for ids that aren't registered
+        int index(int id) const;
+        // "Unknown" for ids that aren't registered, like ones saved while another mod was installed
+        std::string const& name(int id) const;
+        // does nothing for unknown ids
+        void run(int id, CutEvent const& event) const;
+
+        private:
+
+        struct Action {
+            int id;
+            std::string name;
+            CutCallback callback;
+            void* context;
+        };
+        std::vector<Action> actions;
+    };
+
+    // the same for a name everywhere, at least HitActionTable::FirstAddedId
+    int hitActionId(std::string const& name);
+}
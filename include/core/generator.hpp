@@ -0,0 +1,45 @@
+#pragma once
+
+#include "core/cubeinfo.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Qubes {
+    enum class Shape { Grid, Sphere, Spiral, Cloud, Count };
+    const char* shapeName(Shape shape);
+
+    // big layouts around the player for finding out how many cubes things hold up to
+    // the same settings always give the same cubes, every cube faces the player
+    struct Generator {
+        Shape shape = Shape::Grid;
+        int count = 100;
+        // picks the cloud's positions and each cube's arrow direction
+        uint32_t seed = 1;
+        // roughly the distance between neighbouring cubes, in meters
+        float spacing = 0.5;
+        // nothing is put closer than this to the player
+        float clearance = 1.5;
+        // color, type, size and so on, copied to every cube
+        CubeInfo base;
+
+        std::vector<CubeInfo> generate() const;
+    };
+
+    // one step of the stress test, times in milliseconds
+    struct StressResult {
+        Shape shape;
+        int cubes;
+        // making the objects and adding them to the config, including its write
+        double createMs;
+        // writing the layout again and reading it back from the file
+        double saveMs, loadMs;
+        // whole frames while the cubes were shown
+        double frameMsP50, frameMsP99;
+        uint64_t memoryBytes;
+    };
+
+    // with a header line, for spreadsheets
+    std::string stressCsv(std::vector<StressResult> const& results);
+}
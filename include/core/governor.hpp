@@ -0,0 +1,52 @@
+#pragma once
+
+namespace Qubes {
+    // each tier keeps the reductions of the ones before it
+    enum class QualityTier { Full, LightDebris, CappedDebris, NoDistantGlow, NoDebris, Count };
+    const char* tierName(QualityTier tier);
+
+    struct GovernorSettings {
+        // a frame took longer than this many refresh intervals, so at least one was missed
+        float missedFrame = 1.5;
+        // fraction of missed frames that steps down, and that has to be beaten to step back up
+        float stepDownAbove = 0.1;
+        float stepUpBelow = 0.02;
+        // how long each has to hold, stepping up is slower so it doesn't flap
+        float stepDownAfter = 0.5;
+        float stepUpAfter = 4;
+        // smoothing of the missed fraction, in seconds
+        float smoothing = 0.5;
+    };
+
+    // steps through quality tiers from frame times alone, with no engine calls so it can run on the host
+    class Governor {
+        QualityTier tier = QualityTier::Full;
+        float missed = 0;
+        float heldFor = 0;
+        float interval = 0;
+
+        public:
+
+        // refreshRate is the display's in hz, the budget a frame has to fit in, nothing changes while it's unknown
+        // returns whether the tier changed
+        bool update(float deltaTime, float refreshRate, GovernorSettings const& settings = {});
+        void reset();
+
+        QualityTier getTier() const { return tier; }
+        bool atLeast(QualityTier other) const { return tier >= other; }
+        float missedFraction() const { return missed; }
+        // of the last update, in seconds
+        float refreshInterval() const { return interval; }
+    };
+
+    // token bucket, allows bursts of up to burst and then rate per second
+    class RateLimiter {
+        float tokens;
+
+        public:
+
+        RateLimiter(float burst = 0) : tokens(burst) {}
+        void update(float deltaTime, float rate, float burst);
+        bool take();
+    };
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "core/math.hpp"
+
+namespace Qubes {
+    struct Pose {
+        Math::Vec3 pos;
+        Math::Quat rot;
+    };
+
+    // trigger value needed to grab a cube
+    constexpr float GrabTrigger = 0.9;
+
+    struct GrabSettings {
+        float moveSpeed;
+        float rotSpeed;
+        bool leftThumbMove;
+    };
+
+    // a cube held by a controller, stored as an offset in the controller's space
+    // controllers are never scaled, so this matches Transform.InverseTransformPoint
+    struct Grab {
+        Math::Vec3 pos;
+        Math::Quat rot;
+
+        void begin(Pose const& controller, Pose const& cube);
+        // thumbstick movement and rotation of the held cube, from whichever controller was used last
+        void applyThumbsticks(float horizontal, float vertical, bool usedRight, GrabSettings const& settings, float cubeSize, float deltaTime);
+        Pose target(Pose const& controller) const;
+    };
+
+    // smoothly moves a held cube towards its target
+    Pose followGrab(Pose const& current, Pose const& target, float deltaTime);
+    // frame rate independent, closes 1 - e^(-deltaTime / smoothing) of the distance every frame, 0 follows exactly
+    Pose smoothGrab(Pose const& current, Pose const& target, float smoothing, float deltaTime);
+
+    // motion-to-update latency of a held cube: the age of the controller pose it was moved with,
+    // plus how far smoothing left it behind the target, as time at the target's current speed
+    class GrabLatency {
+        Math::Vec3 lastTarget;
+        bool hasLast = false;
+        float average = 0;
+
+        public:
+
+        void record(float poseAge, Math::Vec3 applied, Math::Vec3 target, float deltaTime);
+        // the next grab starts over, without a speed or an average
+        void reset() { hasLast = false; average = 0; }
+        // in seconds
+        float get() const { return average; }
+    };
+
+    // avoid moving underground
+    constexpr Math::Vec3 clampAboveFloor(Math::Vec3 pos) {
+        if(pos.y < 0)
+            pos.y = 0;
+        return pos;
+    }
+}
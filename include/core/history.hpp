@@ -0,0 +1,68 @@
+#pragma once
+
+#include "core/cubeinfo.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace Qubes {
+    // one step back through the layout, only the cubes a change touched and only their fields that changed
+    struct LayoutOp {
+        // Set puts fields back, Insert puts removed cubes back, Erase removes added ones
+        enum Kind : uint8_t { Set, Insert, Erase };
+        Kind kind = Set;
+        // in increasing order, for Insert they're where the cubes end up
+        std::vector<int> indices;
+        // each cube's changed fields, or all of them for Insert, see core/packing.hpp, nothing for Erase
+        std::vector<uint8_t> data;
+
+        // roughly what it keeps allocated
+        size_t bytes() const;
+    };
+
+    // what takes cubes that changed from before to after back, values are in the same order as indices
+    LayoutOp setOp(std::vector<int> const& indices, std::vector<CubeInfo> const& before, std::vector<CubeInfo> const& after);
+    // what brings back removed cubes
+    LayoutOp insertOp(std::vector<int> const& indices, std::vector<CubeInfo> const& removed);
+    // what removes added cubes
+    LayoutOp eraseOp(std::vector<int> indices);
+
+    // the cubes op leaves at its indices for Set and Insert, from the layout before it's applied
+    std::vector<CubeInfo> opValues(LayoutOp const& op, std::vector<CubeInfo> const& cubes);
+    // what takes applying op back, from the layout before it's applied
+    LayoutOp invertOp(LayoutOp const& op, std::vector<CubeInfo> const& cubes);
+
+    // undo and redo of layout ops, dropping the oldest once they take more memory than the limit
+    class History {
+        public:
+
+        void setLimit(size_t bytes);
+        // a new change, what was undone can't be redone after it
+        // a Set of the same cubes soon after the last one is merged into it, so dragging a slider is one step
+        void record(LayoutOp op);
+        // the op to apply, afterwards its inverse goes to the other side
+        std::optional<LayoutOp> takeUndo();
+        std::optional<LayoutOp> takeRedo();
+        void pushUndo(LayoutOp op);
+        void pushRedo(LayoutOp op);
+        void clear();
+
+        int undoCount() const { return undos.size(); }
+        int redoCount() const { return redos.size(); }
+        size_t memory() const { return used; }
+
+        static constexpr std::chrono::milliseconds MergeWindow{750};
+
+        private:
+
+        void evict();
+
+        std::deque<LayoutOp> undos, redos;
+        std::chrono::steady_clock::time_point lastRecord;
+        size_t used = 0;
+        size_t limit = 256 * 1024;
+    };
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "core/math.hpp"
+#include "shared/snapshot.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Qubes {
+    // what the layout browser shows, -1 for any
+    struct LayoutFilter {
+        int type = -1;
+        int hitAction = -1;
+        int locked = -1;
+        // hue in degrees, a range with min above max wraps around red
+        float hueMin = 0, hueMax = 360;
+        // 0 for any
+        float maxDistance = 0;
+        Math::Vec3 from;
+    };
+
+    // hue in degrees, grays are 0
+    float colorHue(Math::Color color);
+
+    // lookup tables over one snapshot's cubes, so a filter only looks at the cubes that can match it
+    class LayoutIndex {
+        public:
+
+        // does nothing if the snapshot's version was already built
+        void build(CubeSnapshot const& snapshot);
+        uint64_t version() const { return builtVersion; }
+        int size() const { return count; }
+
+        // cube indices that pass, in increasing order
+        void query(LayoutFilter const& filter, std::vector<int>& out) const;
+
+        private:
+
+        bool passes(int cube, LayoutFilter const& filter, float maxDistance2) const;
+        // cubes in increasing order with a hue in the range
+        void hueRange(float min, float max, std::vector<int>& out) const;
+
+        uint64_t builtVersion = 0;
+        int count = 0;
+        // cube indices for each value, in increasing order
+        std::vector<std::vector<int>> byType, byLocked;
+        // hit action ids of added actions are large, so only the ones in use
+        std::unordered_map<int, std::vector<int>> byHitAction;
+        // cube indices sorted by hue, and their hues
+        std::vector<int> hueOrder;
+        std::vector<float> sortedHues;
+
+        std::vector<float> posX, posY, posZ, hues;
+        std::vector<int> types, hitActions;
+        std::vector<uint8_t> locked;
+    };
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "core/qubesconfig.hpp"
+
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Qubes {
+    // the layout kept in the config file itself, the others are files in the layouts folder
+    constexpr const char* DefaultLayout = "Default";
+
+    // names become file names, so only printable characters without slashes or a leading dot
+    bool validLayoutName(std::string const& name);
+
+    enum class LayoutContext { Menu, Gameplay, Song, Playlist };
+
+    // which layout to show where, anything unbound falls back to the default layout
+    struct LayoutBindings {
+        std::string menu = DefaultLayout;
+        std::string gameplay = DefaultLayout;
+        // by level id and by playlist name
+        std::unordered_map<std::string, std::string> songs, playlists;
+
+        // a song's layout wins over its playlist's, which wins over the one for all levels
+        std::string const& resolve(bool gameplay, std::string const& song, std::string const& playlist) const;
+        // key is the level id or playlist name, binding those to the default layout removes them
+        void bind(LayoutContext context, std::string const& key, std::string const& layout);
+        // anything bound to the layout goes back to the default, for deleting it
+        void unbind(std::string const& layout);
+
+        void Load(rapidjson::Value const& obj);
+        rapidjson::Value ToJSON(rapidjson::Document::AllocatorType& allocator) const;
+    };
+
+    // a layout in its own file, as an object with a "qubes" array like the config's
+    class LayoutFile : public ConfigStorage {
+        public:
+        LayoutFile(std::string path) : path(std::move(path)) { doc.SetObject(); }
+
+        rapidjson::Document& GetDocument() override { return doc; }
+        // replaces the document with the file's, json or packed by qubes-cli, error gets why if it returns false
+        bool Read(std::string* error = nullptr);
+        // through a temporary file, so a crash while writing can't leave half a layout
+        void Write() override;
+        std::string const& getPath() const { return path; }
+
+        private:
+        std::string path;
+        rapidjson::Document doc;
+    };
+
+    // a layout read from disk, with its cubes ready for diffing against the shown ones
+    struct LoadedLayout {
+        std::string name;
+        std::unique_ptr<LayoutFile> file;
+        std::vector<CubeInfo> cubes;
+        // empty if it loaded
+        std::string error;
+    };
+    std::string layoutPath(std::string const& folder, std::string const& name);
+    LoadedLayout loadLayout(std::string const& folder, std::string const& name);
+
+    // reads the layout that's likely needed next on a worker thread, so switching to it doesn't wait for the disk
+    // only one is kept, prefetching another drops it
+    class LayoutLoader {
+        public:
+
+        LayoutLoader(std::string folder) : folder(std::move(folder)) {}
+
+        // does nothing if it's already the one being read
+        void prefetch(std::string const& name);
+        // the prefetched layout if it's this one, waiting for it if it's still being read, otherwise reads it now
+        LoadedLayout take(std::string const& name);
+        // after the file changed, so a prefetched copy of it isn't used
+        void forget(std::string const& name);
+        std::string const& getFolder() const { return folder; }
+
+        private:
+
+        std::string folder;
+        std::string pendingName;
+        std::future<LoadedLayout> pending;
+    };
+}
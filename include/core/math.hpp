@@ -0,0 +1,314 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <concepts>
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define QUBES_MATH_NEON
+#endif
+
+// inline replacements for the unity vector math we use every frame, so it never goes through il2cpp
+// the types match the memory layout of UnityEngine::Vector3, Quaternion and Color and convert to and from them implicitly
+namespace Qubes::Math {
+    constexpr float PI = 3.14159265358979f;
+    constexpr float Deg2Rad = PI / 180;
+    constexpr float Rad2Deg = 180 / PI;
+
+    constexpr float abs(float value) { return value < 0 ? -value : value; }
+    constexpr float clamp01(float value) { return value < 0 ? 0 : (value > 1 ? 1 : value); }
+    inline float atan2(float y, float x) { return std::atan2(y, x); }
+
+    template<class T>
+    concept Vector3Like = sizeof(T) == 3 * sizeof(float) && requires(T const& v) {
+        { v.x } -> std::convertible_to<float>;
+        { v.y } -> std::convertible_to<float>;
+        { v.z } -> std::convertible_to<float>;
+    };
+    template<class T>
+    concept ColorLike = sizeof(T) == 4 * sizeof(float) && requires(T const& c) {
+        { c.r } -> std::convertible_to<float>;
+        { c.g } -> std::convertible_to<float>;
+        { c.b } -> std::convertible_to<float>;
+        { c.a } -> std::convertible_to<float>;
+    };
+    template<class T>
+    concept QuaternionLike = sizeof(T) == 4 * sizeof(float) && requires(T const& v) {
+        { v.x } -> std::convertible_to<float>;
+        { v.y } -> std::convertible_to<float>;
+        { v.z } -> std::convertible_to<float>;
+        { v.w } -> std::convertible_to<float>;
+    };
+
+    struct Vec3 {
+        float x, y, z;
+
+        constexpr Vec3() : x(0), y(0), z(0) {}
+        constexpr Vec3(float x, float y, float z) : x(x), y(y), z(z) {}
+        template<Vector3Like T>
+        constexpr Vec3(T const& v) : x(v.x), y(v.y), z(v.z) {}
+        template<Vector3Like T>
+        constexpr operator T() const { return T(x, y, z); }
+
+        static constexpr Vec3 zero() { return {0, 0, 0}; }
+        static constexpr Vec3 up() { return {0, 1, 0}; }
+        static constexpr Vec3 forward() { return {0, 0, 1}; }
+        static constexpr Vec3 right() { return {1, 0, 0}; }
+
+        constexpr Vec3 operator+(Vec3 const& o) const { return {x + o.x, y + o.y, z + o.z}; }
+        constexpr Vec3 operator-(Vec3 const& o) const { return {x - o.x, y - o.y, z - o.z}; }
+        constexpr Vec3 operator-() const { return {-x, -y, -z}; }
+        constexpr Vec3 operator*(float s) const { return {x * s, y * s, z * s}; }
+        constexpr Vec3 operator/(float s) const { return {x / s, y / s, z / s}; }
+        constexpr Vec3& operator+=(Vec3 const& o) { x += o.x; y += o.y; z += o.z; return *this; }
+        constexpr Vec3& operator-=(Vec3 const& o) { x -= o.x; y -= o.y; z -= o.z; return *this; }
+        constexpr Vec3& operator*=(float s) { x *= s; y *= s; z *= s; return *this; }
+        constexpr bool operator==(Vec3 const& o) const = default;
+    };
+    constexpr Vec3 operator*(float s, Vec3 const& v) { return v * s; }
+
+    constexpr float dot(Vec3 const& a, Vec3 const& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    constexpr Vec3 cross(Vec3 const& a, Vec3 const& b) {
+        return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+    }
+    constexpr float sqrMagnitude(Vec3 const& v) { return dot(v, v); }
+    inline float magnitude(Vec3 const& v) { return std::sqrt(dot(v, v)); }
+    inline Vec3 normalized(Vec3 const& v) {
+        float mag = magnitude(v);
+        // same cutoff as unity
+        return mag > 1e-5f ? v / mag : Vec3::zero();
+    }
+    // t is clamped to [0, 1] like Vector3.Lerp
+    constexpr Vec3 lerp(Vec3 const& a, Vec3 const& b, float t) {
+        t = clamp01(t);
+        return a + (b - a) * t;
+    }
+
+    struct Quat {
+        float x, y, z, w;
+
+        constexpr Quat() : x(0), y(0), z(0), w(1) {}
+        constexpr Quat(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+        template<QuaternionLike T>
+        constexpr Quat(T const& q) : x(q.x), y(q.y), z(q.z), w(q.w) {}
+        template<QuaternionLike T>
+        constexpr operator T() const { return T(x, y, z, w); }
+
+        static constexpr Quat identity() { return {0, 0, 0, 1}; }
+
+        constexpr bool operator==(Quat const& o) const = default;
+    };
+
+    inline Quat operator*(Quat const& a, Quat const& b) {
+#ifdef QUBES_MATH_NEON
+        float32x4_t r = vmulq_n_f32(vld1q_f32(&b.x), a.w);
+        r = vmlaq_n_f32(r, float32x4_t{b.w, -b.z, b.y, -b.x}, a.x);
+        r = vmlaq_n_f32(r, float32x4_t{b.z, b.w, -b.x, -b.y}, a.y);
+        r = vmlaq_n_f32(r, float32x4_t{-b.y, b.x, b.w, -b.z}, a.z);
+        Quat ret;
+        vst1q_f32(&ret.x, r);
+        return ret;
+#else
+        return {
+            a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+            a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+            a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+        };
+#endif
+    }
+
+    // rotates a vector, same as Quaternion * Vector3
+    constexpr Vec3 operator*(Quat const& q, Vec3 const& v) {
+        Vec3 u = {q.x, q.y, q.z};
+        Vec3 t = cross(u, v) * 2;
+        return v + t * q.w + cross(u, t);
+    }
+
+    inline float dot(Quat const& a, Quat const& b) {
+#ifdef QUBES_MATH_NEON
+        return vaddvq_f32(vmulq_f32(vld1q_f32(&a.x), vld1q_f32(&b.x)));
+#else
+        return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+#endif
+    }
+
+    inline Quat normalized(Quat const& q) {
+        float mag = std::sqrt(dot(q, q));
+        if(mag < 1e-5f)
+            return Quat::identity();
+        return {q.x / mag, q.y / mag, q.z / mag, q.w / mag};
+    }
+
+    inline Quat inverse(Quat const& q) {
+        float sqr = dot(q, q);
+        return {-q.x / sqr, -q.y / sqr, -q.z / sqr, q.w / sqr};
+    }
+
+    // angle in degrees, like Quaternion.AngleAxis
+    inline Quat angleAxis(float angle, Vec3 const& axis) {
+        Vec3 n = normalized(axis);
+        float half = angle * Deg2Rad * 0.5f;
+        float s = std::sin(half);
+        return {n.x * s, n.y * s, n.z * s, std::cos(half)};
+    }
+
+    // degrees, applied around z, then x, then y like Quaternion.Euler
+    inline Quat euler(float x, float y, float z) {
+        float hx = x * Deg2Rad * 0.5f, hy = y * Deg2Rad * 0.5f, hz = z * Deg2Rad * 0.5f;
+        float sx = std::sin(hx), cx = std::cos(hx);
+        float sy = std::sin(hy), cy = std::cos(hy);
+        float sz = std::sin(hz), cz = std::cos(hz);
+        return {
+            cy * sx * cz + sy * cx * sz,
+            sy * cx * cz - cy * sx * sz,
+            cy * cx * sz - sy * sx * cz,
+            cy * cx * cz + sy * sx * sz
+        };
+    }
+    inline Quat euler(Vec3 const& angles) { return euler(angles.x, angles.y, angles.z); }
+
+    // like Quaternion.LookRotation, up only has to be roughly perpendicular to forward
+    inline Quat lookRotation(Vec3 const& forward, Vec3 const& up = Vec3::up()) {
+        Vec3 z = normalized(forward);
+        Vec3 x = normalized(cross(up, z));
+        if(sqrMagnitude(x) == 0)
+            return Quat::identity();
+        Vec3 y = cross(z, x);
+        // rotation matrix with x, y and z as columns to a quaternion
+        float trace = x.x + y.y + z.z;
+        if(trace > 0) {
+            float s = std::sqrt(trace + 1) * 2;
+            return {(y.z - z.y) / s, (z.x - x.z) / s, (x.y - y.x) / s, s / 4};
+        } else if(x.x > y.y && x.x > z.z) {
+            float s = std::sqrt(1 + x.x - y.y - z.z) * 2;
+            return {s / 4, (y.x + x.y) / s, (z.x + x.z) / s, (y.z - z.y) / s};
+        } else if(y.y > z.z) {
+            float s = std::sqrt(1 + y.y - x.x - z.z) * 2;
+            return {(y.x + x.y) / s, s / 4, (z.y + y.z) / s, (z.x - x.z) / s};
+        }
+        float s = std::sqrt(1 + z.z - x.x - y.y) * 2;
+        return {(z.x + x.z) / s, (z.y + y.z) / s, s / 4, (x.y - y.x) / s};
+    }
+
+    // t is clamped to [0, 1] and the shortest path is taken, like Quaternion.Slerp
+    inline Quat slerp(Quat const& a, Quat b, float t) {
+        t = clamp01(t);
+        float cosAngle = dot(a, b);
+        if(cosAngle < 0) {
+            b = {-b.x, -b.y, -b.z, -b.w};
+            cosAngle = -cosAngle;
+        }
+        float wa, wb;
+        // nearly parallel, avoid dividing by a tiny sine
+        if(cosAngle > 0.9995f) {
+            wa = 1 - t;
+            wb = t;
+        } else {
+            float angle = std::acos(cosAngle);
+            float invSin = 1 / std::sin(angle);
+            wa = std::sin((1 - t) * angle) * invSin;
+            wb = std::sin(t * angle) * invSin;
+        }
+#ifdef QUBES_MATH_NEON
+        float32x4_t r = vmulq_n_f32(vld1q_f32(&a.x), wa);
+        r = vmlaq_n_f32(r, vld1q_f32(&b.x), wb);
+        Quat ret;
+        vst1q_f32(&ret.x, r);
+        return normalized(ret);
+#else
+        return normalized({a.x * wa + b.x * wb, a.y * wa + b.y * wb, a.z * wa + b.z * wb, a.w * wa + b.w * wb});
+#endif
+    }
+
+    struct Color {
+        float r, g, b, a;
+
+        constexpr Color() : r(0), g(0), b(0), a(1) {}
+        constexpr Color(float r, float g, float b, float a = 1) : r(r), g(g), b(b), a(a) {}
+        template<ColorLike T>
+        constexpr Color(T const& c) : r(c.r), g(c.g), b(c.b), a(c.a) {}
+        template<ColorLike T>
+        constexpr operator T() const { return T(r, g, b, a); }
+
+        constexpr bool operator==(Color const& o) const = default;
+    };
+
+    // view frustum as six planes facing inwards, for culling without the engine
+    struct Frustum {
+        // normal and distance of each plane, normals are unit length
+        float planes[6][4];
+
+        // from a row major projection * view matrix like Camera.cullingMatrix
+        static Frustum fromMatrix(float const (&m)[4][4]) {
+            Frustum frustum;
+            for(int i = 0; i < 6; i++) {
+                // left, right, bottom, top, near, far
+                int row = i / 2;
+                float sign = i % 2 ? -1 : 1;
+                float* plane = frustum.planes[i];
+                for(int j = 0; j < 4; j++)
+                    plane[j] = m[3][j] + sign * m[row][j];
+                float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+                for(int j = 0; j < 4; j++)
+                    plane[j] /= length;
+            }
+            return frustum;
+        }
+
+        bool sphereVisible(Vec3 const& center, float radius) const {
+            for(auto& plane : planes) {
+                if(plane[0] * center.x + plane[1] * center.y + plane[2] * center.z + plane[3] < -radius)
+                    return false;
+            }
+            return true;
+        }
+    };
+
+    // small xoshiro128+ generator, only used for visual randomness
+    class Random {
+        uint32_t s[4];
+
+        static constexpr uint32_t rotl(uint32_t x, int k) { return (x << k) | (x >> (32 - k)); }
+
+        public:
+
+        constexpr Random(uint64_t seed = 0x9E3779B97F4A7C15ull) : s{} {
+            // splitmix64 to spread the seed over the state
+            for(int i = 0; i < 4; i += 2) {
+                seed += 0x9E3779B97F4A7C15ull;
+                uint64_t z = seed;
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                z = z ^ (z >> 31);
+                s[i] = (uint32_t) z;
+                s[i + 1] = (uint32_t) (z >> 32);
+            }
+        }
+
+        constexpr uint32_t next() {
+            uint32_t result = s[0] + s[3];
+            uint32_t t = s[1] << 9;
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = rotl(s[3], 11);
+            return result;
+        }
+
+        // [0, 1)
+        constexpr float value() { return (next() >> 8) * (1.0f / 16777216.0f); }
+        constexpr float range(float min, float max) { return min + (max - min) * value(); }
+
+        inline Vec3 onUnitSphere() {
+            float z = range(-1, 1);
+            float angle = range(0, 2 * PI);
+            float r = std::sqrt(1 - z * z);
+            return {r * std::cos(angle), r * std::sin(angle), z};
+        }
+        inline Vec3 insideUnitSphere() { return onUnitSphere() * std::cbrt(value()); }
+    };
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "rapidjson/document.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// estimates of what the mod keeps resident, native and managed together
+// unity has no way to measure objects in release builds, so cloned objects use fixed costs measured in the editor
+namespace Qubes::Memory {
+    enum Subsystem { Cubes, Menus, Debris, ConfigDom, Sprites, SubsystemCount };
+    extern const char* const subsystemNames[SubsystemCount];
+
+    struct Costs {
+        // cloned note hierarchy with its renderers, collider and cuttable
+        uint32_t cube = 8 * 1024;
+        // private copy made by get_material
+        uint32_t material = 1536;
+        // entry in the cut hook's hitbox map
+        uint32_t cutTarget = 32;
+        // edit menu canvas with its settings and text meshes, without sprites
+        uint32_t menu = 96 * 1024;
+        uint32_t debris = 12 * 1024;
+    };
+
+    struct Counts {
+        // cube objects, including hidden pooled ones and the preview, which all take memory
+        int cubes;
+        // cubes in the shown layout, which the cube limit counts
+        int layoutCubes;
+        int menus, debris;
+        uint64_t spriteBytes, configDomBytes;
+    };
+
+    struct Report {
+        uint64_t bytes[SubsystemCount];
+        uint64_t total;
+        // one cube with its config entry, without a menu
+        uint64_t perCube;
+        // cubes in the shown layout
+        int cubes;
+    };
+    Report estimate(Counts const& counts, Costs const& costs = {});
+
+    // heap used by a json value and everything in it, for rapidjson's pool allocator
+    uint64_t jsonBytes(rapidjson::Value const& value);
+    // size of a png once decoded to an rgba32 texture, 0 if it isn't a png
+    uint64_t pngTextureBytes(const uint8_t* data, size_t length);
+
+    // "1.5 MB" and so on
+    std::string formatBytes(uint64_t bytes);
+
+    // 0 for no limit
+    struct Limits {
+        int maxCubes;
+        uint64_t maxBytes;
+    };
+    // why another cube would go over the limits, empty if it wouldn't
+    std::string refuseCube(Report const& report, Limits const& limits);
+    // how many more cubes the limits allow, INT_MAX without any
+    int cubeAllowance(Report const& report, Limits const& limits);
+}
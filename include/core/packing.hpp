@@ -0,0 +1,27 @@
+#pragma once
+
+#include "core/cubeinfo.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// cubes as bytes, for undo steps and binary layout files
+// each cube is a field mask and then only the fields in it, in the byte order of the device
+namespace Qubes::Packing {
+    enum Field : uint8_t { Pose = 1, Color = 2, Type = 4, HitAction = 8, Size = 16, Locked = 32, Motion = 64, All = 127 };
+
+    // the fields that differ between a and b
+    uint8_t changedFields(CubeInfo const& a, CubeInfo const& b);
+    void pack(std::vector<uint8_t>& data, CubeInfo const& cube, uint8_t mask);
+    // only overwrites the fields in the mask, returns the mask or -1 if it would read past end
+    int unpack(const uint8_t*& at, const uint8_t* end, CubeInfo& cube);
+
+    // every cube array in a config or layout document, other members and arrays with anything but valid cubes aren't kept
+    // a few times smaller than the json and read without parsing text
+    std::vector<uint8_t> packDocument(rapidjson::Document& doc);
+    // replaces doc with the cube arrays in data, error gets what was wrong if it returns false
+    bool unpackDocument(const uint8_t* data, size_t size, rapidjson::Document& doc, std::string* error = nullptr);
+    // whether data starts like a packed document rather than json
+    bool isPacked(const uint8_t* data, size_t size);
+}
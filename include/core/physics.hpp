@@ -0,0 +1,73 @@
+#pragma once
+
+#include "core/grab.hpp"
+
+#include <vector>
+
+namespace Qubes {
+    // slower than this when let go is just putting a cube down, in m/s
+    constexpr float ThrowSpeed = 0.5;
+
+    struct PhysicsSettings {
+        // m/s^2, 0 leaves thrown cubes floating
+        float gravity = 0;
+        // fraction of velocity lost per second, as exp(-damping * t)
+        float linearDamping = 0.8;
+        float angularDamping = 1.5;
+        // speed kept when bouncing off the floor, and how fast sliding on it stops
+        float restitution = 0.35;
+        float floorFriction = 4;
+        // slower than these for restTime counts as resting
+        float restSpeed = 0.03;
+        float restAngularSpeed = 0.1;
+        float restTime = 0.25;
+        // fixed timestep, a slow frame runs at most maxSteps of them
+        float step = 1 / 120.0f;
+        int maxSteps = 8;
+    };
+
+    // velocity of a held cube over its last few frames, for throwing it on release
+    class ThrowTracker {
+        static constexpr int Samples = 6;
+        Pose poses[Samples];
+        float times[Samples];
+        int count = 0, next = 0;
+
+        public:
+
+        void reset() { count = next = 0; }
+        void push(Pose const& pose, float deltaTime);
+        Math::Vec3 velocity() const;
+        // world space, radians per second
+        Math::Vec3 angularVelocity() const;
+    };
+
+    // cubes in flight as a structure of arrays, stepped together with a fixed timestep
+    // cubes leave it once they come to rest, so only moving ones cost anything
+    class PhysicsBatch {
+        public:
+
+        // half is half the cube's width, the floor is at y = 0
+        int add(Pose const& pose, Math::Vec3 velocity, Math::Vec3 angularVelocity, float half);
+        // moves the last slot into this one, returns the slot that moved or -1 if it was this one
+        int remove(int slot);
+        int size() const { return posX.size(); }
+
+        // rested gets the slots that came to rest, in increasing order, so remove them from the back
+        void step(float deltaTime, PhysicsSettings const& settings, std::vector<int>& rested);
+        Pose getPose(int slot) const {
+            return {{posX[slot], posY[slot], posZ[slot]}, {rotX[slot], rotY[slot], rotZ[slot], rotW[slot]}};
+        }
+
+        private:
+
+        void integrate(PhysicsSettings const& settings);
+
+        // left over from the last frame, less than one step
+        float accumulator = 0;
+
+        std::vector<float> posX, posY, posZ, velX, velY, velZ;
+        std::vector<float> rotX, rotY, rotZ, rotW, angX, angY, angZ;
+        std::vector<float> half, resting;
+    };
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "core/cubeinfo.hpp"
+#include "core/history.hpp"
+#include "core/snapshot.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Qubes {
+    // whatever owns the json document the cube arrays are stored in, so that this doesn't need config-utils
+    class ConfigStorage {
+        public:
+        virtual ~ConfigStorage() = default;
+        virtual rapidjson::Document& GetDocument() = 0;
+        virtual void Write() = 0;
+    };
+
+    // moves cubes from the old single "cubes" array, returns whether anything changed
+    bool migrateDocument(rapidjson::Document& doc);
+
+    struct QubesConfig {
+        ConfigStorage* storage = nullptr;
+
+        std::vector<CubeInfo> cubes;
+        std::vector<CubeInfo> defCubes;
+        std::string name;
+        // cubes as of the last change, for other threads, shared by copies of the config
+        std::shared_ptr<SnapshotPublisher> snapshots = std::make_shared<SnapshotPublisher>();
+        // where changes to single cubes are recorded for undo, if anywhere
+        History* history = nullptr;
+
+        QubesConfig(std::string arrname, std::vector<CubeInfo> initCubes = {}) { name = arrname; defCubes = initCubes; }
+        void Init(ConfigStorage* cfg);
+
+        void LoadValue();
+        void SetValue();
+        void SetCubeValue(int index, CubeInfo value);
+        // many cubes at once with a single write, values are in the same order as indices
+        void SetCubeValues(std::vector<int> const& indices, std::vector<CubeInfo> const& values);
+        void AddCube(CubeInfo cube);
+        // to the end with a single write
+        void AddCubes(std::vector<CubeInfo> const& added);
+        void RemoveCube(int index);
+        // indices in increasing order, later cubes move down like with RemoveCube
+        void RemoveCubes(std::vector<int> const& indices);
+        // indices in increasing order are where the values end up, later cubes move up
+        void InsertCubes(std::vector<int> const& indices, std::vector<CubeInfo> const& values);
+    };
+}
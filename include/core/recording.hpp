@@ -0,0 +1,34 @@
+#pragma once
+
+#include "core/math.hpp"
+
+#include <string>
+#include <vector>
+
+namespace Qubes {
+    // one frame of controller input, as seen by the main thread dispatcher
+    // written to disk as is, so the layout must not change without bumping RecordingVersion
+    struct InputFrame {
+        float deltaTime;
+        // the pointer's controller
+        Math::Vec3 pos;
+        Math::Quat rot;
+        float trigger;
+        float horizontal;
+        float vertical;
+        // held buttons, bit i for button i on the left controller and bit i + 4 on the right
+        uint8_t buttons;
+        uint8_t lastUsedRight;
+        uint8_t padding[2];
+
+        bool held(int button, bool right) const { return buttons & (1 << (button + (right ? 4 : 0))); }
+        void setHeld(int button, bool right) { buttons |= 1 << (button + (right ? 4 : 0)); }
+    };
+    static_assert(sizeof(InputFrame) == 48);
+
+    constexpr uint32_t RecordingVersion = 1;
+
+    // file is a "QREC" magic, the version and frame count, then the raw frames
+    bool writeRecording(std::string const& path, std::vector<InputFrame> const& frames);
+    bool readRecording(std::string const& path, std::vector<InputFrame>& frames);
+}
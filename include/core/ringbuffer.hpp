@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Qubes {
+    // bounded lock-free queue for any number of producers and consumers
+    // every slot has a sequence number telling whether it is free to write or ready to read, so nothing ever waits on a lock
+    // the data is filled and consumed in place through callbacks, which avoids copying large entries
+    template<class T, size_t Capacity>
+    class RingBuffer {
+        static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+        struct Cell {
+            std::atomic<size_t> sequence;
+            T data;
+        };
+
+        Cell cells[Capacity];
+        alignas(64) std::atomic<size_t> enqueuePos = 0;
+        alignas(64) std::atomic<size_t> dequeuePos = 0;
+        std::atomic<size_t> dropped = 0;
+
+        public:
+
+        RingBuffer() {
+            for(size_t i = 0; i < Capacity; i++)
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        // returns false and counts a drop if the queue is full
+        template<class F>
+        bool tryPush(F&& fill) {
+            size_t pos = enqueuePos.load(std::memory_order_relaxed);
+            while(true) {
+                Cell& cell = cells[pos & (Capacity - 1)];
+                size_t seq = cell.sequence.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+                if(diff == 0) {
+                    if(enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        fill(cell.data);
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if(diff < 0) {
+                    dropped.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                } else
+                    pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        // returns false if the queue is empty
+        template<class F>
+        bool tryPop(F&& consume) {
+            size_t pos = dequeuePos.load(std::memory_order_relaxed);
+            while(true) {
+                Cell& cell = cells[pos & (Capacity - 1)];
+                size_t seq = cell.sequence.load(std::memory_order_acquire);
+                intptr_t diff = (intptr_t) seq - (intptr_t) (pos + 1);
+                if(diff == 0) {
+                    if(dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        consume(cell.data);
+                        cell.sequence.store(pos + Capacity, std::memory_order_release);
+                        return true;
+                    }
+                } else if(diff < 0)
+                    return false;
+                else
+                    pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        // number of pushes that failed because the queue was full, resets the count
+        size_t takeDropped() { return dropped.exchange(0, std::memory_order_relaxed); }
+    };
+}
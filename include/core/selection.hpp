@@ -0,0 +1,53 @@
+#pragma once
+
+#include "core/cubeinfo.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace Qubes {
+    // selected cubes by index, one bit each
+    class Selection {
+        public:
+
+        // bits past the end are read as unselected, setting one grows it
+        bool test(int index) const { return index < bits && (words[index >> 6] >> (index & 63)) & 1; }
+        void set(int index, bool selected = true);
+        void clear();
+        bool empty() const;
+        int count() const;
+
+        // in increasing order
+        void indices(std::vector<int>& out) const;
+        // after the cube was removed, the ones after it move down by one
+        void erase(int index);
+
+        private:
+
+        std::vector<uint64_t> words;
+        int bits = 0;
+    };
+
+    // cubes with their saved position inside the box spanned by two corners, grown by pad on every side
+    void selectBox(std::vector<CubeInfo> const& cubes, Math::Vec3 a, Math::Vec3 b, float pad, Selection& selection);
+    Math::Vec3 selectionCenter(std::vector<CubeInfo> const& cubes, std::vector<int> const& indices);
+
+    // one change to every selected cube, only the fields in the mask are touched
+    struct BulkEdit {
+        enum Field : uint8_t { Color = 1, Size = 2, Type = 4, HitAction = 8, Locked = 16, Move = 32, Rotate = 64 };
+        uint8_t fields = 0;
+
+        Math::Color color;
+        float size = 1;
+        int type = 0;
+        int hitAction = 0;
+        bool locked = false;
+        // world space
+        Math::Vec3 offset;
+        // turns the group around pivot, so their positions move as well as their rotations
+        Math::Quat rotation;
+        Math::Vec3 pivot;
+
+        void apply(CubeInfo& cube) const;
+    };
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "core/cubeinfo.hpp"
+#include "shared/snapshot.hpp"
+
+#include <atomic>
+#include <vector>
+
+namespace Qubes {
+    // the latest cube array of a config, published by one writer and read by any thread without locks
+    // readers take a reference with acquire and give it back with release, the writer never waits for them
+    class SnapshotPublisher {
+        public:
+
+        SnapshotPublisher();
+        ~SnapshotPublisher();
+        SnapshotPublisher(SnapshotPublisher const&) = delete;
+        SnapshotPublisher& operator=(SnapshotPublisher const&) = delete;
+
+        // writer only, copies the cubes into a new snapshot and swaps it in
+        void publish(std::vector<CubeInfo> const& cubes);
+
+        // any thread, never null, stays valid until released
+        CubeSnapshot const* acquire() const;
+        static void release(CubeSnapshot const* snapshot);
+        // the cubes the records were made from, with everything the records leave out
+        static std::vector<CubeInfo> const& cubeInfos(CubeSnapshot const* snapshot);
+
+        // writer only, snapshots replaced while a reader was in acquire that aren't freed yet
+        int retiredCount() const { return retired.size(); }
+
+        private:
+
+        struct Published;
+        // drops the publisher's reference to replaced snapshots once no acquire could still be reading them
+        void collect();
+
+        std::atomic<Published*> current;
+        // readers between loading current and taking their reference
+        mutable std::atomic<int> acquiring;
+        std::vector<Published*> retired;
+        uint64_t version = 0;
+    };
+}
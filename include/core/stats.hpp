@@ -0,0 +1,71 @@
+#pragma once
+
+#include "core/trace.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// live counters for the performance overlay, updated from the hooks and only read a few times a second
+namespace Qubes::Stats {
+    extern std::atomic<int> activeCubes, debrisAlive, coroutines, menus;
+    // cubes drawn from combined meshes, they have no behaviour running so activeCubes leaves them out
+    extern std::atomic<int> staticCubes;
+    // every cube object, active or not
+    extern std::atomic<int> cubes;
+    // decoded size of every sprite made, they are never destroyed
+    extern std::atomic<uint64_t> spriteBytes;
+    // smoothed motion-to-update latency of grabbed cubes
+    extern std::atomic<uint32_t> grabLatencyMicros;
+    // config writes are synchronous, so this counts them rather than what is waiting
+    extern std::atomic<int> configWrites;
+
+    // frame time is only measured while something shows it
+    extern std::atomic<bool> timing;
+    extern std::atomic<uint64_t> frameNanos;
+
+    // counts something for as long as it lives, which also works across co_yield
+    class Scoped {
+        std::atomic<int>& counter;
+
+        public:
+
+        Scoped(std::atomic<int>& counter) : counter(counter) { counter.fetch_add(1, std::memory_order_relaxed); }
+        ~Scoped() { counter.fetch_sub(1, std::memory_order_relaxed); }
+        Scoped(Scoped const&) = delete;
+        Scoped& operator=(Scoped const&) = delete;
+    };
+
+    // adds the time it lives to the mod cpu time of the current frame, don't nest them
+    class FrameTimer {
+        uint64_t start;
+
+        public:
+
+        FrameTimer() : start(timing.load(std::memory_order_relaxed) ? Trace::now() : 0) {}
+        ~FrameTimer() {
+            if(start)
+                frameNanos.fetch_add(Trace::now() - start, std::memory_order_relaxed);
+        }
+    };
+
+    // the last frame times, only touched from the main thread
+    class FrameTimes {
+        static constexpr int Size = 256;
+        std::array<uint32_t, Size> times = {};
+        int count = 0, next = 0;
+
+        public:
+
+        void push(uint64_t nanos);
+        void clear() { count = next = 0; }
+        // p in [0, 1], in nanoseconds
+        uint32_t percentile(float p) const;
+    };
+
+    extern FrameTimes frames;
+    // call once per frame, moves the accumulated time into frames
+    void endFrame();
+}
+
+#define FRAME_TIMER() Qubes::Stats::FrameTimer TRACE_CONCAT(frameTimer, __LINE__)
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "core/math.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace Qubes {
+    // oriented box, half is the half size along each local axis
+    struct OBB {
+        Math::Vec3 center;
+        Math::Quat rot;
+        Math::Vec3 half;
+    };
+
+    // where a saber blade was last frame and is now
+    struct BladeSweep {
+        Math::Vec3 prevBottom, prevTop;
+        Math::Vec3 bottom, top;
+    };
+
+    // arguments for handleCut, in the same form the game passes them
+    struct SweepHit {
+        int id;
+        Math::Vec3 cutPoint;
+        // up is the cut plane normal
+        Math::Quat orientation;
+        Math::Vec3 cutDirVec;
+    };
+
+    // the cut the game would report for a box the blade passed through at fraction t along its length
+    SweepHit makeHit(int id, OBB const& box, BladeSweep const& blade, float t);
+
+    // bvh over oriented boxes, tested against blade sweeps four boxes at a time
+    class SweepBVH {
+        struct Node {
+            Math::Vec3 min, max;
+            // leaves have a count of 1 and first is their packet
+            // inner nodes have first as the left child and minus the right child as count
+            int first, count;
+        };
+        // four boxes in structure of arrays, as world to local transforms
+        struct Packet {
+            float cx[4], cy[4], cz[4];
+            float m[9][4];
+            float hx[4], hy[4], hz[4];
+            int id[4];
+        };
+
+        std::vector<Node> nodes;
+        std::vector<Packet> packets;
+        std::vector<OBB> boxes;
+        // for refitting, children always come after their parent
+        std::vector<int> parents;
+        // packet * 4 + lane of each box, and the leaf of each packet
+        std::vector<int> slots;
+        std::vector<int> packetNodes;
+        std::vector<uint8_t> stale;
+
+        int buildNode(std::vector<int>& order, int begin, int end, int parent, std::vector<Math::Vec3> const& centers, std::vector<Math::Vec3> const& extents);
+        void setLane(Packet& packet, int lane, int id);
+
+        public:
+
+        // ids are indices into boxes
+        void build(std::vector<OBB> const& boxes);
+        void clear();
+        int size() const { return boxes.size(); }
+
+        // moves one box without rebuilding, call refit before the next sweep
+        // the tree isn't rebalanced, so boxes that travel far make sweeps slower until the next build
+        void update(int id, OBB const& box);
+        // recomputes the bounds of the nodes above updated boxes
+        void refit();
+
+        // every box the blade passed through, once each
+        // nothing for a blade that jumped further than a swing can move in a frame, or isn't finite
+        // tested as blade positions spaced by half of each box's thinnest side, so small boxes only cost more where they are
+        void sweep(BladeSweep const& blade, std::vector<SweepHit>& hits) const;
+    };
+}
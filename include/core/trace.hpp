@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// scoped timing zones written as chrome trace events, which perfetto and chrome://tracing can open
+// a disabled zone costs one relaxed load, define QUBES_NO_TRACING to compile them out completely
+namespace Qubes::Trace {
+    extern std::atomic<bool> enabled;
+
+    uint64_t now();
+    void record(const char* name, uint64_t start, uint64_t end);
+
+    // starts buffering events without a file, so tracing can cover startup before the config says whether it is wanted
+    void buffer();
+    // starts writing to path on a background thread, including anything buffered
+    bool start(std::string const& path);
+    // stops and finishes the file, or drops buffered events if there was none
+    void stop();
+    bool running();
+
+    class Zone {
+        const char* name;
+        uint64_t start;
+
+        public:
+
+        Zone(const char* name) : name(name), start(enabled.load(std::memory_order_relaxed) ? now() : 0) {}
+        ~Zone() {
+            if(start)
+                record(name, start, now());
+        }
+    };
+}
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#ifndef QUBES_NO_TRACING
+// name must be a string literal or otherwise live forever
+#define TRACE_ZONE(name) Qubes::Trace::Zone TRACE_CONCAT(traceZone, __LINE__)(name)
+#else
+#define TRACE_ZONE(name) ((void) 0)
+#endif
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "modconfig.hpp"
+#include "core/math.hpp"
+#include "core/grab.hpp"
+#include "core/physics.hpp"
+#include "core/sweep.hpp"
 
 #include "custom-types/shared/coroutine.hpp"
 
@@ -15,13 +19,21 @@
 
 namespace QuestUI{ class IncrementSetting; }
 
+namespace Qubes {
+    // sibling indices of the children of the baked cube prototype, found by name once
+    struct CubeParts {
+        int arrow, arrowGlow, circleGlow, cuttable;
+    };
+}
+
 DECLARE_CLASS_CODEGEN(Qubes, EditMenu, UnityEngine::MonoBehaviour,
     DECLARE_INSTANCE_METHOD(void, LateUpdate);
+    DECLARE_INSTANCE_METHOD(void, OnDestroy);
 
     public:
 
     void init(Qubes::DefaultCube* cube);
-    QuestUI::IncrementSetting *typeInc, *eventInc;
+    QuestUI::IncrementSetting *typeInc, *eventInc, *motionInc;
     UnityEngine::UI::VerticalLayoutGroup *valVertical, *colVertical;
     UnityEngine::UI::Button *closeButton, *lockButton;
     GlobalNamespace::ColorPickerButtonController* colButtonController;
@@ -30,19 +42,27 @@ DECLARE_CLASS_CODEGEN(Qubes, EditMenu, UnityEngine::MonoBehaviour,
 )
 
 DECLARE_CLASS_CODEGEN(Qubes, DefaultCube, UnityEngine::MonoBehaviour,
+    DECLARE_INSTANCE_METHOD(void, OnDestroy);
+
     public:
 
     void init(UnityEngine::Color color, int cubeType, int onHit, float cubeSize, bool locked, Qubes::QubesConfig& config, int index);
 
-    UnityEngine::Transform* findTransform(std::string_view name);
-    
     void setColor(UnityEngine::Color color);
     void setType(int cubeType);
     void setSize(float size);
+    // for the quality governor, keeps the type
+    void setGlowHidden(bool hidden);
+    // tints selected cubes without changing their color
+    void setHighlighted(bool highlight);
+    // drawn on its own while the tint changes, so a static batch isn't rebuilt for every step
+    void setFlashing(bool flash);
 
     void setHitAction(int action) { hitAction = action; }
-    void setLocked(bool lock) { locked = lock; }
+    void setLocked(bool lock);
     UnityEngine::Color getColor() { return color; }
+    // with the selection tint, for drawing
+    UnityEngine::Color getShownColor();
     int getType() { return type; }
     int getHitAction() { return hitAction; }
     float getSize() { return size; }
@@ -52,6 +72,18 @@ DECLARE_CLASS_CODEGEN(Qubes, DefaultCube, UnityEngine::MonoBehaviour,
     void setMenuActive(bool active);
 
     void save();
+    Qubes::CubeInfo getInfo();
+    Qubes::QubesConfig* getConfig() { return config; }
+    bool hasMenu() { return menu; }
+    // destroys the cube and its menu, the config is left as it is
+    void destroy();
+    // switches between static and interactive to match the lock and FreezeLayout
+    void refreshStatic();
+    bool isStatic() { return staticId >= 0; }
+    bool isPlaced() { return placed; }
+
+    int animSlot; // -1 if not animated
+    int physSlot; // -1 if not thrown
 
     int index; // for editing in config
 
@@ -60,8 +92,15 @@ DECLARE_CLASS_CODEGEN(Qubes, DefaultCube, UnityEngine::MonoBehaviour,
     void makeMenu();
     
     bool typeSet;
+    bool glowHidden;
+    bool highlighted;
+    bool flashing;
+    // only placed cubes, not the preview one
+    bool placed;
+    int staticId;
 
     UnityEngine::Material* material;
+    UnityEngine::Transform *arrow, *arrowGlow, *circleGlow, *cuttable;
 
     Qubes::QubesConfig* config; // idk about reference variables in classes, it caused complaints
 
@@ -79,6 +118,8 @@ DECLARE_CLASS_CODEGEN(Qubes, DefaultCube, UnityEngine::MonoBehaviour,
 DECLARE_CLASS_CUSTOM(Qubes, Cube, Qubes::DefaultCube,
     DECLARE_INSTANCE_METHOD(void, Update);
     DECLARE_INSTANCE_METHOD(void, LateUpdate);
+    DECLARE_INSTANCE_METHOD(void, OnEnable);
+    DECLARE_INSTANCE_METHOD(void, OnDisable);
 
     public:
 
@@ -88,8 +129,25 @@ DECLARE_CLASS_CUSTOM(Qubes, Cube, Qubes::DefaultCube,
     void setCuttableDelay(bool cuttable, float seconds);
     
     void setMenuActive(bool active);
+    // everything from the config at once, without saving it back
+    void setInfo(Qubes::CubeInfo const& info);
     bool deletePressed(UnityEngine::Transform* hit);
     void editPressed(UnityEngine::Transform* hit);
+
+    // moves a held cube with the newest controller pose, for direct grabbing
+    void applyGrab(float deltaTime);
+    bool isHeld() { return controller; }
+    // hidden in the pool after a layout switch, until a layout needs another cube
+    bool pooled;
+
+    GlobalNamespace::BoxCuttableBySaber* getHitbox() { return hitbox; }
+
+    // for the broadphase, bounds of the cuttable collider
+    Qubes::OBB getCutBounds();
+    bool cuttableNow();
+    // only touches the collider if it changes
+    void setColliderEnabled(bool enabled);
+    int sweepId; // -1 until the broadphase is built with it
     
     private:
 
@@ -99,6 +157,7 @@ DECLARE_CLASS_CUSTOM(Qubes, Cube, Qubes::DefaultCube,
     GlobalNamespace::BoxCuttableBySaber* hitbox;
 
     GlobalNamespace::VRController* controller;
-    UnityEngine::Vector3 grabPos;
-    UnityEngine::Quaternion grabRot;
+    bool colliderOff;
+    Qubes::Grab grab;
+    Qubes::ThrowTracker throwTracker;
 )
\ No newline at end of file
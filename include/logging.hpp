@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+// leveled logging, messages below QUBES_LOG_LEVEL are compiled out entirely
+// the rest are formatted into a lock-free queue and written to the log by a background thread
+#define QUBES_LOG_DEBUG 0
+#define QUBES_LOG_INFO 1
+#define QUBES_LOG_WARNING 2
+#define QUBES_LOG_ERROR 3
+#define QUBES_LOG_NONE 4
+
+#ifndef QUBES_LOG_LEVEL
+#define QUBES_LOG_LEVEL QUBES_LOG_INFO
+#endif
+
+namespace Qubes::Log {
+    enum class Level : uint8_t { Debug, Info, Warning, Error };
+
+    void push(Level level, const char* format, ...) __attribute__((format(printf, 2, 3)));
+    // starts the thread that writes queued messages, anything pushed before is kept until then
+    void startWriter();
+}
+
+#if QUBES_LOG_LEVEL <= QUBES_LOG_DEBUG
+#define LOG_DEBUG(...) Qubes::Log::push(Qubes::Log::Level::Debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void) 0)
+#endif
+#if QUBES_LOG_LEVEL <= QUBES_LOG_INFO
+#define LOG_INFO(...) Qubes::Log::push(Qubes::Log::Level::Info, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void) 0)
+#endif
+#if QUBES_LOG_LEVEL <= QUBES_LOG_WARNING
+#define LOG_WARNING(...) Qubes::Log::push(Qubes::Log::Level::Warning, __VA_ARGS__)
+#else
+#define LOG_WARNING(...) ((void) 0)
+#endif
+#if QUBES_LOG_LEVEL <= QUBES_LOG_ERROR
+#define LOG_ERROR(...) Qubes::Log::push(Qubes::Log::Level::Error, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void) 0)
+#endif
@@ -12,6 +12,11 @@
 #include "UnityEngine/Resources.hpp"
 
 Logger& getLogger();
+#include "logging.hpp"
+#include "core/trace.hpp"
+#include "core/memory.hpp"
+#include "core/governor.hpp"
+#include "core/events.hpp"
 
 #include "UnityEngine/MonoBehaviour.hpp"
 #include "GlobalNamespace/NoteDebris.hpp"
@@ -20,20 +25,168 @@ Logger& getLogger();
 #include "GlobalNamespace/HapticFeedbackController.hpp"
 #include "GlobalNamespace/PauseController.hpp"
 #include "HMUI/ViewController.hpp"
+#include "GlobalNamespace/OVRInput_Button.hpp"
 
 extern ModInfo modInfo;
 
+void bakePrototype(UnityEngine::GameObject* prototype);
 Cube* makeCube(CubeInfo info, QubesConfig& config, int index);
 DefaultCube* makeDefaultCube(CubeInfo info, QubesConfig& config, int index);
 
+void recordInput(std::vector<GlobalNamespace::OVRInput::Button> const& buttons);
+void saveRecording();
+// counts this frame's tracked allocations, and logs the summary and budget alarm
+void profileAllocations();
+
+Qubes::Memory::Report memoryReport();
+// estimate for one cube, with its menu and config entry
+uint64_t cubeMemory(DefaultCube* cube);
+// checks the optional limits, and tells the user why if another cube can't be made
+bool canMakeCube();
+// how many more cubes the limits allow, INT_MAX without any
+int cubeAllowance();
+extern std::string lastRefusal;
+// shows text in front of the pointer for a few seconds
+void showMessage(std::string const& message);
+
+// steps the quality tier from frame times and applies it to glow
+void updateQuality();
+// the debris to spawn for a cut at the current tier, or nullptr for none
+GlobalNamespace::NoteDebris* takeDebrisPrefab();
+extern Qubes::Governor governor;
+
+// qubes' own cut detection, which takes the cubes' colliders out of the game's
+void sweepSaber(GlobalNamespace::Saber* saber);
+// gives the colliders back whenever sabers can't cut, call when the scene or pause state changes
+void updateBroadphase();
+// for cubes added, removed or changed, the next sweep rebuilds everything
+void markBroadphaseDirty();
+// for cubes that only moved, the next sweep updates their boxes
+void moveBroadphaseCube(Cube* cube);
+
+// direct grabbing moves held cubes in onBeforeRender, after each of their controllers is updated again
+void holdUntilRender(Cube* cube, GlobalNamespace::VRController* controller, float deltaTime);
+// from the VRController::Update hook, when each controller's pose was read
+void controllerSampled(GlobalNamespace::VRController* controller);
+// measured from when the controller's pose was read until just before rendering
+void recordGrabLatency(GlobalNamespace::VRController* controller, Math::Vec3 applied, Math::Vec3 target, float deltaTime);
+// clears the latency counter, a new grab starts over
+void grabReleased();
+
+// looping motions of all cubes, evaluated together once a frame
+// none removes the animation and puts the cube back at the pose it moved around
+void setCubeAnimation(Cube* cube, Qubes::Animation const& animation);
+void removeCubeAnimation(DefaultCube* cube);
+// the saved pose of an animated cube, and its animation
+void animatedInfo(int slot, Qubes::CubeInfo& info);
+// after a held cube is let go, where it is becomes where it animates from
+void moveAnimatedCube(DefaultCube* cube);
+void resizeAnimatedCube(DefaultCube* cube);
+void updateAnimations();
+
+// thrown cubes, stepped together until they come to rest and are saved where they stopped
+void throwCube(Cube* cube, Math::Vec3 velocity, Math::Vec3 angularVelocity);
+void stopCubePhysics(DefaultCube* cube);
+void updatePhysics();
+
+// locked cubes, or all of them while the layout is frozen, are drawn from meshes combined by color
+// ids are from addStatic, which the cube has to remove before it is destroyed
+int addStatic(DefaultCube* cube);
+void removeStatic(int id);
+void setStaticColor(int id, UnityEngine::Color color);
+// rebuilds the cube's batch next frame, after it moved, resized, or was hidden or shown
+void markStaticDirty(int id);
+// rebuilds changed batches, and applies FreezeLayout
+void updateStaticBatches();
+
+// watches the config file, and reads it on a worker thread when something else changes it
+void watchConfig();
+// applies the last change read by the watcher to the cubes, only touching the ones that differ
+void applyConfigReload();
+
+// named layouts, bound to the menu, all levels, or a song or playlist, see core/layouts.hpp
+// only the shown one is in memory, reads the bindings after the config is loaded
+void loadLayouts();
+std::string const& activeLayout();
+// safe from any thread, set before the switched to cubes are published
+bool defaultLayoutShown();
+// where the default layout is kept, also while another one is shown
+Qubes::ConfigStorage* defaultLayoutStorage();
+// the default layout first, then the files in the layouts folder by name
+std::vector<std::string> listLayouts();
+// keeps the current one if the new one can't be read
+bool switchLayout(std::string const& name);
+std::string const& layoutFolder();
+// an empty layout file, false if the name is taken or can't be used
+bool createLayout(std::string const& name);
+// switches to the default layout first if it's shown, and forgets its bindings
+void deleteLayout(std::string const& name);
+// to the one bound to the current scene and selected song, call after inMenu and inGameplay are set
+void switchBoundLayout();
+// from the level list, prefetches the layout the selection would play with
+void songSelected(std::string const& levelId);
+void playlistSelected(std::string const& name);
+// replaces the shown cubes, reusing the ones the diff pairs up and pooling the rest
+void applyLayout(std::vector<Qubes::CubeInfo> cubes, Qubes::LayoutDiff const& diff);
+
+// with MultiSelect the edit button selects cubes, see core/selection.hpp, and a floating menu edits them together
+// pressing on a cube paints over cubes while held, pressing on nothing selects the box dragged out until release
+void selectPressed(bool right);
+// follows the held edit button, call every frame in the menu
+void updateSelection(GlobalNamespace::OVRInput::Button editButton);
+void clearSelection();
+// whether the cube at the index is selected, so it's tinted
+bool isSelected(int index);
+// after a cube was deleted on its own, the selection moves down with the later cubes
+void selectionErased(int index);
+
+// undo and redo of edits to the shown layout, see core/history.hpp, recorded by QubesConfigs[0]
+void initHistory();
+// from UndoMemory, dropping the oldest steps if it shrank
+void setHistoryLimit();
+Qubes::History const& layoutHistory();
+// for when the layout is replaced as a whole
+void clearHistory();
+void undoLayout();
+void redoLayout();
+// remove or add cubes along with their objects in one pass, indices in increasing order
+void eraseCubes(std::vector<int> const& indices);
+void insertCubes(std::vector<int> const& indices, std::vector<Qubes::CubeInfo> const& values);
+
+// procedural layouts for stress testing, see core/generator.hpp
+// from the generator settings, with the default cube's look
+Qubes::Generator configGenerator();
+// appends to the config with one write, as many as the qube limits allow, returns how many
+// cubes for QubesConfigs[0] are made right away
+int generateCubes(Qubes::Generator const& generator, QubesConfig& config);
+// generates each step's count in a temporary layout and measures it, then writes a csv to the mod data folder
+bool startStressTest();
+// steps a running stress test, call every frame
+void updateStressTest();
+
+// names of cube types for the ui, by type
+extern const std::vector<std::string> cubeTypes;
+
+// cuts for other mods, and what a cube does when cut, both can be added to through the api
+extern Qubes::CutBus cutBus;
+extern Qubes::HitActionTable hitActions;
+
+// cuts reach cubes through one hook on BoxCuttableBySaber::Cut instead of a delegate per cube
+void addCutTarget(Cube* cube);
+void removeCutTarget(Cube* cube);
+// nullptr for anything that isn't a cube, like the game's notes
+Cube* findCutTarget(GlobalNamespace::BoxCuttableBySaber* hitbox);
+
 // extern std::std::vector<QubesConfig> QubesConfigs; in modconfig.hpp
 extern DefaultCube* defaultCube;
+extern CubeParts cubeParts;
 
 extern std::vector<Cube*> cubeArr;
 extern GlobalNamespace::NoteDebris* debrisPrefab;
+extern GlobalNamespace::NoteDebris* debrisPrefabLight;
 extern UnityEngine::Color lastColor;
 extern VRUIControls::VRPointer* pointer;
 extern GlobalNamespace::HapticFeedbackController* haptics;
 extern GlobalNamespace::PauseController* pauser;
 
-extern bool inMenu, inGameplay;
\ No newline at end of file
+extern bool inMenu, inGameplay, created;
\ No newline at end of file
@@ -4,6 +4,10 @@
 
 #include "HMUI/ViewController.hpp"
 #include "HMUI/FlowCoordinator.hpp"
+#include "TMPro/TextMeshProUGUI.hpp"
+#include "HMUI/TableView.hpp"
+#include "HMUI/TableView_IDataSource.hpp"
+#include "HMUI/TableCell.hpp"
 
 #include "UnityEngine/GameObject.hpp"
 #include "UnityEngine/Color.hpp"
@@ -12,41 +16,26 @@
 
 #include "config-utils/shared/config-utils.hpp"
 
-namespace Qubes {
-    class DefaultCube;
-
-    struct CubeInfo {
-        UnityEngine::Vector3 pos;
-        UnityEngine::Quaternion rot;
-        UnityEngine::Color color;
-        int type;
-        int hitAction;
-        float size;
-        bool locked;
-
-        CubeInfo(UnityEngine::Vector3 pos, UnityEngine::Quaternion rot, UnityEngine::Color color, int type, int hitAction, float size, bool locked);
-        CubeInfo(rapidjson::Value& obj);
-        CubeInfo(DefaultCube* cube);
-
-        rapidjson::Value ToJSON(rapidjson::Document::AllocatorType& allocator);
-    };
-
-    struct QubesConfig {
-        Configuration* config;
+namespace QuestUI { class IncrementSetting; class CustomListTableData; }
 
-        std::vector<CubeInfo> cubes;
-        std::vector<CubeInfo> defCubes;
-        std::string name;
+#include "core/generator.hpp"
+#include "core/qubesconfig.hpp"
+#include "core/stats.hpp"
 
-        QubesConfig(std::string arrname, std::vector<CubeInfo> initCubes = {}) { name = arrname; defCubes = initCubes; }
-        void Init(Configuration* cfg);
+namespace Qubes {
+    // gives the core config code the document of the config-utils file
+    class ModConfigStorage : public ConfigStorage {
+        public:
+        Configuration* config;
 
-        void LoadValue();
-        void SetValue();
-        void SetCubeValue(int index, CubeInfo value);
-        void AddCube(CubeInfo cube);
-        void RemoveCube(int index);
+        ModConfigStorage(Configuration* cfg) : config(cfg) {}
+        rapidjson::Document& GetDocument() override { return config->config; }
+        void Write() override {
+            Stats::configWrites.fetch_add(1, std::memory_order_relaxed);
+            config->Write();
+        }
     };
+    ConfigStorage* getConfigStorage(Configuration* config);
 }
 
 using namespace Qubes;
@@ -54,6 +43,8 @@ using namespace Qubes;
 #pragma region configClasses
 DECLARE_CLASS_CODEGEN(Qubes, GlobalSettings, HMUI::ViewController,
     DECLARE_OVERRIDE_METHOD(void, DidActivate, il2cpp_utils::FindMethodUnsafe("HMUI", "ViewController", "DidActivate", 3), bool firstActivation, bool addedToHierarchy, bool screenSystemEnabling);
+
+    TMPro::TextMeshProUGUI* qualityText;
 )
 
 DECLARE_CLASS_CODEGEN(Qubes, CreationSettings, HMUI::ViewController,
@@ -65,6 +56,49 @@ DECLARE_CLASS_CODEGEN(Qubes, ButtonSettings, HMUI::ViewController,
     DECLARE_OVERRIDE_METHOD(void, DidActivate, il2cpp_utils::FindMethodUnsafe("HMUI", "ViewController", "DidActivate", 3), bool firstActivation, bool addedToHierarchy, bool screenSystemEnabling);
 )
 
+DECLARE_CLASS_CODEGEN(Qubes, MemoryView, HMUI::ViewController,
+    DECLARE_OVERRIDE_METHOD(void, DidActivate, il2cpp_utils::FindMethodUnsafe("HMUI", "ViewController", "DidActivate", 3), bool firstActivation, bool addedToHierarchy, bool screenSystemEnabling);
+
+    void refresh();
+    TMPro::TextMeshProUGUI* text;
+)
+
+// rows of the layout browser, only the visible ones exist and they are reused while scrolling
+DECLARE_CLASS_CODEGEN_INTERFACES(Qubes, LayoutTableData, UnityEngine::MonoBehaviour, classof(HMUI::TableView::IDataSource*),
+    DECLARE_OVERRIDE_METHOD(HMUI::TableCell*, CellForIdx, il2cpp_utils::FindMethodUnsafe("HMUI", "TableView/IDataSource", "CellForIdx", 2), HMUI::TableView* tableView, int idx);
+    DECLARE_OVERRIDE_METHOD(float, CellSize, il2cpp_utils::FindMethodUnsafe("HMUI", "TableView/IDataSource", "CellSize", 0));
+    DECLARE_OVERRIDE_METHOD(int, NumberOfCells, il2cpp_utils::FindMethodUnsafe("HMUI", "TableView/IDataSource", "NumberOfCells", 0));
+)
+
+DECLARE_CLASS_CODEGEN(Qubes, LayoutView, HMUI::ViewController,
+    DECLARE_OVERRIDE_METHOD(void, DidActivate, il2cpp_utils::FindMethodUnsafe("HMUI", "ViewController", "DidActivate", 3), bool firstActivation, bool addedToHierarchy, bool screenSystemEnabling);
+    DECLARE_OVERRIDE_METHOD(void, DidDeactivate, il2cpp_utils::FindMethodUnsafe("HMUI", "ViewController", "DidDeactivate", 2), bool removedFromHierarchy, bool screenSystemDisabling);
+
+    // runs the filter again, on the latest snapshot if the layout changed
+    void refresh();
+    // the cube of the selected row, or -1 with the rows refreshed if the layout changed since they were made
+    int selectedCube();
+    QuestUI::CustomListTableData* list;
+    Qubes::LayoutTableData* data;
+    QuestUI::IncrementSetting *typeInc, *actionInc, *lockedInc, *hueMinInc, *hueMaxInc, *distanceInc;
+    TMPro::TextMeshProUGUI* countText;
+)
+
+DECLARE_CLASS_CODEGEN(Qubes, LayoutSettings, HMUI::ViewController,
+    DECLARE_OVERRIDE_METHOD(void, DidActivate, il2cpp_utils::FindMethodUnsafe("HMUI", "ViewController", "DidActivate", 3), bool firstActivation, bool addedToHierarchy, bool screenSystemEnabling);
+
+    void refresh();
+    QuestUI::IncrementSetting* layoutInc;
+    TMPro::TextMeshProUGUI* statusText;
+)
+
+DECLARE_CLASS_CODEGEN(Qubes, GeneratorSettings, HMUI::ViewController,
+    DECLARE_OVERRIDE_METHOD(void, DidActivate, il2cpp_utils::FindMethodUnsafe("HMUI", "ViewController", "DidActivate", 3), bool firstActivation, bool addedToHierarchy, bool screenSystemEnabling);
+
+    void refresh();
+    TMPro::TextMeshProUGUI* statusText;
+)
+
 DECLARE_CLASS_CODEGEN(Qubes, CreditsView, HMUI::ViewController,
     DECLARE_OVERRIDE_METHOD(void, DidActivate, il2cpp_utils::FindMethodUnsafe("HMUI", "ViewController", "DidActivate", 3), bool firstActivation, bool addedToHierarchy, bool screenSystemEnabling);
 )
@@ -77,6 +111,14 @@ DECLARE_CLASS_CODEGEN(Qubes, ModSettings, HMUI::FlowCoordinator,
     Qubes::CreationSettings* creationSettings;
     Qubes::ButtonSettings* buttonSettings;
     Qubes::CreditsView* credits;
+    Qubes::MemoryView* memoryView;
+    Qubes::LayoutView* layoutView;
+    Qubes::LayoutSettings* layoutSettings;
+    Qubes::GeneratorSettings* generatorSettings;
+
+    void showLayout();
+    void showLayoutSettings();
+    void showGenerator();
 )
 #pragma endregion
 
@@ -103,10 +145,38 @@ DECLARE_CONFIG(ModConfig,
     CONFIG_VALUE(CtrlMake, int, "  Controllers", 2);
     CONFIG_VALUE(CtrlEdit, int, "  Controllers", 2);
     CONFIG_VALUE(CtrlDel, int, "  Controllers", 2);
+    CONFIG_VALUE(BtnUndo, int, "Undo Button", 3);
+    CONFIG_VALUE(BtnRedo, int, "Redo Button", 3);
+    CONFIG_VALUE(CtrlUndo, int, "  Controllers", 0);
+    CONFIG_VALUE(CtrlRedo, int, "  Controllers", 1);
 
     CONFIG_VALUE(MoveSpeed, float, "Movement Speed", 1, "The speed that thumbstick controls move the qube");
     CONFIG_VALUE(RotSpeed, float, "Rotataion Speed", 1, "The speed that thumbstick controls rotate the qube");
     CONFIG_VALUE(LeftThumbMove, bool, "Swap Thumbsticks", false, "Default - right thumbstick moves, left thumbstick rotates");
+    CONFIG_VALUE(MultiSelect, bool, "Multi Select", false, "The edit button selects qubes for editing together, hold it to paint over qubes or drag it from empty space to select a box");
+    CONFIG_VALUE(DirectGrab, bool, "Direct Grab", true, "Move held qubes with the newest controller pose right before rendering, instead of easing towards it");
+    // in seconds, only for direct grab
+    CONFIG_VALUE(GrabSmoothing, float, "Grab Smoothing", 0, "Smooth out held qubes with direct grab, higher is smoother but lags more");
+    CONFIG_VALUE(ThrowCubes, bool, "Throw Qubes", false, "Let go of a moving qube to throw it, it slows down and stays where it stops");
+    CONFIG_VALUE(Gravity, float, "Qube Gravity", 0, "How fast thrown qubes fall, at 0 they float");
+    CONFIG_VALUE(FreezeLayout, bool, "Freeze Layout", false, "Treat every qube as locked, and draw them as a few combined meshes");
+    CONFIG_VALUE(Broadphase, bool, "Qubes Cut Detection", false, "Detect saber cuts on qubes in the mod instead of through the game's colliders, faster with big layouts");
+    CONFIG_VALUE(AdaptiveQuality, bool, "Adaptive Quality", true, "Reduce debris and glow while frames are being dropped");
+    // 0 for no limit
+    CONFIG_VALUE(MaxCubes, int, "Qube Limit", 0, "Refuse to create qubes once the layout has this many, 0 for no limit");
+    CONFIG_VALUE(MemoryLimit, int, "Memory Limit (MB)", 0, "Refuse to create qubes once the estimated memory use would pass this, 0 for no limit");
+    // stress layouts, see core/generator.hpp
+    CONFIG_VALUE(GenShape, int, "Shape", 0);
+    CONFIG_VALUE(GenCount, int, "Qube Count", 1000, "How many qubes to generate, the stress test uses its own counts");
+    CONFIG_VALUE(GenSeed, int, "Seed", 1, "The same seed always generates the same qubes");
+    CONFIG_VALUE(GenSpacing, float, "Spacing", 0.5, "Roughly the distance between generated qubes, in meters");
+    CONFIG_VALUE(UndoMemory, int, "Undo Memory (KB)", 256, "How much undo history to keep, the oldest steps are forgotten past this");
+    // debugging
+    CONFIG_VALUE(RecordInput, bool, "Record Input", false, "Record controller input to the mod data folder, for replaying in the host frame simulator");
+    CONFIG_VALUE(Tracing, bool, "Record Trace", false, "Write timing traces to the mod data folder, starts or stops on the next scene change");
+    CONFIG_VALUE(ProfileAllocs, bool, "Profile Allocations", false, "Log managed allocations made by the mod every few seconds");
+    CONFIG_VALUE(AllocBudget, int, "Allocation Budget (KB)", 4, "Log a warning when a frame allocates more than this while profiling");
+    CONFIG_VALUE(ShowOverlay, bool, "Performance Overlay", false, "Show mod frame times and live counters in a panel above the menu");
     
     CONFIG_INIT_FUNCTION(
         CONFIG_INIT_VALUE(ShowInMenu);
@@ -123,11 +193,35 @@ DECLARE_CONFIG(ModConfig,
         CONFIG_INIT_VALUE(CtrlMake);
         CONFIG_INIT_VALUE(CtrlEdit);
         CONFIG_INIT_VALUE(CtrlDel);
+        CONFIG_INIT_VALUE(BtnUndo);
+        CONFIG_INIT_VALUE(BtnRedo);
+        CONFIG_INIT_VALUE(CtrlUndo);
+        CONFIG_INIT_VALUE(CtrlRedo);
         CONFIG_INIT_VALUE(MoveSpeed);
         CONFIG_INIT_VALUE(RotSpeed);
         CONFIG_INIT_VALUE(LeftThumbMove);
+        CONFIG_INIT_VALUE(MultiSelect);
+        CONFIG_INIT_VALUE(DirectGrab);
+        CONFIG_INIT_VALUE(GrabSmoothing);
+        CONFIG_INIT_VALUE(ThrowCubes);
+        CONFIG_INIT_VALUE(Gravity);
+        CONFIG_INIT_VALUE(FreezeLayout);
+        CONFIG_INIT_VALUE(Broadphase);
+        CONFIG_INIT_VALUE(AdaptiveQuality);
+        CONFIG_INIT_VALUE(MaxCubes);
+        CONFIG_INIT_VALUE(MemoryLimit);
+        CONFIG_INIT_VALUE(GenShape);
+        CONFIG_INIT_VALUE(GenCount);
+        CONFIG_INIT_VALUE(GenSeed);
+        CONFIG_INIT_VALUE(GenSpacing);
+        CONFIG_INIT_VALUE(UndoMemory);
+        CONFIG_INIT_VALUE(RecordInput);
+        CONFIG_INIT_VALUE(Tracing);
+        CONFIG_INIT_VALUE(ProfileAllocs);
+        CONFIG_INIT_VALUE(AllocBudget);
+        CONFIG_INIT_VALUE(ShowOverlay);
         migrate(config);
         for(QubesConfig& qube_cfg : QubesConfigs)
-            qube_cfg.Init(config);
+            qube_cfg.Init(getConfigStorage(config));
     )
 )
\ No newline at end of file
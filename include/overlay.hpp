@@ -0,0 +1,25 @@
+#pragma once
+
+#include "custom-types/shared/macros.hpp"
+
+#include "UnityEngine/MonoBehaviour.hpp"
+#include "TMPro/TextMeshProUGUI.hpp"
+
+// world space panel with the live counters from core/stats.hpp
+DECLARE_CLASS_CODEGEN(Qubes, PerfOverlay, UnityEngine::MonoBehaviour,
+    DECLARE_INSTANCE_METHOD(void, Update);
+
+    public:
+
+    void init();
+
+    private:
+
+    TMPro::TextMeshProUGUI* text;
+    float elapsed;
+)
+
+namespace Qubes {
+    // creates the overlay when first shown, and turns frame timing on or off with it
+    void setOverlayActive(bool active);
+}
@@ -1,8 +1,12 @@
 #pragma once
 
 #include "UnityEngine/GameObject.hpp"
+#include "UnityEngine/Vector3.hpp"
 #include "conditional-dependencies/shared/main.hpp"
 
+#include "snapshot.hpp"
+#include "events.hpp"
+
 namespace Qubes {
     // configs for each mod must be registered for them to work independently of the regular behaviour
     inline bool RegisterConfig(std::string modName) {
@@ -34,12 +38,122 @@ namespace Qubes {
     }
 
     // add a cube to the config if there is not one already, then create and return
+    // returns nullptr if the qube limits set by the user don't allow another
     inline std::optional<UnityEngine::GameObject*> CreateCube(std::string modName, int index) {
         static auto func = CondDeps::Find<UnityEngine::GameObject*, std::string, int>("qubes", "CreateCube");
         if(func)
             return func.value()(modName, index);
         return std::nullopt;
     }
+
+    // adds count cubes around the player with the default cube's look, the same seed always gives the same cubes
+    // shape: 0 grid, 1 sphere, 2 spiral, 3 random cloud, returns how many the qube limits allowed
+    // cubes are only made right away for qubes' own config, other mods make theirs with CreateCube
+    inline std::optional<int> GenerateCubes(std::string modName, int shape, int count, int seed) {
+        static auto func = CondDeps::Find<int, std::string, int, int, int>("qubes", "GenerateCubes");
+        if(func)
+            return func.value()(modName, shape, count, seed);
+        return std::nullopt;
+    }
+
+    // motion: 0 none, 1 bob, 2 spin, 3 orbit, 4 path, speed is in loops per second and amount is the bob height or orbit radius
+    // path points are offsets from the cube's position in its own space, SaveCube saves the animation with the cube
+    inline bool SetCubeAnimation(UnityEngine::GameObject* cube, int motion, float speed, float amount, std::vector<UnityEngine::Vector3> path = {}) {
+        static auto func = CondDeps::Find<void, UnityEngine::GameObject*, int, float, float, std::vector<UnityEngine::Vector3>>("qubes", "SetCubeAnimation");
+        if(func)
+            func.value()(cube, motion, speed, amount, path);
+        return (bool)func;
+    }
+
+    // called for every qube cut, from the main thread and without allocating
+    // the callback has to stay valid until it is unsubscribed
+    inline bool SubscribeCuts(CutCallback callback, void* context = nullptr) {
+        static auto func = CondDeps::Find<bool, CutCallback, void*>("qubes", "SubscribeCuts");
+        if(func)
+            return func.value()(callback, context);
+        return false;
+    }
+
+    inline bool UnsubscribeCuts(CutCallback callback, void* context = nullptr) {
+        static auto func = CondDeps::Find<bool, CutCallback, void*>("qubes", "UnsubscribeCuts");
+        if(func)
+            return func.value()(callback, context);
+        return false;
+    }
+
+    // a hit action that shows up in the edit menu after the built in ones, and runs when a qube with it is cut in gameplay
+    // cubes save the returned id, which comes from the name, so keep the name the same between versions
+    // adding the same name again replaces it
+    inline std::optional<int> AddHitAction(std::string name, CutCallback callback, void* context = nullptr) {
+        static auto func = CondDeps::Find<int, std::string, CutCallback, void*>("qubes", "AddHitAction");
+        if(func)
+            return func.value()(name, callback, context);
+        return std::nullopt;
+    }
+
+    // the published cubes of a config, get it from the main thread once the config is registered
+    // the source itself can then be used from any thread
+    inline std::optional<SnapshotSource*> GetSnapshotSource(std::string modName) {
+        static auto func = CondDeps::Find<SnapshotSource*, std::string>("qubes", "GetSnapshotSource");
+        if(func)
+            return func.value()(modName);
+        return std::nullopt;
+    }
+
+    // the latest snapshot, from any thread without locking, null if qubes isn't loaded
+    // it doesn't change while held, every acquired snapshot has to be released
+    inline CubeSnapshot const* AcquireSnapshot(SnapshotSource* source) {
+        static auto func = CondDeps::Find<CubeSnapshot const*, SnapshotSource*>("qubes", "AcquireSnapshot");
+        if(func)
+            return func.value()(source);
+        return nullptr;
+    }
+
+    inline void ReleaseSnapshot(CubeSnapshot const* snapshot) {
+        static auto func = CondDeps::Find<void, CubeSnapshot const*>("qubes", "ReleaseSnapshot");
+        if(func && snapshot)
+            func.value()(snapshot);
+    }
+
+    // acquires a snapshot and releases it when it goes out of scope
+    class ScopedSnapshot {
+        CubeSnapshot const* snapshot;
+
+        public:
+
+        ScopedSnapshot(SnapshotSource* source) : snapshot(AcquireSnapshot(source)) {}
+        ~ScopedSnapshot() { ReleaseSnapshot(snapshot); }
+        ScopedSnapshot(ScopedSnapshot const&) = delete;
+        ScopedSnapshot& operator=(ScopedSnapshot const&) = delete;
+
+        CubeSnapshot const* operator->() const { return snapshot; }
+        explicit operator bool() const { return snapshot; }
+    };
+
+    // estimated bytes kept resident by everything qubes has made
+    struct MemoryUsage {
+        uint64_t cubes, menus, debris, config, sprites;
+        uint64_t total;
+        // one cube with its config entry, without a menu
+        uint64_t perCube;
+        // cubes in the shown layout, what the cube limit counts
+        int cubeCount;
+    };
+
+    inline std::optional<MemoryUsage> GetMemoryUsage() {
+        static auto func = CondDeps::Find<MemoryUsage>("qubes", "GetMemoryUsage");
+        if(func)
+            return func.value()();
+        return std::nullopt;
+    }
+
+    // estimated bytes for one cube, with its menu and config entry, 0 if it isn't a cube
+    inline std::optional<uint64_t> CubeMemory(UnityEngine::GameObject* cube) {
+        static auto func = CondDeps::Find<uint64_t, UnityEngine::GameObject*>("qubes", "CubeMemory");
+        if(func)
+            return func.value()(cube);
+        return std::nullopt;
+    }
 }
 
 // feel free to ask for more api features or qube class methods
\ No newline at end of file
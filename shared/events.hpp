@@ -0,0 +1,25 @@
+#pragma once
+
+namespace UnityEngine { class GameObject; }
+
+namespace Qubes {
+    // a qube cut by a saber, only valid for the duration of the callback
+    struct CutEvent {
+        UnityEngine::GameObject* cube;
+        float point[3];
+        // normalized, in world space
+        float direction[3];
+        float saberSpeed;
+        // 0 left, 1 right
+        int saberType;
+        // 0 blank, 1 dot, 2 arrow
+        int cubeType;
+        // the id AddHitAction returned, or 0 to 4 for the built in none, pause, restart, menu and crash
+        int hitAction;
+        // hit actions are only run in gameplay, subscribers also get cuts in the menu
+        bool inGameplay;
+    };
+
+    // called on the main thread, context is whatever was passed when it was added
+    using CutCallback = void (*)(CutEvent const& event, void* context);
+}
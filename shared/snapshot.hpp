@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Qubes {
+    // one cube as it was last saved, plain data so it can be read without unity or the mod's own types
+    struct CubeRecord {
+        float pos[3];
+        float rot[4];
+        float color[4];
+        float size;
+        int type;
+        int hitAction;
+        // motion from SetCubeAnimation, 0 if it isn't animated
+        int motion;
+        bool locked;
+    };
+
+    // every cube of one config at some point in time, never changed after it is published
+    // a newer snapshot replaces it after every saved change, this one stays readable until it is released
+    struct CubeSnapshot {
+        // increases with every published change
+        uint64_t version;
+        int count;
+        CubeRecord const* cubes;
+    };
+
+    // where the snapshots of one config are published, valid for the rest of the game
+    struct SnapshotSource;
+}
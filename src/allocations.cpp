@@ -0,0 +1,44 @@
+#include "main.hpp"
+#include "core/allocations.hpp"
+
+#include "UnityEngine/Time.hpp"
+
+// seconds between summaries in the log
+constexpr float reportInterval = 5;
+
+static float sinceReport = 0;
+static bool alarmed = false;
+
+void profileAllocations() {
+    bool enabled = getModConfig().ProfileAllocs.GetValue();
+    if(enabled != Allocations::enabled.load(std::memory_order_relaxed)) {
+        Allocations::enabled = enabled;
+        // drop anything left over from the last time it was on
+        Allocations::endFrame(UINT32_MAX);
+        Allocations::takeReport();
+        sinceReport = 0;
+        alarmed = false;
+    }
+    if(!enabled)
+        return;
+
+    uint32_t budget = getModConfig().AllocBudget.GetValue() * 1024;
+    auto frame = Allocations::endFrame(budget);
+    // one alarm per summary, the summary counts the rest
+    if(frame.overBudget && !alarmed) {
+        LOG_WARNING("Frame allocated %u bytes in %u objects, over the budget of %u, mostly from %s", frame.bytes, frame.count, budget, Allocations::siteName(frame.topSite));
+        alarmed = true;
+    }
+
+    sinceReport += UnityEngine::Time::get_unscaledDeltaTime();
+    if(sinceReport < reportInterval)
+        return;
+    sinceReport = 0;
+    alarmed = false;
+    auto report = Allocations::takeReport();
+    if(report.sites.empty())
+        return;
+    LOG_INFO("Allocations in the last %i frames, %i over budget:", report.frames, report.framesOverBudget);
+    for(auto& site : report.sites)
+        LOG_INFO("  %s: %llu objects, %llu bytes, %.1f bytes per frame, peak %u", site.name, (unsigned long long) site.count, (unsigned long long) site.bytes, (double) site.bytes / report.frames, site.peakBytes);
+}
@@ -0,0 +1,97 @@
+#include "main.hpp"
+#include "core/animation.hpp"
+
+#include "UnityEngine/Camera.hpp"
+#include "UnityEngine/Matrix4x4.hpp"
+#include "UnityEngine/Time.hpp"
+
+static AnimationBatch batch;
+// cubes by their slot in batch
+static std::vector<Cube*> slots;
+// stops while a level is paused, so cubes carry on where they were
+static double animationClock = 0;
+
+static void removeSlot(int slot) {
+    slots[slot]->animSlot = -1;
+    int moved = batch.remove(slot);
+    if(moved >= 0) {
+        slots[slot] = slots[moved];
+        slots[slot]->animSlot = slot;
+    }
+    slots.pop_back();
+}
+
+void setCubeAnimation(Cube* cube, Animation const& animation) {
+    // animates from wherever it got to
+    stopCubePhysics(cube);
+    Pose base;
+    if(cube->animSlot >= 0) {
+        base = batch.getBase(cube->animSlot);
+        removeSlot(cube->animSlot);
+    } else {
+        auto t = cube->get_transform();
+        base = {t->get_position(), t->get_rotation()};
+    }
+    if(animation.motion != Motion::None) {
+        // the size is about the radius of the cube with its glow
+        cube->animSlot = batch.add(animation, base, cube->getSize());
+        slots.push_back(cube);
+    } else
+        cube->get_transform()->SetPositionAndRotation(base.pos, base.rot);
+    // animated cubes can't be drawn from static meshes
+    cube->refreshStatic();
+}
+
+void removeCubeAnimation(DefaultCube* cube) {
+    if(cube->animSlot >= 0)
+        removeSlot(cube->animSlot);
+}
+
+void animatedInfo(int slot, CubeInfo& info) {
+    auto base = batch.getBase(slot);
+    info.pos = base.pos;
+    info.rot = base.rot;
+    info.animation = batch.getAnimation(slot);
+}
+
+void moveAnimatedCube(DefaultCube* cube) {
+    auto t = cube->get_transform();
+    batch.setBase(cube->animSlot, unanimate(batch.getAnimation(cube->animSlot), {t->get_position(), t->get_rotation()}, animationClock));
+}
+
+void resizeAnimatedCube(DefaultCube* cube) {
+    batch.setRadius(cube->animSlot, cube->getSize());
+}
+
+void updateAnimations() {
+    if(batch.size() == 0)
+        return;
+    TRACE_ZONE("updateAnimations");
+    // scaled time is already stopped in the pause menu, this also covers pauses that don't set it
+    if(!(inGameplay && inMenu))
+        animationClock += UnityEngine::Time::get_deltaTime();
+
+    Math::Frustum frustum;
+    auto camera = UnityEngine::Camera::get_main();
+    if(camera) {
+        auto m = camera->get_cullingMatrix();
+        float rows[4][4] = {
+            {m.m00, m.m01, m.m02, m.m03},
+            {m.m10, m.m11, m.m12, m.m13},
+            {m.m20, m.m21, m.m22, m.m23},
+            {m.m30, m.m31, m.m32, m.m33}
+        };
+        frustum = Math::Frustum::fromMatrix(rows);
+    }
+    batch.evaluate(animationClock, camera ? &frustum : nullptr);
+
+    // transforms are the expensive part, so only cubes someone can see are moved
+    for(int i = 0; i < batch.size(); i++) {
+        auto cube = slots[i];
+        if(!batch.isVisible(i) || cube->isHeld() || !cube->get_gameObject()->get_activeSelf())
+            continue;
+        auto pose = batch.getPose(i);
+        cube->get_transform()->SetPositionAndRotation(pose.pos, pose.rot);
+        moveBroadphaseCube(cube);
+    }
+}
@@ -1,4 +1,5 @@
 #include "main.hpp"
+#include "shared/api.hpp"
 
 #include "conditional-dependencies/shared/main.hpp"
 
@@ -11,12 +12,13 @@ Qubes::QubesConfig& findConfig(std::string modName) {
         if(cfg.name == modName)
             return cfg;
     }
+    // logged directly since it crashes right after
     getLogger().info("No config found with name %s", modName.c_str());
     CRASH_UNLESS(false);
 }
 
 EXPOSE_API(RegisterConfig, void, std::string modName) {
-    getLogger().info("Registering config: %s", modName.c_str());
+    LOG_INFO("Registering config: %s", modName.c_str());
     QubesConfigs.push_back(Qubes::QubesConfig(modName));
 }
 
@@ -30,7 +32,7 @@ EXPOSE_API(SaveCube, void, UnityEngine::GameObject* ob, std::string modName) {
     // get cube object
     Qubes::Cube* cube;
     if(ob->TryGetComponent<Qubes::Cube*>(byref(cube)))
-        config.SetCubeValue(cube->index, Qubes::CubeInfo(cube));
+        config.SetCubeValue(cube->index, cube->getInfo());
 }
 
 EXPOSE_API(DeleteCube, void, UnityEngine::GameObject* ob, std::string modName) {
@@ -45,8 +47,10 @@ EXPOSE_API(DeleteCube, void, UnityEngine::GameObject* ob, std::string modName) {
 EXPOSE_API(CreateCube, UnityEngine::GameObject*, std::string modName, int index) {
     // find config
     auto& config = findConfig(modName);
+    if(!canMakeCube())
+        return nullptr;
     // default cube might not be made yet (but we want to use it if it is)
-    Qubes::CubeInfo defInfo = defaultCube ? CubeInfo(defaultCube) : QubesConfigs[1].cubes[0];
+    Qubes::CubeInfo defInfo = defaultCube ? defaultCube->getInfo() : QubesConfigs[1].cubes[0];
     // add a new cube?
     if(index >= config.cubes.size() || index < 0) {
         index = config.cubes.size();
@@ -59,4 +63,65 @@ EXPOSE_API(CreateCube, UnityEngine::GameObject*, std::string modName, int index)
         cubeArr.push_back(madeCube);
     }
     return madeCube->get_gameObject();
+}
+
+EXPOSE_API(GenerateCubes, int, std::string modName, int shape, int count, int seed) {
+    auto& config = findConfig(modName);
+    auto generator = configGenerator();
+    generator.shape = shape >= 0 && shape < (int) Qubes::Shape::Count ? (Qubes::Shape) shape : Qubes::Shape::Grid;
+    generator.count = count;
+    generator.seed = seed;
+    return generateCubes(generator, config);
+}
+
+EXPOSE_API(SetCubeAnimation, void, UnityEngine::GameObject* ob, int motion, float speed, float amount, std::vector<UnityEngine::Vector3> path) {
+    Qubes::Cube* cube;
+    if(!ob->TryGetComponent<Qubes::Cube*>(byref(cube)))
+        return;
+    Qubes::Animation animation(motion > 0 && motion < (int) Qubes::Motion::Count ? (Qubes::Motion) motion : Qubes::Motion::None);
+    animation.speed = speed;
+    animation.amount = amount;
+    animation.path.assign(path.begin(), path.end());
+    setCubeAnimation(cube, animation);
+}
+
+EXPOSE_API(SubscribeCuts, bool, Qubes::CutCallback callback, void* context) {
+    return cutBus.subscribe(callback, context);
+}
+
+EXPOSE_API(UnsubscribeCuts, bool, Qubes::CutCallback callback, void* context) {
+    return cutBus.unsubscribe(callback, context);
+}
+
+EXPOSE_API(AddHitAction, int, std::string name, Qubes::CutCallback callback, void* context) {
+    LOG_INFO("Adding hit action: %s", name.c_str());
+    return hitActions.add(name, callback, context);
+}
+
+EXPOSE_API(GetSnapshotSource, Qubes::SnapshotSource*, std::string modName) {
+    // the publisher is shared by copies of the config, so it stays put when QubesConfigs grows
+    return reinterpret_cast<Qubes::SnapshotSource*>(findConfig(modName).snapshots.get());
+}
+
+EXPOSE_API(AcquireSnapshot, Qubes::CubeSnapshot const*, Qubes::SnapshotSource* source) {
+    return reinterpret_cast<Qubes::SnapshotPublisher*>(source)->acquire();
+}
+
+EXPOSE_API(ReleaseSnapshot, void, Qubes::CubeSnapshot const* snapshot) {
+    Qubes::SnapshotPublisher::release(snapshot);
+}
+
+EXPOSE_API(GetMemoryUsage, Qubes::MemoryUsage) {
+    auto report = memoryReport();
+    return {
+        report.bytes[Memory::Cubes], report.bytes[Memory::Menus], report.bytes[Memory::Debris],
+        report.bytes[Memory::ConfigDom], report.bytes[Memory::Sprites], report.total, report.perCube, report.cubes
+    };
+}
+
+EXPOSE_API(CubeMemory, uint64_t, UnityEngine::GameObject* ob) {
+    Qubes::Cube* cube;
+    if(ob->TryGetComponent<Qubes::Cube*>(byref(cube)))
+        return cubeMemory(cube);
+    return 0;
 }
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "main.hpp"
+#include "core/sweep.hpp"
+
+#include "UnityEngine/BoxCollider.hpp"
+
+static SweepBVH bvh;
+// cubes by their id in the bvh
+static std::vector<Cube*> bvhCubes;
+static bool dirty = true;
+static bool collidersOff = false;
+static std::vector<SweepHit> hits;
+// animated or thrown cubes since the last sweep, only their boxes are updated
+static std::vector<Cube*> moved;
+
+// last frame's blade of each saber
+struct SaberState {
+    GlobalNamespace::Saber* saber;
+    BladeSweep blade;
+};
+static SaberState sabers[2];
+
+void markBroadphaseDirty() {
+    dirty = true;
+}
+
+void moveBroadphaseCube(Cube* cube) {
+    // a rebuild reads every cube anyway
+    if(dirty || cube->sweepId < 0)
+        return;
+    moved.push_back(cube);
+}
+
+// sabers only cut outside the pause menu
+static bool broadphaseActive() {
+    return getModConfig().Broadphase.GetValue() && inGameplay && !inMenu;
+}
+
+static void setColliders(bool enabled) {
+    for(auto cube : cubeArr)
+        cube->setColliderEnabled(enabled);
+    collidersOff = !enabled;
+}
+
+static void rebuild() {
+    TRACE_ZONE("broadphase rebuild");
+    std::vector<OBB> boxes;
+    boxes.reserve(cubeArr.size());
+    bvhCubes = cubeArr;
+    for(int i = 0; i < cubeArr.size(); i++) {
+        boxes.push_back(cubeArr[i]->getCutBounds());
+        cubeArr[i]->sweepId = i;
+    }
+    bvh.build(boxes);
+    // the game would cut them as well otherwise, cubes from the last build already have theirs off
+    setColliders(false);
+    moved.clear();
+    dirty = false;
+}
+
+static void refit() {
+    TRACE_ZONE("broadphase refit");
+    for(auto cube : moved) {
+        // could have been pooled since it moved
+        int id = cube->sweepId;
+        if(id >= 0 && id < bvhCubes.size() && bvhCubes[id] == cube)
+            bvh.update(id, cube->getCutBounds());
+    }
+    bvh.refit();
+    moved.clear();
+}
+
+void updateBroadphase() {
+    if(broadphaseActive())
+        return;
+    // give the colliders back for pointers and the game's cutting
+    if(collidersOff)
+        setColliders(true);
+    dirty = true;
+    sabers[0].saber = sabers[1].saber = nullptr;
+}
+
+void sweepSaber(GlobalNamespace::Saber* saber) {
+    if(!broadphaseActive())
+        return;
+    TRACE_ZONE("sweepSaber");
+    {
+        // ends before the cuts, handleCut counts its own time
+        FRAME_TIMER();
+        if(dirty || bvhCubes.size() != cubeArr.size())
+            rebuild();
+        else if(!moved.empty())
+            refit();
+
+        Math::Vec3 bottom = saber->get_saberBladeBottomPos();
+        Math::Vec3 top = saber->get_saberBladeTopPos();
+        // find this saber's slot, or take a free one
+        SaberState* state = sabers[0].saber == saber ? &sabers[0] : (sabers[1].saber == saber ? &sabers[1] : nullptr);
+        if(!state) {
+            state = !sabers[0].saber ? &sabers[0] : &sabers[1];
+            *state = {saber, {bottom, top, bottom, top}};
+            return;
+        }
+        state->blade.bottom = bottom;
+        state->blade.top = top;
+        hits.clear();
+        bvh.sweep(state->blade, hits);
+        state->blade.prevBottom = bottom;
+        state->blade.prevTop = top;
+    }
+
+    for(auto& hit : hits) {
+        // a hit action can pause or leave the level
+        if(!broadphaseActive())
+            break;
+        auto cube = bvhCubes[hit.id];
+        if(cube->cuttableNow())
+            cube->handleCut(saber, hit.cutPoint, hit.orientation, hit.cutDirVec);
+    }
+}
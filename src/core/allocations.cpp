@@ -0,0 +1,84 @@
+#include "core/allocations.hpp"
+
+#include <algorithm>
+
+using namespace Qubes;
+
+struct Site {
+    const char* name;
+    // written from any thread during the frame
+    std::atomic<uint32_t> frameCount, frameBytes;
+    // only touched in endFrame and takeReport, on the main thread
+    uint64_t count, bytes;
+    uint32_t peakBytes;
+};
+
+std::atomic<bool> Allocations::enabled = false;
+
+static Site sites[Allocations::MaxSites];
+static std::atomic<int> siteCount = 0;
+static int frames = 0, framesOverBudget = 0;
+
+int Allocations::registerSite(const char* name) {
+    // function local statics make this run once per call site
+    int site = siteCount.fetch_add(1, std::memory_order_relaxed);
+    if(site >= MaxSites)
+        return -1;
+    sites[site].name = name;
+    return site;
+}
+
+void Allocations::record(int site, size_t bytes) {
+    if(site < 0)
+        return;
+    sites[site].frameCount.fetch_add(1, std::memory_order_relaxed);
+    sites[site].frameBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+Allocations::Frame Allocations::endFrame(uint32_t budgetBytes) {
+    Frame frame = {0, 0, -1, false};
+    uint32_t topBytes = 0;
+    int count = std::min(siteCount.load(std::memory_order_relaxed), MaxSites);
+    for(int i = 0; i < count; i++) {
+        auto& site = sites[i];
+        uint32_t objects = site.frameCount.exchange(0, std::memory_order_relaxed);
+        uint32_t siteBytes = site.frameBytes.exchange(0, std::memory_order_relaxed);
+        if(objects == 0)
+            continue;
+        site.count += objects;
+        site.bytes += siteBytes;
+        site.peakBytes = std::max(site.peakBytes, siteBytes);
+        frame.count += objects;
+        frame.bytes += siteBytes;
+        if(siteBytes > topBytes) {
+            topBytes = siteBytes;
+            frame.topSite = i;
+        }
+    }
+    frames++;
+    frame.overBudget = frame.bytes > budgetBytes;
+    if(frame.overBudget)
+        framesOverBudget++;
+    return frame;
+}
+
+Allocations::Report Allocations::takeReport() {
+    Report report = {frames, framesOverBudget, {}};
+    int count = std::min(siteCount.load(std::memory_order_relaxed), MaxSites);
+    for(int i = 0; i < count; i++) {
+        auto& site = sites[i];
+        if(site.count > 0)
+            report.sites.push_back({site.name, site.count, site.bytes, site.peakBytes});
+        site.count = site.bytes = 0;
+        site.peakBytes = 0;
+    }
+    std::sort(report.sites.begin(), report.sites.end(), [](SiteReport const& a, SiteReport const& b) { return a.bytes > b.bytes; });
+    frames = framesOverBudget = 0;
+    return report;
+}
+
+const char* Allocations::siteName(int site) {
+    if(site < 0 || site >= MaxSites)
+        return "none";
+    return sites[site].name;
+}
@@ -0,0 +1,290 @@
+#include "core/animation.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Qubes;
+
+static const char* motionNames[] = { "None", "Bob", "Spin", "Orbit", "Path" };
+
+const char* Qubes::motionName(Motion motion) {
+    if((int) motion < 0 || motion >= Motion::Count)
+        return "Unknown";
+    return motionNames[(int) motion];
+}
+
+#pragma region json
+// hand edited or shared layouts may be missing anything, those keep the defaults
+static float number(rapidjson::Value const& obj, const char* name, float fallback) {
+    auto member = obj.FindMember(name);
+    return member != obj.MemberEnd() && member->value.IsNumber() ? member->value.GetFloat() : fallback;
+}
+
+// false leaves the vector as it was
+static bool vector(rapidjson::Value const& value, Math::Vec3& vector) {
+    if(!value.IsArray() || value.Size() != 3)
+        return false;
+    float xyz[3];
+    int i = 0;
+    for(auto& number : value.GetArray()) {
+        if(!number.IsNumber())
+            return false;
+        xyz[i++] = number.GetFloat();
+    }
+    vector = {xyz[0], xyz[1], xyz[2]};
+    return true;
+}
+
+Animation::Animation(rapidjson::Value const& obj) {
+    if(!obj.IsObject())
+        return;
+    auto member = obj.FindMember("motion");
+    if(member != obj.MemberEnd() && member->value.IsInt()) {
+        int value = member->value.GetInt();
+        motion = value > 0 && value < (int) Motion::Count ? (Motion) value : Motion::None;
+    }
+    speed = number(obj, "speed", speed);
+    amount = number(obj, "amount", amount);
+    phase = number(obj, "phase", phase);
+    member = obj.FindMember("axis");
+    if(member != obj.MemberEnd())
+        vector(member->value, axis);
+    member = obj.FindMember("path");
+    if(member != obj.MemberEnd() && member->value.IsArray()) {
+        for(auto& point : member->value.GetArray()) {
+            Math::Vec3 offset;
+            if(vector(point, offset))
+                path.push_back(offset);
+        }
+    }
+}
+
+rapidjson::Value Animation::ToJSON(rapidjson::Document::AllocatorType& allocator) const {
+    rapidjson::Value v(rapidjson::kObjectType);
+    v.AddMember("motion", (int) motion, allocator);
+    v.AddMember("speed", speed, allocator);
+    v.AddMember("amount", amount, allocator);
+    v.AddMember("phase", phase, allocator);
+    rapidjson::Value axis_arr(rapidjson::kArrayType);
+    axis_arr.PushBack(axis.x, allocator).PushBack(axis.y, allocator).PushBack(axis.z, allocator);
+    v.AddMember("axis", axis_arr, allocator);
+    if(!path.empty()) {
+        rapidjson::Value path_arr(rapidjson::kArrayType);
+        for(auto& point : path) {
+            rapidjson::Value arr(rapidjson::kArrayType);
+            arr.PushBack(point.x, allocator).PushBack(point.y, allocator).PushBack(point.z, allocator);
+            path_arr.PushBack(arr, allocator);
+        }
+        v.AddMember("path", path_arr, allocator);
+    }
+    return v;
+}
+#pragma endregion
+
+#pragma region evaluation
+// sin(2 pi turns), a polynomial without branches or calls so the batch loop vectorizes
+static inline float sinTurns(float turns) {
+    // to [-0.5, 0.5], adding and removing 1.5 * 2^23 rounds to the nearest integer
+    constexpr float roundMagic = 12582912;
+    float x = turns - ((turns + roundMagic) - roundMagic);
+    // then folded to [-0.25, 0.25] since sin(pi - x) = sin(x)
+    x = std::copysign(std::min(std::fabs(x), 0.5f - std::fabs(x)), x);
+    x *= 2 * Math::PI;
+    float x2 = x * x;
+    return x * (1 + x2 * (-1 / 6.0f + x2 * (1 / 120.0f + x2 * (-1 / 5040.0f + x2 * (1 / 362880.0f)))));
+}
+static inline float cosTurns(float turns) {
+    return sinTurns(turns + 0.25f);
+}
+
+// some direction perpendicular to axis
+static Math::Vec3 perpendicular(Math::Vec3 axis) {
+    auto other = Math::abs(axis.y) < 0.9f ? Math::Vec3::up() : Math::Vec3::right();
+    return Math::normalized(Math::cross(axis, other));
+}
+
+static Math::Vec3 pathOffset(std::vector<Math::Vec3> const& path, float turns) {
+    float along = (turns - std::floor(turns)) * path.size();
+    int from = std::min((int) along, (int) path.size() - 1);
+    int to = (from + 1) % path.size();
+    return Math::lerp(path[from], path[to], along - from);
+}
+
+static float loopTurns(Animation const& animation, float time) {
+    return animation.speed * time + animation.phase;
+}
+
+Pose Qubes::animate(Animation const& animation, Pose const& base, float time) {
+    float turns = loopTurns(animation, time);
+    Math::Vec3 axis = Math::normalized(animation.axis);
+    switch(animation.motion) {
+        case Motion::Bob:
+            return {base.pos + base.rot * axis * (animation.amount * sinTurns(turns)), base.rot};
+        case Motion::Spin: {
+            float s = sinTurns(turns * 0.5f);
+            return {base.pos, base.rot * Math::Quat(axis.x * s, axis.y * s, axis.z * s, cosTurns(turns * 0.5f))};
+        }
+        case Motion::Orbit: {
+            // the saved position is on the circle, so cubes start where they were placed
+            auto u = perpendicular(axis) * animation.amount;
+            auto v = Math::cross(axis, u);
+            return {base.pos + base.rot * (u * (cosTurns(turns) - 1) + v * sinTurns(turns)), base.rot};
+        }
+        case Motion::Path:
+            if(animation.moves())
+                return {base.pos + base.rot * pathOffset(animation.path, turns), base.rot};
+            return base;
+        default:
+            return base;
+    }
+}
+
+Pose Qubes::unanimate(Animation const& animation, Pose const& animated, float time) {
+    // spin is the only one that rotates, and the others only move relative to the base rotation
+    Math::Quat rot = animated.rot;
+    if(animation.motion == Motion::Spin) {
+        Pose spun = animate(animation, {Math::Vec3::zero(), Math::Quat::identity()}, time);
+        rot = animated.rot * Math::inverse(spun.rot);
+    }
+    Pose offset = animate(animation, {Math::Vec3::zero(), rot}, time);
+    return {animated.pos - offset.pos, rot};
+}
+#pragma endregion
+
+#pragma region batch
+#if defined(__clang__)
+#define IGNORE_ALIASING _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define IGNORE_ALIASING _Pragma("GCC ivdep")
+#else
+#define IGNORE_ALIASING
+#endif
+
+int AnimationBatch::add(Animation const& animation, Pose const& base, float radius) {
+    int slot = animations.size();
+    animations.push_back(animation);
+    bases.push_back(base);
+    paths.emplace_back();
+    for(auto array : {&baseX, &baseY, &baseZ, &baseRotX, &baseRotY, &baseRotZ, &baseRotW, &uX, &uY, &uZ, &vX, &vY, &vZ,
+                      &axisX, &axisY, &axisZ, &speed, &phase, &spin, &radii, &posX, &posY, &posZ, &rotX, &rotY, &rotZ, &rotW})
+        array->push_back(0);
+    visible.push_back(0);
+    radii[slot] = radius;
+    prepare(slot);
+    return slot;
+}
+
+int AnimationBatch::remove(int slot) {
+    int last = animations.size() - 1;
+    auto move = [slot, last](auto& array) {
+        array[slot] = std::move(array[last]);
+        array.pop_back();
+    };
+    move(animations);
+    move(bases);
+    move(paths);
+    for(auto array : {&baseX, &baseY, &baseZ, &baseRotX, &baseRotY, &baseRotZ, &baseRotW, &uX, &uY, &uZ, &vX, &vY, &vZ,
+                      &axisX, &axisY, &axisZ, &speed, &phase, &spin, &radii, &posX, &posY, &posZ, &rotX, &rotY, &rotZ, &rotW})
+        move(*array);
+    move(visible);
+    return slot == last ? -1 : last;
+}
+
+void AnimationBatch::clear() {
+    while(size() > 0)
+        remove(size() - 1);
+}
+
+void AnimationBatch::setBase(int slot, Pose const& base) {
+    bases[slot] = base;
+    prepare(slot);
+}
+
+void AnimationBatch::prepare(int slot) {
+    auto& animation = animations[slot];
+    auto& base = bases[slot];
+    Math::Vec3 axis = Math::normalized(animation.axis);
+    Math::Vec3 u = Math::Vec3::zero(), v = Math::Vec3::zero();
+    if(animation.motion == Motion::Bob)
+        v = base.rot * axis * animation.amount;
+    else if(animation.motion == Motion::Orbit) {
+        auto localU = perpendicular(axis) * animation.amount;
+        u = base.rot * localU;
+        v = base.rot * Math::cross(axis, localU);
+    }
+    baseX[slot] = base.pos.x; baseY[slot] = base.pos.y; baseZ[slot] = base.pos.z;
+    baseRotX[slot] = base.rot.x; baseRotY[slot] = base.rot.y; baseRotZ[slot] = base.rot.z; baseRotW[slot] = base.rot.w;
+    uX[slot] = u.x; uY[slot] = u.y; uZ[slot] = u.z;
+    vX[slot] = v.x; vY[slot] = v.y; vZ[slot] = v.z;
+    axisX[slot] = axis.x; axisY[slot] = axis.y; axisZ[slot] = axis.z;
+    // a stopped cube still gets a pose, its base
+    bool moves = animation.moves();
+    speed[slot] = moves ? animation.speed : 0;
+    phase[slot] = animation.phase;
+    spin[slot] = moves && animation.motion == Motion::Spin ? 0.5f : 0;
+
+    // paths are rare, kept in world space and added after the main loop
+    paths[slot].clear();
+    if(moves && animation.motion == Motion::Path) {
+        for(auto& point : animation.path)
+            paths[slot].push_back(base.rot * point);
+    }
+}
+
+void AnimationBatch::evaluate(float time, Math::Frustum const* frustum) {
+    int count = size();
+    float const* bx = baseX.data(), * by = baseY.data(), * bz = baseZ.data();
+    float const* brx = baseRotX.data(), * bry = baseRotY.data(), * brz = baseRotZ.data(), * brw = baseRotW.data();
+    float const* ux = uX.data(), * uy = uY.data(), * uz = uZ.data();
+    float const* vx = vX.data(), * vy = vY.data(), * vz = vZ.data();
+    float const* nx = axisX.data(), * ny = axisY.data(), * nz = axisZ.data();
+    float const* sp = speed.data(), * ph = phase.data(), * sn = spin.data();
+    float* px = posX.data(), * py = posY.data(), * pz = posZ.data();
+    float* rx = rotX.data(), * ry = rotY.data(), * rz = rotZ.data(), * rw = rotW.data();
+
+    // outputs never alias the inputs, the compiler can't tell on its own with this many arrays
+    IGNORE_ALIASING
+    for(int i = 0; i < count; i++) {
+        float turns = sp[i] * time + ph[i];
+        float c = cosTurns(turns) - 1, s = sinTurns(turns);
+        px[i] = bx[i] + c * ux[i] + s * vx[i];
+        py[i] = by[i] + c * uy[i] + s * vy[i];
+        pz[i] = bz[i] + c * uz[i] + s * vz[i];
+
+        // base * (axis * sin(half), cos(half)), half is 0 unless spinning
+        float half = turns * sn[i];
+        float hs = sinTurns(half), hc = cosTurns(half);
+        float qx = nx[i] * hs, qy = ny[i] * hs, qz = nz[i] * hs;
+        float ax = brx[i], ay = bry[i], az = brz[i], aw = brw[i];
+        rx[i] = aw * qx + ax * hc + ay * qz - az * qy;
+        ry[i] = aw * qy + ay * hc + az * qx - ax * qz;
+        rz[i] = aw * qz + az * hc + ax * qy - ay * qx;
+        rw[i] = aw * hc - ax * qx - ay * qy - az * qz;
+    }
+
+    for(int i = 0; i < count; i++) {
+        if(paths[i].empty())
+            continue;
+        auto offset = pathOffset(paths[i], speed[i] * time + phase[i]);
+        posX[i] += offset.x;
+        posY[i] += offset.y;
+        posZ[i] += offset.z;
+    }
+
+    if(!frustum) {
+        std::fill(visible.begin(), visible.end(), 1);
+        return;
+    }
+    // all six planes without an early out, so this vectorizes too
+    float const* r = radii.data();
+    uint8_t* v = visible.data();
+    Math::Frustum planes = *frustum;
+    IGNORE_ALIASING
+    for(int i = 0; i < count; i++) {
+        bool inside = true;
+        for(auto& plane : planes.planes)
+            inside &= plane[0] * px[i] + plane[1] * py[i] + plane[2] * pz[i] + plane[3] >= -r[i];
+        v[i] = inside;
+    }
+}
+#pragma endregion
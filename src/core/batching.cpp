@@ -0,0 +1,106 @@
+#include "core/batching.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Qubes;
+
+static uint32_t channel(float value) {
+    return std::lround(std::clamp(value, 0.0f, 1.0f) * 255);
+}
+
+uint32_t Qubes::colorKey(Math::Color color) {
+    return channel(color.r) << 24 | channel(color.g) << 16 | channel(color.b) << 8 | channel(color.a);
+}
+
+int StaticBatches::add(uint32_t color) {
+    int id;
+    if(!freeIds.empty()) {
+        id = freeIds.back();
+        freeIds.pop_back();
+    } else {
+        id = entries.size();
+        entries.emplace_back();
+    }
+    place(id, color);
+    members++;
+    return id;
+}
+
+void StaticBatches::remove(int id) {
+    unplace(id);
+    entries[id] = {};
+    freeIds.push_back(id);
+    members--;
+}
+
+void StaticBatches::setColor(int id, uint32_t color) {
+    if(chunks[entries[id].chunk].color == color)
+        return;
+    unplace(id);
+    place(id, color);
+}
+
+void StaticBatches::markDirty(int id) {
+    setDirty(entries[id].chunk);
+}
+
+void StaticBatches::clear() {
+    // keep the chunks so the caller can empty their meshes
+    for(int i = 0; i < (int) chunks.size(); i++) {
+        chunks[i].members.clear();
+        setDirty(i);
+    }
+    entries.clear();
+    freeIds.clear();
+    members = 0;
+}
+
+void StaticBatches::takeDirty(std::vector<int>& out) {
+    out.clear();
+    out.swap(dirtyChunks);
+    for(int chunk : out)
+        chunks[chunk].dirty = false;
+}
+
+void StaticBatches::place(int id, uint32_t color) {
+    auto& list = byColor[color];
+    // colors only have a few chunks
+    auto open = std::find_if(list.begin(), list.end(), [this](int chunk) { return (int) chunks[chunk].members.size() < limit; });
+    int chunk;
+    if(open != list.end())
+        chunk = *open;
+    else {
+        // reuse an emptied chunk of another color before making a new one
+        auto empty = std::find_if(chunks.begin(), chunks.end(), [](Chunk const& chunk) { return chunk.members.empty(); });
+        chunk = empty - chunks.begin();
+        if(empty == chunks.end())
+            chunks.push_back({color, {}, false});
+        else {
+            auto& old = byColor[empty->color];
+            old.erase(std::find(old.begin(), old.end(), chunk));
+            empty->color = color;
+        }
+        list.push_back(chunk);
+    }
+    entries[id] = {chunk, (int) chunks[chunk].members.size()};
+    chunks[chunk].members.push_back(id);
+    setDirty(chunk);
+}
+
+void StaticBatches::unplace(int id) {
+    auto entry = entries[id];
+    auto& members = chunks[entry.chunk].members;
+    int moved = members.back();
+    members[entry.slot] = moved;
+    entries[moved].slot = entry.slot;
+    members.pop_back();
+    setDirty(entry.chunk);
+}
+
+void StaticBatches::setDirty(int chunk) {
+    if(chunks[chunk].dirty)
+        return;
+    chunks[chunk].dirty = true;
+    dirtyChunks.push_back(chunk);
+}
@@ -0,0 +1,197 @@
+#include "core/cubeinfo.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Qubes;
+
+#pragma region macros
+// the math types are plain floats, so they can be indexed like the arrays they are saved as
+#define SetArr(name, num) auto name##_arr = obj[#name].GetArray(); \
+for(int i = 0; i < name##_arr.Size() && i < num; i++) { \
+    reinterpret_cast<float*>(&name)[i] = name##_arr[i].GetFloat(); \
+}
+#define JSONArr(name, num) rapidjson::Value name##_arr(rapidjson::kArrayType); \
+for(int i = 0; i < num; i++) { \
+    name##_arr.PushBack(reinterpret_cast<const float*>(&name)[i], allocator); \
+} \
+v.AddMember(#name, name##_arr, allocator)
+#pragma endregion
+
+CubeInfo::CubeInfo(Math::Vec3 in_pos, Math::Quat in_rot, Math::Color in_color, int in_type, int in_hitAction, float in_size, bool in_locked) {
+    pos = in_pos;
+    rot = in_rot;
+    color = in_color;
+    type = in_type;
+    hitAction = in_hitAction;
+    size = in_size;
+    locked = in_locked;
+}
+
+CubeInfo::CubeInfo(rapidjson::Value& obj) {
+    // reads values from given "subconfig"
+    SetArr(pos, 3);
+    SetArr(rot, 4);
+    SetArr(color, 4);
+    type = obj["type"].GetInt();
+    hitAction = obj["hitAction"].GetInt();
+    size = obj["size"].GetFloat();
+    locked = obj["locked"].GetBool();
+    if(obj.HasMember("animation"))
+        animation = Animation(obj["animation"]);
+}
+
+rapidjson::Value CubeInfo::ToJSON(rapidjson::Document::AllocatorType& allocator) const {
+    // returns a json object with its info
+    rapidjson::Value v(rapidjson::kObjectType);
+    JSONArr(pos, 3);
+    JSONArr(rot, 4);
+    JSONArr(color, 4);
+    v.AddMember("type", type, allocator);
+    v.AddMember("hitAction", hitAction, allocator);
+    v.AddMember("size", size, allocator);
+    v.AddMember("locked", locked, allocator);
+    if(animation.motion != Motion::None)
+        v.AddMember("animation", animation.ToJSON(allocator), allocator);
+    return v;
+}
+
+#pragma region validation
+static bool numbers(rapidjson::Value const& obj, const char* name, int count) {
+    auto member = obj.FindMember(name);
+    if(member == obj.MemberEnd() || !member->value.IsArray() || member->value.Size() < count)
+        return false;
+    for(auto& value : member->value.GetArray()) {
+        if(!value.IsNumber())
+            return false;
+    }
+    return true;
+}
+
+static bool has(rapidjson::Value const& obj, const char* name, bool (rapidjson::Value::*check)() const) {
+    auto member = obj.FindMember(name);
+    return member != obj.MemberEnd() && (member->value.*check)();
+}
+
+static bool validAnimation(rapidjson::Value const& obj) {
+    if(!obj.IsObject() || !has(obj, "motion", &rapidjson::Value::IsInt) || !numbers(obj, "axis", 0))
+        return false;
+    for(auto name : {"speed", "amount", "phase"}) {
+        if(!has(obj, name, &rapidjson::Value::IsNumber))
+            return false;
+    }
+    auto path = obj.FindMember("path");
+    if(path == obj.MemberEnd())
+        return true;
+    if(!path->value.IsArray())
+        return false;
+    for(auto& point : path->value.GetArray()) {
+        if(!point.IsArray())
+            return false;
+        for(auto& value : point.GetArray()) {
+            if(!value.IsNumber())
+                return false;
+        }
+    }
+    return true;
+}
+
+bool Qubes::validCube(rapidjson::Value const& obj, std::string* error) {
+    auto fail = [error](const char* what) {
+        if(error)
+            *error = what;
+        return false;
+    };
+    if(!obj.IsObject())
+        return fail("not an object");
+    if(!numbers(obj, "pos", 3) || !numbers(obj, "rot", 4) || !numbers(obj, "color", 4))
+        return fail("pos, rot or color is missing or too short");
+    if(!has(obj, "type", &rapidjson::Value::IsInt) || !has(obj, "hitAction", &rapidjson::Value::IsInt))
+        return fail("type or hitAction is missing or not an integer");
+    if(!has(obj, "size", &rapidjson::Value::IsNumber))
+        return fail("size is missing or not a number");
+    if(!has(obj, "locked", &rapidjson::Value::IsBool))
+        return fail("locked is missing or not a bool");
+    auto animation = obj.FindMember("animation");
+    if(animation != obj.MemberEnd() && !validAnimation(animation->value))
+        return fail("animation is malformed");
+    return true;
+}
+#pragma endregion
+
+#pragma region diff
+// only has to separate cubes that differ, equal ones are checked with == after
+static uint64_t cubeHash(CubeInfo const& cube) {
+    float values[] = {cube.pos.x, cube.pos.y, cube.pos.z, cube.rot.x, cube.rot.y, cube.rot.z, cube.rot.w,
+        cube.color.r, cube.color.g, cube.color.b, cube.color.a, cube.size};
+    uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](uint32_t value) {
+        hash = (hash ^ value) * 1099511628211ull;
+    };
+    for(float value : values) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        mix(bits);
+    }
+    mix(cube.type);
+    mix(cube.hitAction);
+    mix(cube.locked);
+    mix((uint32_t) cube.animation.motion);
+    return hash;
+}
+
+bool LayoutDiff::empty() const {
+    if(!changed.empty() || !removed.empty())
+        return false;
+    for(int i = 0; i < source.size(); i++) {
+        if(source[i] != i)
+            return false;
+    }
+    return true;
+}
+
+LayoutDiff Qubes::diffLayouts(std::vector<CubeInfo> const& from, std::vector<CubeInfo> const& to) {
+    LayoutDiff diff;
+    diff.source.assign(to.size(), -1);
+
+    std::vector<std::pair<uint64_t, int>> hashes;
+    hashes.reserve(from.size());
+    for(int i = 0; i < from.size(); i++)
+        hashes.emplace_back(cubeHash(from[i]), i);
+    std::sort(hashes.begin(), hashes.end());
+    std::vector<bool> used(from.size());
+
+    // cubes that are the same in both, so moving one in the array doesn't touch it
+    std::vector<int> unmatched;
+    for(int i = 0; i < to.size(); i++) {
+        auto range = std::equal_range(hashes.begin(), hashes.end(), std::make_pair(cubeHash(to[i]), -1), [](auto const& a, auto const& b) {
+            return a.first < b.first;
+        });
+        for(auto it = range.first; it != range.second; it++) {
+            if(!used[it->second] && from[it->second] == to[i]) {
+                used[it->second] = true;
+                diff.source[i] = it->second;
+                break;
+            }
+        }
+        if(diff.source[i] < 0)
+            unmatched.push_back(i);
+    }
+    // the rest of the old cubes are updated in order, anything left over is added or removed
+    int old = 0;
+    for(int i : unmatched) {
+        while(old < from.size() && used[old])
+            old++;
+        if(old == from.size())
+            break;
+        used[old] = true;
+        diff.source[i] = old;
+        diff.changed.push_back(i);
+    }
+    for(int i = 0; i < from.size(); i++) {
+        if(!used[i])
+            diff.removed.push_back(i);
+    }
+    return diff;
+}
+#pragma endregion
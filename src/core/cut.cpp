@@ -0,0 +1,35 @@
+#include "core/cut.hpp"
+
+using namespace Qubes;
+
+bool Qubes::cutDirectionOk(Math::Vec3 dir, float angleTolerance) {
+    // cuts straight through the face don't count
+    bool flag = Math::abs(dir.z) > Math::abs(dir.x) * 10 && Math::abs(dir.z) > Math::abs(dir.y) * 10;
+    float cutDirAngle = Math::atan2(dir.y, dir.x) * Math::Rad2Deg;
+    return !flag && cutDirAngle > -90 - angleTolerance && cutDirAngle < -90 + angleTolerance;
+}
+
+CutPlane Qubes::localCutPlane(Math::Vec3 notePos, Math::Quat noteRot, Math::Vec3 cutPoint, Math::Vec3 cutNormal, float maxCenterDistance) {
+    Math::Quat inv = Math::inverse(noteRot);
+    Math::Vec3 point = inv * (cutPoint - notePos);
+    Math::Vec3 normal = inv * cutNormal;
+    float sqrMagnitude = Math::sqrMagnitude(point);
+    if(sqrMagnitude > maxCenterDistance * maxCenterDistance)
+        point = point * (maxCenterDistance / std::sqrt(sqrMagnitude));
+    return {normal, -Math::dot(normal, point)};
+}
+
+Math::Vec3 Qubes::debrisCenter(Math::Vec3 const* vertices, int count, CutPlane const& plane) {
+    // copied from NoteDebris.Init, the length includes the offset there too
+    float length = std::sqrt(Math::dot(plane.normal, plane.normal) + plane.offset * plane.offset);
+    Math::Vec3 sum = Math::Vec3::zero();
+    for(int i = 0; i < count; i++) {
+        Math::Vec3 vertex = vertices[i];
+        float dist = Math::dot(plane.normal, vertex) + plane.offset;
+        // project vertices on the other side onto the plane
+        if(dist < 0)
+            vertex -= plane.normal * (dist / length);
+        sum += vertex;
+    }
+    return count > 0 ? sum / count : sum;
+}
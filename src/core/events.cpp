@@ -0,0 +1,108 @@
+#include "core/events.hpp"
+#include "core/trace.hpp"
+
+#include <algorithm>
+
+using namespace Qubes;
+
+#pragma region cutBus
+bool CutBus::subscribe(CutCallback callback, void* context) {
+    for(auto& subscriber : subscribers) {
+        if(subscriber.callback == callback && subscriber.context == context)
+            return false;
+    }
+    subscribers.push_back({callback, context});
+    return true;
+}
+
+bool CutBus::unsubscribe(CutCallback callback, void* context) {
+    auto found = std::find_if(subscribers.begin(), subscribers.end(), [callback, context](Subscriber const& subscriber) {
+        return subscriber.callback == callback && subscriber.context == context;
+    });
+    if(found == subscribers.end())
+        return false;
+    // erasing would shift the ones a dispatch hasn't reached yet
+    if(depth > 0) {
+        found->callback = nullptr;
+        removed = true;
+    } else
+        subscribers.erase(found);
+    return true;
+}
+
+void CutBus::dispatch(CutEvent const& event) {
+    TRACE_ZONE("CutBus::dispatch");
+    depth++;
+    // by index with the size from the start, subscribing can reallocate
+    int count = subscribers.size();
+    for(int i = 0; i < count; i++) {
+        auto subscriber = subscribers[i];
+        if(subscriber.callback)
+            subscriber.callback(event, subscriber.context);
+    }
+    // an outer dispatch is still going through the subscribers by index
+    if(--depth > 0 || !removed)
+        return;
+    subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(), [](Subscriber const& subscriber) {
+        return subscriber.callback == nullptr;
+    }), subscribers.end());
+    removed = false;
+}
+#pragma endregion
+
+#pragma region hitActionTable
+int Qubes::hitActionId(std::string const& name) {
+    // fnv-1a, it has to stay the same between versions since cubes save it
+    uint32_t hash = 2166136261u;
+    for(char c : name)
+        hash = (hash ^ (uint8_t) c) * 16777619u;
+    return std::max((int) (hash & 0x7fffffff), HitActionTable::FirstAddedId);
+}
+
+int HitActionTable::add(std::string name, CutCallback callback, void* context) {
+    for(auto& action : actions) {
+        if(action.name == name) {
+            action.callback = callback;
+            action.context = context;
+            return action.id;
+        }
+    }
+    int id = hitActionId(name);
+    // two names with the same hash, the later one moves along
+    while(index(id) >= 0)
+        id = id == INT32_MAX ? FirstAddedId : id + 1;
+    actions.push_back({id, std::move(name), callback, context});
+    return id;
+}
+
+void HitActionTable::addBuiltin(int id, std::string name, CutCallback callback, void* context) {
+    actions.push_back({id, std::move(name), callback, context});
+}
+
+int HitActionTable::id(int index) const {
+    if(index < 0 || index >= (int) actions.size())
+        return -1;
+    return actions[index].id;
+}
+
+int HitActionTable::index(int id) const {
+    for(int i = 0; i < (int) actions.size(); i++) {
+        if(actions[i].id == id)
+            return i;
+    }
+    return -1;
+}
+
+std::string const& HitActionTable::name(int id) const {
+    static const std::string unknown = "Unknown";
+    int i = index(id);
+    return i < 0 ? unknown : actions[i].name;
+}
+
+void HitActionTable::run(int id, CutEvent const& event) const {
+    int i = index(id);
+    if(i < 0 || !actions[i].callback)
+        return;
+    actions[i].callback(event, actions[i].context);
+}
+#pragma endregion
@@ -0,0 +1,149 @@
+#include "core/generator.hpp"
+#include "core/trace.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+
+using namespace Qubes;
+
+// where the player's head usually is in the menu
+static constexpr Math::Vec3 Head = {0, 1.5, 0};
+// stacked rings of the grid
+static constexpr int GridLayers = 4;
+// half the diagonal of a cube of size 1, cubes are half a meter across
+static const float HalfDiagonal = 0.25f * std::sqrt(3.0f);
+// points whose distance from the floor is drawn again before giving up and lifting them
+static constexpr int FloorTries = 64;
+
+const char* Qubes::shapeName(Shape shape) {
+    static const char* names[] = {"Grid", "Sphere", "Spiral", "Cloud"};
+    return shape >= Shape::Grid && shape < Shape::Count ? names[(int) shape] : "Unknown";
+}
+
+#pragma region shapes
+// upright and facing the player, rolled to one of the eight cut directions
+static Math::Quat facePlayer(Math::Vec3 pos, Math::Random& random) {
+    Math::Vec3 away = pos - Head;
+    away.y = 0;
+    if(Math::magnitude(away) < 0.001)
+        away = {0, 0, 1};
+    float roll = 45 * (random.next() % 8);
+    return Math::lookRotation(Math::normalized(away)) * Math::angleAxis(roll, {0, 0, 1});
+}
+
+// the lowest a cube's center can be without any rotation of it reaching into the floor
+static float lowest(Generator const& generator) {
+    return generator.base.size * HalfDiagonal;
+}
+
+// square rings around the player on a few layers, each ring filled before the next one out
+static void grid(Generator const& generator, std::vector<Math::Vec3>& points) {
+    int ring = std::max(1, (int) std::ceil(generator.clearance / generator.spacing));
+    int cell = 0;
+    while((int) points.size() < generator.count) {
+        // the four sides of the ring, each starting at a corner
+        int side = cell / (2 * ring), offset = cell % (2 * ring) - ring;
+        int x, z;
+        switch(side) {
+            case 0: x = offset; z = -ring; break;
+            case 1: x = ring; z = offset; break;
+            case 2: x = -offset; z = ring; break;
+            default: x = -ring; z = -offset; break;
+        }
+        for(int layer = 0; layer < GridLayers && (int) points.size() < generator.count; layer++)
+            points.push_back(Math::Vec3{(float) x, 0, (float) z} * generator.spacing + Math::Vec3{0, std::max(0.5f, lowest(generator)) + layer * generator.spacing, 0});
+        if(++cell == 8 * ring) {
+            cell = 0;
+            ring++;
+        }
+    }
+}
+
+// evenly spread over the part of a shell around the head that's above the floor, big enough for spacing between them
+static void sphere(Generator const& generator, std::vector<Math::Vec3>& points) {
+    int count = generator.count;
+    // a band of a sphere has an area in proportion to its height, so the radius is for the part that's kept
+    // which depends on the radius, a few rounds settle it
+    float radius = std::max(generator.clearance, generator.spacing * std::sqrt(count / (4 * Math::PI)));
+    for(int i = 0; i < 8; i++) {
+        float bottom = std::clamp((lowest(generator) - Head.y) / radius, -1.0f, 1.0f);
+        radius = std::max(generator.clearance, generator.spacing * std::sqrt(count / (2 * Math::PI * std::max(1 - bottom, 0.01f))));
+    }
+    float bottom = std::clamp((lowest(generator) - Head.y) / radius, -1.0f, 1.0f);
+    // fibonacci lattice, uniform in height is uniform over the band
+    float golden = Math::PI * (3 - std::sqrt(5.0f));
+    for(int i = 0; i < count; i++) {
+        float y = 1 - (1 - bottom) * (i + 0.5f) / count;
+        float r = std::sqrt(1 - y * y);
+        float angle = golden * i;
+        points.push_back(Head + Math::Vec3{r * std::cos(angle), y, r * std::sin(angle)} * radius);
+    }
+}
+
+// flat and outwards from the clearance, arms and neighbours spacing apart
+static void spiral(Generator const& generator, std::vector<Math::Vec3>& points) {
+    float growth = generator.spacing / (2 * Math::PI);
+    float angle = 0, radius = std::max(generator.clearance, generator.spacing);
+    for(int i = 0; i < generator.count; i++) {
+        points.push_back({radius * std::cos(angle), std::max(Head.y - 0.3f, lowest(generator)), radius * std::sin(angle)});
+        float step = generator.spacing / radius;
+        angle += step;
+        radius += growth * step;
+    }
+}
+
+// uniform in a shell around the head, random points crowd together so it's twice as roomy as the spacing
+// points under the floor are drawn again, so big clouds are denser than that where the floor cuts them off
+static void cloud(Generator const& generator, std::vector<Math::Vec3>& points, Math::Random& random) {
+    float inner = std::pow(generator.clearance, 3.0f);
+    float outer = inner + generator.count * std::pow(2 * generator.spacing, 3.0f) * 3 / (4 * Math::PI);
+    float floor = lowest(generator);
+    for(int i = 0; i < generator.count; i++) {
+        Math::Vec3 point;
+        for(int tries = 0; tries < FloorTries; tries++) {
+            point = Head + random.onUnitSphere() * std::cbrt(random.range(inner, outer));
+            if(point.y >= floor)
+                break;
+        }
+        point.y = std::max(point.y, floor);
+        points.push_back(point);
+    }
+}
+
+std::vector<CubeInfo> Generator::generate() const {
+    TRACE_ZONE("Generator::generate");
+    std::vector<Math::Vec3> points;
+    if(count <= 0 || spacing <= 0)
+        return {};
+    points.reserve(count);
+    Math::Random random(seed);
+    switch(shape) {
+        case Shape::Grid: grid(*this, points); break;
+        case Shape::Sphere: sphere(*this, points); break;
+        case Shape::Spiral: spiral(*this, points); break;
+        case Shape::Cloud: cloud(*this, points, random); break;
+        default: break;
+    }
+    std::vector<CubeInfo> cubes;
+    cubes.reserve(points.size());
+    for(auto& point : points) {
+        cubes.push_back(base);
+        cubes.back().pos = point;
+        cubes.back().rot = facePlayer(point, random);
+    }
+    return cubes;
+}
+#pragma endregion
+
+std::string Qubes::stressCsv(std::vector<StressResult> const& results) {
+    std::string csv = "shape,cubes,create_ms,save_ms,load_ms,frame_ms_p50,frame_ms_p99,memory_bytes\n";
+    char line[256];
+    for(auto& result : results) {
+        snprintf(line, sizeof(line), "%s,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%" PRIu64 "\n", shapeName(result.shape), result.cubes,
+            result.createMs, result.saveMs, result.loadMs, result.frameMsP50, result.frameMsP99, result.memoryBytes);
+        csv += line;
+    }
+    return csv;
+}
@@ -0,0 +1,65 @@
+#include "core/governor.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Qubes;
+
+const char* Qubes::tierName(QualityTier tier) {
+    switch(tier) {
+        case QualityTier::Full: return "Full";
+        case QualityTier::LightDebris: return "Light Debris";
+        case QualityTier::CappedDebris: return "Capped Debris";
+        case QualityTier::NoDistantGlow: return "No Distant Glow";
+        case QualityTier::NoDebris: return "No Debris";
+        default: return "Unknown";
+    }
+}
+
+bool Governor::update(float deltaTime, float refreshRate, GovernorSettings const& settings) {
+    if(deltaTime <= 0 || refreshRate <= 0)
+        return false;
+    // from the display rather than from measured frames, which would drift to the slow ones under constant load
+    interval = 1 / refreshRate;
+
+    // frame rate independent smoothing of whether frames are missed
+    float wasMissed = deltaTime > interval * settings.missedFrame ? 1 : 0;
+    float blend = 1 - std::exp(-deltaTime / settings.smoothing);
+    missed += (wasMissed - missed) * blend;
+
+    int step = 0;
+    if(missed > settings.stepDownAbove && tier != QualityTier::NoDebris)
+        step = 1;
+    else if(missed < settings.stepUpBelow && tier != QualityTier::Full)
+        step = -1;
+    // anything in between holds the current tier
+    if(step == 0) {
+        heldFor = 0;
+        return false;
+    }
+    heldFor += deltaTime;
+    if(heldFor < (step > 0 ? settings.stepDownAfter : settings.stepUpAfter))
+        return false;
+    tier = (QualityTier) ((int) tier + step);
+    heldFor = 0;
+    // measure the new tier from scratch, so one bad second doesn't skip straight to the bottom
+    if(step > 0)
+        missed = settings.stepUpBelow + (settings.stepDownAbove - settings.stepUpBelow) / 2;
+    return true;
+}
+
+void Governor::reset() {
+    tier = QualityTier::Full;
+    missed = heldFor = interval = 0;
+}
+
+void RateLimiter::update(float deltaTime, float rate, float burst) {
+    tokens = std::min(tokens + rate * deltaTime, burst);
+}
+
+bool RateLimiter::take() {
+    if(tokens < 1)
+        return false;
+    tokens -= 1;
+    return true;
+}
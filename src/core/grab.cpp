@@ -0,0 +1,64 @@
+#include "core/grab.hpp"
+
+#include <cmath>
+
+using namespace Qubes;
+
+void Grab::begin(Pose const& controller, Pose const& cube) {
+    Math::Quat inv = Math::inverse(controller.rot);
+    pos = inv * (cube.pos - controller.pos);
+    rot = inv * cube.rot;
+}
+
+void Grab::applyThumbsticks(float horizontal, float vertical, bool usedRight, GrabSettings const& settings, float cubeSize, float deltaTime) {
+    // thumbstick movement
+    if(usedRight == !settings.leftThumbMove) {
+        float diff = vertical * deltaTime * settings.moveSpeed;
+        // no movement if too close
+        if(Math::magnitude(pos) < 0.5 * cubeSize && diff > 0)
+            diff = 0;
+        pos = pos - (Math::Vec3::forward() * diff);
+    }
+    // thumbstick rotation
+    if(usedRight == settings.leftThumbMove) {
+        // scale values to a reasonable "1" speed
+        float v_move = -20 * vertical * deltaTime * settings.rotSpeed;
+        float h_move = -20 * horizontal * deltaTime * settings.rotSpeed;
+        auto extraRot = Math::euler(0, h_move, 0) * Math::euler(v_move, 0, 0);
+        rot = rot * extraRot;
+    }
+}
+
+Pose Grab::target(Pose const& controller) const {
+    return {controller.pos + controller.rot * pos, controller.rot * rot};
+}
+
+Pose Qubes::followGrab(Pose const& current, Pose const& target, float deltaTime) {
+    return {Math::lerp(current.pos, target.pos, 10 * deltaTime), Math::slerp(current.rot, target.rot, 5 * deltaTime)};
+}
+
+Pose Qubes::smoothGrab(Pose const& current, Pose const& target, float smoothing, float deltaTime) {
+    if(smoothing <= 0)
+        return target;
+    float t = 1 - std::exp(-deltaTime / smoothing);
+    return {Math::lerp(current.pos, target.pos, t), Math::slerp(current.rot, target.rot, t)};
+}
+
+// below this the hand is holding still, and any distance left is not lag
+constexpr float minSpeed = 0.05;
+// a second of lag is already unusable, don't let one slow frame spike the average
+constexpr float maxLag = 1;
+// weight of the newest frame in the average
+constexpr float latencyWeight = 0.1;
+
+void GrabLatency::record(float poseAge, Math::Vec3 applied, Math::Vec3 target, float deltaTime) {
+    float latency = poseAge;
+    if(hasLast && deltaTime > 0) {
+        float speed = Math::magnitude(target - lastTarget) / deltaTime;
+        if(speed > minSpeed)
+            latency += std::min(Math::magnitude(target - applied) / speed, maxLag);
+    }
+    lastTarget = target;
+    hasLast = true;
+    average += (latency - average) * latencyWeight;
+}
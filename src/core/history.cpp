@@ -0,0 +1,173 @@
+#include "core/history.hpp"
+#include "core/packing.hpp"
+#include "core/trace.hpp"
+
+using namespace Qubes;
+using namespace Qubes::Packing;
+
+#pragma region ops
+size_t LayoutOp::bytes() const {
+    return sizeof(LayoutOp) + indices.capacity() * sizeof(int) + data.capacity();
+}
+
+LayoutOp Qubes::setOp(std::vector<int> const& indices, std::vector<CubeInfo> const& before, std::vector<CubeInfo> const& after) {
+    LayoutOp op;
+    op.kind = LayoutOp::Set;
+    for(int i = 0; i < indices.size(); i++) {
+        // saving a cube that didn't change isn't a step
+        uint8_t mask = changedFields(before[i], after[i]);
+        if(!mask)
+            continue;
+        op.indices.push_back(indices[i]);
+        pack(op.data, before[i], mask);
+    }
+    op.indices.shrink_to_fit();
+    op.data.shrink_to_fit();
+    return op;
+}
+
+LayoutOp Qubes::insertOp(std::vector<int> const& indices, std::vector<CubeInfo> const& removed) {
+    LayoutOp op;
+    op.kind = LayoutOp::Insert;
+    op.indices = indices;
+    for(auto& cube : removed)
+        pack(op.data, cube, All);
+    op.data.shrink_to_fit();
+    return op;
+}
+
+LayoutOp Qubes::eraseOp(std::vector<int> indices) {
+    LayoutOp op;
+    op.kind = LayoutOp::Erase;
+    op.indices = std::move(indices);
+    return op;
+}
+
+std::vector<CubeInfo> Qubes::opValues(LayoutOp const& op, std::vector<CubeInfo> const& cubes) {
+    std::vector<CubeInfo> values;
+    if(op.kind == LayoutOp::Erase)
+        return values;
+    values.reserve(op.indices.size());
+    const uint8_t *at = op.data.data(), *end = at + op.data.size();
+    for(int index : op.indices) {
+        values.push_back(op.kind == LayoutOp::Set ? cubes[index] : CubeInfo());
+        unpack(at, end, values.back());
+    }
+    return values;
+}
+
+LayoutOp Qubes::invertOp(LayoutOp const& op, std::vector<CubeInfo> const& cubes) {
+    if(op.kind == LayoutOp::Insert)
+        return eraseOp(op.indices);
+    std::vector<CubeInfo> current;
+    current.reserve(op.indices.size());
+    for(int index : op.indices)
+        current.push_back(cubes[index]);
+    if(op.kind == LayoutOp::Erase)
+        return insertOp(op.indices, current);
+    // the same fields, as they are now
+    LayoutOp inverse;
+    inverse.kind = LayoutOp::Set;
+    inverse.indices = op.indices;
+    inverse.data.reserve(op.data.size());
+    const uint8_t *at = op.data.data(), *end = at + op.data.size();
+    CubeInfo skipped;
+    for(auto& cube : current)
+        pack(inverse.data, cube, unpack(at, end, skipped));
+    return inverse;
+}
+#pragma endregion
+
+#pragma region history
+void History::setLimit(size_t bytes) {
+    limit = bytes;
+    evict();
+}
+
+void History::record(LayoutOp op) {
+    if(op.indices.empty())
+        return;
+    TRACE_ZONE("History::record");
+    for(auto& undone : redos)
+        used -= undone.bytes();
+    redos.clear();
+    auto now = std::chrono::steady_clock::now();
+    bool merge = op.kind == LayoutOp::Set && !undos.empty() && undos.back().kind == LayoutOp::Set
+        && undos.back().indices == op.indices && now - lastRecord < MergeWindow;
+    lastRecord = now;
+    if(!merge) {
+        used += op.bytes();
+        undos.push_back(std::move(op));
+        evict();
+        return;
+    }
+    // the older step already has how the fields it changed were first, the newer one only adds fields
+    auto& last = undos.back();
+    used -= last.bytes();
+    std::vector<uint8_t> merged;
+    merged.reserve(last.data.size() + op.data.size());
+    const uint8_t *older = last.data.data(), *newer = op.data.data();
+    const uint8_t *olderEnd = older + last.data.size(), *newerEnd = newer + op.data.size();
+    for(int i = 0; i < op.indices.size(); i++) {
+        CubeInfo cube;
+        uint8_t mask = unpack(newer, newerEnd, cube);
+        mask |= unpack(older, olderEnd, cube);
+        pack(merged, cube, mask);
+    }
+    merged.shrink_to_fit();
+    last.data = std::move(merged);
+    used += last.bytes();
+    evict();
+}
+
+std::optional<LayoutOp> History::takeUndo() {
+    if(undos.empty())
+        return std::nullopt;
+    LayoutOp op = std::move(undos.back());
+    undos.pop_back();
+    used -= op.bytes();
+    lastRecord = {};
+    return op;
+}
+
+std::optional<LayoutOp> History::takeRedo() {
+    if(redos.empty())
+        return std::nullopt;
+    LayoutOp op = std::move(redos.back());
+    redos.pop_back();
+    used -= op.bytes();
+    return op;
+}
+
+void History::pushUndo(LayoutOp op) {
+    used += op.bytes();
+    undos.push_back(std::move(op));
+    // a step put back by redo isn't merged into
+    lastRecord = {};
+    evict();
+}
+
+void History::pushRedo(LayoutOp op) {
+    used += op.bytes();
+    redos.push_back(std::move(op));
+    evict();
+}
+
+void History::clear() {
+    undos.clear();
+    redos.clear();
+    used = 0;
+}
+
+void History::evict() {
+    // oldest first, the front of each is furthest from the current layout
+    while(used > limit && !undos.empty()) {
+        used -= undos.front().bytes();
+        undos.pop_front();
+    }
+    while(used > limit && !redos.empty()) {
+        used -= redos.front().bytes();
+        redos.pop_front();
+    }
+}
+#pragma endregion
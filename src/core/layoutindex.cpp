@@ -0,0 +1,155 @@
+#include "core/layoutindex.hpp"
+#include "core/trace.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+using namespace Qubes;
+
+float Qubes::colorHue(Math::Color color) {
+    float max = std::max({color.r, color.g, color.b});
+    float min = std::min({color.r, color.g, color.b});
+    float range = max - min;
+    if(range <= 0)
+        return 0;
+    float hue;
+    if(max == color.r)
+        hue = (color.g - color.b) / range;
+    else if(max == color.g)
+        hue = 2 + (color.b - color.r) / range;
+    else
+        hue = 4 + (color.r - color.g) / range;
+    hue *= 60;
+    return hue < 0 ? hue + 360 : hue;
+}
+
+// grows the list of lists so that value has one, values from other mods can be anything
+static void bucket(std::vector<std::vector<int>>& buckets, int value, int cube) {
+    if(value < 0)
+        return;
+    if(value >= (int) buckets.size())
+        buckets.resize(value + 1);
+    buckets[value].push_back(cube);
+}
+
+void LayoutIndex::build(CubeSnapshot const& snapshot) {
+    if(snapshot.version == builtVersion && snapshot.count == count)
+        return;
+    TRACE_ZONE("LayoutIndex::build");
+    builtVersion = snapshot.version;
+    count = snapshot.count;
+
+    for(auto list : {&byType, &byLocked}) {
+        for(auto& values : *list)
+            values.clear();
+    }
+    for(auto& [action, values] : byHitAction)
+        values.clear();
+    for(auto array : {&posX, &posY, &posZ, &hues})
+        array->resize(count);
+    types.resize(count);
+    hitActions.resize(count);
+    locked.resize(count);
+
+    for(int i = 0; i < count; i++) {
+        auto& cube = snapshot.cubes[i];
+        posX[i] = cube.pos[0]; posY[i] = cube.pos[1]; posZ[i] = cube.pos[2];
+        hues[i] = colorHue({cube.color[0], cube.color[1], cube.color[2]});
+        types[i] = cube.type;
+        hitActions[i] = cube.hitAction;
+        locked[i] = cube.locked;
+        bucket(byType, cube.type, i);
+        byHitAction[cube.hitAction].push_back(i);
+        bucket(byLocked, cube.locked, i);
+    }
+
+    hueOrder.resize(count);
+    std::iota(hueOrder.begin(), hueOrder.end(), 0);
+    std::stable_sort(hueOrder.begin(), hueOrder.end(), [this](int a, int b) { return hues[a] < hues[b]; });
+    sortedHues.resize(count);
+    for(int i = 0; i < count; i++)
+        sortedHues[i] = hues[hueOrder[i]];
+}
+
+void LayoutIndex::hueRange(float min, float max, std::vector<int>& out) const {
+    auto add = [this, &out](float from, float to) {
+        auto begin = std::lower_bound(sortedHues.begin(), sortedHues.end(), from);
+        auto end = std::upper_bound(begin, sortedHues.end(), to);
+        out.insert(out.end(), hueOrder.begin() + (begin - sortedHues.begin()), hueOrder.begin() + (end - sortedHues.begin()));
+    };
+    if(min <= max)
+        add(min, max);
+    else {
+        add(min, 360);
+        add(0, max);
+    }
+    std::sort(out.begin(), out.end());
+}
+
+bool LayoutIndex::passes(int cube, LayoutFilter const& filter, float maxDistance2) const {
+    if(filter.type >= 0 && types[cube] != filter.type)
+        return false;
+    if(filter.hitAction >= 0 && hitActions[cube] != filter.hitAction)
+        return false;
+    if(filter.locked >= 0 && locked[cube] != filter.locked)
+        return false;
+    if(maxDistance2 > 0) {
+        float x = posX[cube] - filter.from.x, y = posY[cube] - filter.from.y, z = posZ[cube] - filter.from.z;
+        if(x * x + y * y + z * z > maxDistance2)
+            return false;
+    }
+    float hue = hues[cube];
+    if(filter.hueMin <= filter.hueMax)
+        return hue >= filter.hueMin && hue <= filter.hueMax;
+    return hue >= filter.hueMin || hue <= filter.hueMax;
+}
+
+void LayoutIndex::query(LayoutFilter const& filter, std::vector<int>& out) const {
+    TRACE_ZONE("LayoutIndex::query");
+    out.clear();
+    static const std::vector<int> none;
+    auto lookup = [](std::vector<std::vector<int>> const& buckets, int value) -> std::vector<int> const& {
+        return value >= 0 && value < (int) buckets.size() ? buckets[value] : none;
+    };
+
+    // start from the smallest list of candidates, the rest of the filter is checked on each
+    std::vector<int> const* candidates = nullptr;
+    auto consider = [&candidates](std::vector<int> const& list) {
+        if(!candidates || list.size() < candidates->size())
+            candidates = &list;
+    };
+    if(filter.type >= 0)
+        consider(lookup(byType, filter.type));
+    if(filter.hitAction >= 0) {
+        auto found = byHitAction.find(filter.hitAction);
+        consider(found != byHitAction.end() ? found->second : none);
+    }
+    if(filter.locked >= 0)
+        consider(lookup(byLocked, filter.locked));
+
+    // the hue range has to be sorted back into cube order, so it's only worth it when it's narrow
+    std::vector<int> hueCandidates;
+    bool allHues = filter.hueMin <= 0 && filter.hueMax >= 360;
+    if(!allHues) {
+        float span = filter.hueMin <= filter.hueMax ? filter.hueMax - filter.hueMin : 360 - filter.hueMin + filter.hueMax;
+        // hues aren't spread evenly, so this only estimates the range's size
+        float estimate = span / 360 * count;
+        if(estimate < count / 8 && (!candidates || estimate < candidates->size())) {
+            hueRange(filter.hueMin, filter.hueMax, hueCandidates);
+            consider(hueCandidates);
+        }
+    }
+
+    float maxDistance2 = filter.maxDistance * filter.maxDistance;
+    if(!candidates) {
+        for(int i = 0; i < count; i++) {
+            if(passes(i, filter, maxDistance2))
+                out.push_back(i);
+        }
+        return;
+    }
+    for(int cube : *candidates) {
+        if(passes(cube, filter, maxDistance2))
+            out.push_back(cube);
+    }
+}
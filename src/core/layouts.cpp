@@ -0,0 +1,221 @@
+#include "core/layouts.hpp"
+#include "core/packing.hpp"
+#include "core/stats.hpp"
+#include "core/trace.hpp"
+
+#include "rapidjson/prettywriter.h"
+#include "rapidjson/stringbuffer.h"
+
+#include <cstdio>
+#include <thread>
+
+using namespace Qubes;
+
+bool Qubes::validLayoutName(std::string const& name) {
+    if(name.empty() || name.size() > 64 || name[0] == '.' || name == DefaultLayout)
+        return false;
+    for(char c : name) {
+        if(c < ' ' || c == '/' || c == '\\' || c == 127)
+            return false;
+    }
+    return true;
+}
+
+#pragma region bindings
+std::string const& LayoutBindings::resolve(bool inGameplay, std::string const& song, std::string const& playlist) const {
+    if(!inGameplay)
+        return menu;
+    auto found = songs.find(song);
+    if(found != songs.end())
+        return found->second;
+    found = playlists.find(playlist);
+    if(found != playlists.end())
+        return found->second;
+    return gameplay;
+}
+
+void LayoutBindings::bind(LayoutContext context, std::string const& key, std::string const& layout) {
+    switch(context) {
+        case LayoutContext::Menu:
+            menu = layout;
+            return;
+        case LayoutContext::Gameplay:
+            gameplay = layout;
+            return;
+        default:
+            break;
+    }
+    auto& map = context == LayoutContext::Song ? songs : playlists;
+    if(key.empty())
+        return;
+    if(layout == DefaultLayout)
+        map.erase(key);
+    else
+        map[key] = layout;
+}
+
+void LayoutBindings::unbind(std::string const& layout) {
+    if(menu == layout)
+        menu = DefaultLayout;
+    if(gameplay == layout)
+        gameplay = DefaultLayout;
+    for(auto map : {&songs, &playlists})
+        std::erase_if(*map, [&layout](auto const& pair) { return pair.second == layout; });
+}
+
+static void loadMap(rapidjson::Value const& obj, const char* name, std::unordered_map<std::string, std::string>& map) {
+    map.clear();
+    auto member = obj.FindMember(name);
+    if(member == obj.MemberEnd() || !member->value.IsObject())
+        return;
+    for(auto pair = member->value.MemberBegin(); pair != member->value.MemberEnd(); ++pair) {
+        if(pair->value.IsString())
+            map[pair->name.GetString()] = pair->value.GetString();
+    }
+}
+
+void LayoutBindings::Load(rapidjson::Value const& obj) {
+    *this = {};
+    if(!obj.IsObject())
+        return;
+    for(auto [name, value] : {std::pair{"menu", &menu}, std::pair{"gameplay", &gameplay}}) {
+        auto member = obj.FindMember(name);
+        if(member != obj.MemberEnd() && member->value.IsString())
+            *value = member->value.GetString();
+    }
+    loadMap(obj, "songs", songs);
+    loadMap(obj, "playlists", playlists);
+}
+
+static rapidjson::Value mapToJSON(std::unordered_map<std::string, std::string> const& map, rapidjson::Document::AllocatorType& allocator) {
+    rapidjson::Value obj(rapidjson::kObjectType);
+    for(auto& [key, layout] : map)
+        obj.AddMember(rapidjson::Value(key, allocator).Move(), rapidjson::Value(layout, allocator).Move(), allocator);
+    return obj;
+}
+
+rapidjson::Value LayoutBindings::ToJSON(rapidjson::Document::AllocatorType& allocator) const {
+    rapidjson::Value obj(rapidjson::kObjectType);
+    obj.AddMember("menu", rapidjson::Value(menu, allocator).Move(), allocator);
+    obj.AddMember("gameplay", rapidjson::Value(gameplay, allocator).Move(), allocator);
+    obj.AddMember("songs", mapToJSON(songs, allocator), allocator);
+    obj.AddMember("playlists", mapToJSON(playlists, allocator), allocator);
+    return obj;
+}
+#pragma endregion
+
+#pragma region files
+void LayoutFile::Write() {
+    TRACE_ZONE("LayoutFile::Write");
+    Stats::configWrites.fetch_add(1, std::memory_order_relaxed);
+    rapidjson::StringBuffer buffer;
+    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(buffer);
+    doc.Accept(writer);
+    std::string temp = path + ".tmp";
+    FILE* file = fopen(temp.c_str(), "wb");
+    if(!file)
+        return;
+    bool ok = fwrite(buffer.GetString(), 1, buffer.GetSize(), file) == buffer.GetSize();
+    ok &= fclose(file) == 0;
+    if(ok)
+        rename(temp.c_str(), path.c_str());
+    else
+        remove(temp.c_str());
+}
+
+bool LayoutFile::Read(std::string* error) {
+    TRACE_ZONE("LayoutFile::Read");
+    FILE* file = fopen(path.c_str(), "rb");
+    if(!file) {
+        if(error)
+            *error = "file not found";
+        return false;
+    }
+    std::string text;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if(size > 0) {
+        text.resize(size);
+        text.resize(fread(text.data(), 1, size, file));
+    }
+    fclose(file);
+
+    auto bytes = (const uint8_t*) text.data();
+    if(Packing::isPacked(bytes, text.size()))
+        return Packing::unpackDocument(bytes, text.size(), doc, error);
+    doc.Parse(text.c_str());
+    if(doc.HasParseError() || !doc.IsObject()) {
+        if(error)
+            *error = "not valid json";
+        doc.SetObject();
+        return false;
+    }
+    return true;
+}
+
+std::string Qubes::layoutPath(std::string const& folder, std::string const& name) {
+    return folder + name + ".json";
+}
+
+LoadedLayout Qubes::loadLayout(std::string const& folder, std::string const& name) {
+    TRACE_ZONE("loadLayout");
+    LoadedLayout layout;
+    layout.name = name;
+    if(!validLayoutName(name)) {
+        layout.error = "invalid name";
+        return layout;
+    }
+    layout.file = std::make_unique<LayoutFile>(layoutPath(folder, name));
+    if(!layout.file->Read(&layout.error))
+        return layout;
+    auto& doc = layout.file->GetDocument();
+    auto section = doc.FindMember("qubes");
+    if(section == doc.MemberEnd() || !section->value.IsArray()) {
+        layout.error = "no qubes array";
+        return layout;
+    }
+    layout.cubes.reserve(section->value.Size());
+    for(auto& cube : section->value.GetArray()) {
+        if(!validCube(cube, &layout.error))
+            return layout;
+        layout.cubes.emplace_back(cube);
+    }
+    return layout;
+}
+#pragma endregion
+
+#pragma region loader
+void LayoutLoader::prefetch(std::string const& name) {
+    if(pending.valid() && pendingName == name)
+        return;
+    // the default layout is always in memory with the config
+    if(name == DefaultLayout) {
+        forget(pendingName);
+        return;
+    }
+    // a future from a promise doesn't wait for the thread when it's replaced, so an unneeded read just finishes on its own
+    std::promise<LoadedLayout> promise;
+    pending = promise.get_future();
+    pendingName = name;
+    std::thread([promise = std::move(promise), folder = folder, name]() mutable {
+        promise.set_value(loadLayout(folder, name));
+    }).detach();
+}
+
+LoadedLayout LayoutLoader::take(std::string const& name) {
+    if(pending.valid() && pendingName == name) {
+        TRACE_ZONE("LayoutLoader::take wait");
+        pendingName.clear();
+        return pending.get();
+    }
+    return loadLayout(folder, name);
+}
+
+void LayoutLoader::forget(std::string const& name) {
+    if(pendingName != name)
+        return;
+    pending = {};
+    pendingName.clear();
+}
+#pragma endregion
@@ -0,0 +1,95 @@
+#include "core/memory.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+
+using namespace Qubes;
+
+const char* const Memory::subsystemNames[SubsystemCount] = { "Cubes", "Menus", "Debris", "Config", "Sprites" };
+
+Memory::Report Memory::estimate(Counts const& counts, Costs const& costs) {
+    Report report = {};
+    uint64_t cubeCost = costs.cube + costs.material + costs.cutTarget;
+    report.bytes[Cubes] = cubeCost * counts.cubes;
+    report.bytes[Menus] = (uint64_t) costs.menu * counts.menus;
+    report.bytes[Debris] = (uint64_t) costs.debris * counts.debris;
+    report.bytes[ConfigDom] = counts.configDomBytes;
+    report.bytes[Sprites] = counts.spriteBytes;
+    for(int i = 0; i < SubsystemCount; i++)
+        report.total += report.bytes[i];
+    report.cubes = counts.layoutCubes;
+    // the config is mostly the layout's cubes, so share all of it out
+    report.perCube = cubeCost + (counts.layoutCubes > 0 ? counts.configDomBytes / counts.layoutCubes : 0);
+    return report;
+}
+
+// strings short enough are stored inside the value
+static uint64_t stringBytes(rapidjson::Value const& value) {
+    constexpr size_t maxShortString = sizeof(rapidjson::Value) - 3;
+    return value.GetStringLength() > maxShortString ? value.GetStringLength() + 1 : 0;
+}
+
+// what a value owns beyond its own slot
+static uint64_t ownedBytes(rapidjson::Value const& value) {
+    uint64_t bytes = 0;
+    if(value.IsString())
+        bytes += stringBytes(value);
+    else if(value.IsArray()) {
+        bytes += value.Capacity() * sizeof(rapidjson::Value);
+        for(auto it = value.Begin(); it != value.End(); it++)
+            bytes += ownedBytes(*it);
+    } else if(value.IsObject()) {
+        bytes += value.MemberCount() * 2 * sizeof(rapidjson::Value);
+        for(auto it = value.MemberBegin(); it != value.MemberEnd(); it++)
+            bytes += stringBytes(it->name) + ownedBytes(it->value);
+    }
+    return bytes;
+}
+
+uint64_t Memory::jsonBytes(rapidjson::Value const& value) {
+    return sizeof(rapidjson::Value) + ownedBytes(value);
+}
+
+uint64_t Memory::pngTextureBytes(const uint8_t* data, size_t length) {
+    static constexpr uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    // the first chunk is always IHDR, with big endian width and height
+    if(length < 24)
+        return 0;
+    for(int i = 0; i < 8; i++) {
+        if(data[i] != signature[i])
+            return 0;
+    }
+    auto readInt = [data](int offset) {
+        return ((uint32_t) data[offset] << 24) | ((uint32_t) data[offset + 1] << 16) | ((uint32_t) data[offset + 2] << 8) | data[offset + 3];
+    };
+    return (uint64_t) readInt(16) * readInt(20) * 4;
+}
+
+std::string Memory::formatBytes(uint64_t bytes) {
+    char buffer[32];
+    if(bytes < 1024)
+        snprintf(buffer, sizeof(buffer), "%llu B", (unsigned long long) bytes);
+    else if(bytes < 1024 * 1024)
+        snprintf(buffer, sizeof(buffer), "%.1f KB", bytes / 1024.0);
+    else
+        snprintf(buffer, sizeof(buffer), "%.1f MB", bytes / (1024.0 * 1024.0));
+    return buffer;
+}
+
+int Memory::cubeAllowance(Report const& report, Limits const& limits) {
+    int64_t allowed = INT_MAX;
+    if(limits.maxCubes > 0)
+        allowed = std::min<int64_t>(allowed, limits.maxCubes - report.cubes);
+    if(limits.maxBytes > 0 && report.perCube > 0)
+        allowed = std::min<int64_t>(allowed, report.total < limits.maxBytes ? (limits.maxBytes - report.total) / report.perCube : 0);
+    return std::max<int64_t>(allowed, 0);
+}
+
+std::string Memory::refuseCube(Report const& report, Limits const& limits) {
+    if(limits.maxCubes > 0 && report.cubes >= limits.maxCubes)
+        return "the limit of " + std::to_string(limits.maxCubes) + " qubes has been reached";
+    if(limits.maxBytes > 0 && report.total + report.perCube > limits.maxBytes)
+        return "the memory budget of " + std::to_string(limits.maxBytes / (1024 * 1024)) + " MB would be exceeded";
+    return "";
+}
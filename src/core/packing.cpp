@@ -0,0 +1,197 @@
+#include "core/packing.hpp"
+#include "core/trace.hpp"
+
+#include <cstring>
+
+using namespace Qubes;
+
+static constexpr char Magic[4] = {'Q', 'U', 'B', 'S'};
+static constexpr uint8_t Version = 1;
+
+#pragma region cubes
+template<class T>
+static void put(std::vector<uint8_t>& data, T const& value) {
+    size_t at = data.size();
+    data.resize(at + sizeof(T));
+    memcpy(data.data() + at, &value, sizeof(T));
+}
+
+template<class T>
+static bool get(const uint8_t*& at, const uint8_t* end, T& value) {
+    if(end - at < sizeof(T))
+        return false;
+    memcpy(&value, at, sizeof(T));
+    at += sizeof(T);
+    return true;
+}
+
+uint8_t Packing::changedFields(CubeInfo const& a, CubeInfo const& b) {
+    uint8_t mask = 0;
+    if(a.pos != b.pos || a.rot != b.rot)
+        mask |= Pose;
+    if(a.color != b.color)
+        mask |= Color;
+    if(a.type != b.type)
+        mask |= Type;
+    if(a.hitAction != b.hitAction)
+        mask |= HitAction;
+    if(a.size != b.size)
+        mask |= Size;
+    if(a.locked != b.locked)
+        mask |= Locked;
+    if(a.animation != b.animation)
+        mask |= Motion;
+    return mask;
+}
+
+// the fields in the order of the mask bits
+void Packing::pack(std::vector<uint8_t>& data, CubeInfo const& cube, uint8_t mask) {
+    put(data, mask);
+    if(mask & Pose) {
+        put(data, cube.pos);
+        put(data, cube.rot);
+    }
+    if(mask & Color)
+        put(data, cube.color);
+    if(mask & Type)
+        put(data, cube.type);
+    if(mask & HitAction)
+        put(data, cube.hitAction);
+    if(mask & Size)
+        put(data, cube.size);
+    if(mask & Locked)
+        put(data, (uint8_t) cube.locked);
+    if(mask & Motion) {
+        auto& animation = cube.animation;
+        put(data, (uint8_t) animation.motion);
+        put(data, animation.speed);
+        put(data, animation.amount);
+        put(data, animation.axis);
+        put(data, animation.phase);
+        put(data, (uint32_t) animation.path.size());
+        for(auto& point : animation.path)
+            put(data, point);
+    }
+}
+
+int Packing::unpack(const uint8_t*& at, const uint8_t* end, CubeInfo& cube) {
+    uint8_t mask;
+    if(!get(at, end, mask) || (mask & ~All))
+        return -1;
+    bool ok = true;
+    if(mask & Pose)
+        ok &= get(at, end, cube.pos) && get(at, end, cube.rot);
+    if(ok && (mask & Color))
+        ok &= get(at, end, cube.color);
+    if(ok && (mask & Type))
+        ok &= get(at, end, cube.type);
+    if(ok && (mask & HitAction))
+        ok &= get(at, end, cube.hitAction);
+    if(ok && (mask & Size))
+        ok &= get(at, end, cube.size);
+    uint8_t byte;
+    if(ok && (mask & Locked)) {
+        ok &= get(at, end, byte);
+        cube.locked = byte;
+    }
+    if(ok && (mask & Motion)) {
+        auto& animation = cube.animation;
+        uint32_t points;
+        ok &= get(at, end, byte) && byte < (uint8_t) Qubes::Motion::Count;
+        animation.motion = (Qubes::Motion) byte;
+        ok &= ok && get(at, end, animation.speed) && get(at, end, animation.amount) && get(at, end, animation.axis)
+            && get(at, end, animation.phase) && get(at, end, points);
+        // checked before resizing, so a broken count can't allocate much
+        ok &= ok && points <= (end - at) / sizeof(Math::Vec3);
+        if(ok) {
+            animation.path.resize(points);
+            for(auto& point : animation.path)
+                get(at, end, point);
+        }
+    }
+    return ok ? mask : -1;
+}
+#pragma endregion
+
+#pragma region documents
+// magic, version and array count, then per array its name, cube count and cubes
+// fields at their default value are left out of each cube
+std::vector<uint8_t> Packing::packDocument(rapidjson::Document& doc) {
+    TRACE_ZONE("packDocument");
+    std::vector<uint8_t> data;
+    put(data, Magic);
+    put(data, Version);
+    size_t countAt = data.size();
+    put(data, (uint32_t) 0);
+    uint32_t arrays = 0;
+    const CubeInfo defaults;
+    for(auto member = doc.MemberBegin(); member != doc.MemberEnd(); ++member) {
+        if(!member->value.IsArray())
+            continue;
+        auto cubes = member->value.GetArray();
+        bool valid = true;
+        for(auto& cube : cubes)
+            valid &= validCube(cube);
+        if(!valid)
+            continue;
+        auto& name = member->name;
+        put(data, (uint16_t) name.GetStringLength());
+        data.insert(data.end(), name.GetString(), name.GetString() + name.GetStringLength());
+        put(data, (uint32_t) cubes.Size());
+        for(auto& obj : cubes) {
+            CubeInfo cube(obj);
+            pack(data, cube, Pose | changedFields(defaults, cube));
+        }
+        arrays++;
+    }
+    memcpy(data.data() + countAt, &arrays, sizeof(arrays));
+    return data;
+}
+
+bool Packing::isPacked(const uint8_t* data, size_t size) {
+    return size >= sizeof(Magic) && !memcmp(data, Magic, sizeof(Magic));
+}
+
+bool Packing::unpackDocument(const uint8_t* data, size_t size, rapidjson::Document& doc, std::string* error) {
+    TRACE_ZONE("unpackDocument");
+    auto fail = [error](std::string const& message) {
+        if(error)
+            *error = message;
+        return false;
+    };
+    if(!isPacked(data, size))
+        return fail("not a packed layout");
+    const uint8_t *at = data + sizeof(Magic), *end = data + size;
+    uint8_t version;
+    uint32_t arrays;
+    if(!get(at, end, version) || version != Version)
+        return fail("unknown version");
+    if(!get(at, end, arrays))
+        return fail("truncated");
+    doc.SetObject();
+    auto& allocator = doc.GetAllocator();
+    for(uint32_t i = 0; i < arrays; i++) {
+        uint16_t length;
+        uint32_t count;
+        if(!get(at, end, length) || end - at < length)
+            return fail("truncated array name");
+        rapidjson::Value name((const char*) at, length, allocator);
+        at += length;
+        // every cube takes at least its mask
+        if(!get(at, end, count) || count > end - at)
+            return fail("truncated array " + std::string(name.GetString()));
+        rapidjson::Value cubes(rapidjson::kArrayType);
+        cubes.Reserve(count, allocator);
+        for(uint32_t j = 0; j < count; j++) {
+            CubeInfo cube;
+            if(unpack(at, end, cube) < 0)
+                return fail(std::string(name.GetString()) + "[" + std::to_string(j) + "] is broken");
+            cubes.PushBack(cube.ToJSON(allocator), allocator);
+        }
+        doc.AddMember(name, cubes, allocator);
+    }
+    if(at != end)
+        return fail("unexpected data after the last array");
+    return true;
+}
+#pragma endregion
@@ -0,0 +1,140 @@
+#include "core/physics.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Qubes;
+
+#pragma region throwTracker
+void ThrowTracker::push(Pose const& pose, float deltaTime) {
+    poses[next] = pose;
+    times[next] = deltaTime;
+    next = (next + 1) % Samples;
+    count = std::min(count + 1, Samples);
+}
+
+// the oldest and newest sample, and the time between them
+static float span(int count, int next, int samples, float const* times, int& oldest, int& newest) {
+    oldest = (next - count + samples) % samples;
+    newest = (next - 1 + samples) % samples;
+    float time = 0;
+    // the oldest sample's time is from before it, so it isn't part of the span
+    for(int i = 1; i < count; i++)
+        time += times[(oldest + i) % samples];
+    return time;
+}
+
+Math::Vec3 ThrowTracker::velocity() const {
+    int oldest, newest;
+    float time = span(count, next, Samples, times, oldest, newest);
+    if(count < 2 || time <= 0)
+        return Math::Vec3::zero();
+    return (poses[newest].pos - poses[oldest].pos) / time;
+}
+
+Math::Vec3 ThrowTracker::angularVelocity() const {
+    int oldest, newest;
+    float time = span(count, next, Samples, times, oldest, newest);
+    if(count < 2 || time <= 0)
+        return Math::Vec3::zero();
+    Math::Quat delta = poses[newest].rot * Math::inverse(poses[oldest].rot);
+    // the short way around
+    if(delta.w < 0)
+        delta = {-delta.x, -delta.y, -delta.z, -delta.w};
+    Math::Vec3 axis = {delta.x, delta.y, delta.z};
+    float sin = Math::magnitude(axis);
+    if(sin < 1e-6f)
+        return Math::Vec3::zero();
+    float angle = 2 * std::atan2(sin, delta.w);
+    return axis * (angle / (sin * time));
+}
+#pragma endregion
+
+#pragma region batch
+int PhysicsBatch::add(Pose const& pose, Math::Vec3 velocity, Math::Vec3 angularVelocity, float cubeHalf) {
+    posX.push_back(pose.pos.x); posY.push_back(pose.pos.y); posZ.push_back(pose.pos.z);
+    velX.push_back(velocity.x); velY.push_back(velocity.y); velZ.push_back(velocity.z);
+    Math::Quat rot = Math::normalized(pose.rot);
+    rotX.push_back(rot.x); rotY.push_back(rot.y); rotZ.push_back(rot.z); rotW.push_back(rot.w);
+    angX.push_back(angularVelocity.x); angY.push_back(angularVelocity.y); angZ.push_back(angularVelocity.z);
+    half.push_back(cubeHalf);
+    resting.push_back(0);
+    return size() - 1;
+}
+
+int PhysicsBatch::remove(int slot) {
+    int last = size() - 1;
+    for(auto array : {&posX, &posY, &posZ, &velX, &velY, &velZ, &rotX, &rotY, &rotZ, &rotW, &angX, &angY, &angZ, &half, &resting}) {
+        (*array)[slot] = (*array)[last];
+        array->pop_back();
+    }
+    return slot == last ? -1 : last;
+}
+
+void PhysicsBatch::step(float deltaTime, PhysicsSettings const& settings, std::vector<int>& rested) {
+    rested.clear();
+    accumulator = std::min(accumulator + deltaTime, settings.step * settings.maxSteps);
+    while(accumulator >= settings.step) {
+        integrate(settings);
+        accumulator -= settings.step;
+    }
+    for(int i = 0; i < size(); i++) {
+        if(resting[i] >= settings.restTime)
+            rested.push_back(i);
+    }
+}
+
+void PhysicsBatch::integrate(PhysicsSettings const& settings) {
+    float h = settings.step;
+    // damping per step, the same at any step size
+    float linear = std::exp(-settings.linearDamping * h);
+    float angular = std::exp(-settings.angularDamping * h);
+    float friction = std::exp(-settings.floorFriction * h);
+    float restSpeed2 = settings.restSpeed * settings.restSpeed;
+    float restAngular2 = settings.restAngularSpeed * settings.restAngularSpeed;
+    bool needsFloor = settings.gravity > 0;
+
+    for(int i = 0; i < size(); i++) {
+        // semi implicit euler, velocity first
+        float vx = velX[i] * linear, vy = (velY[i] - settings.gravity * h) * linear, vz = velZ[i] * linear;
+        float wx = angX[i] * angular, wy = angY[i] * angular, wz = angZ[i] * angular;
+        float px = posX[i] + vx * h, py = posY[i] + vy * h, pz = posZ[i] + vz * h;
+
+        // q += 0.5 * h * (w, 0) * q
+        float qx = rotX[i], qy = rotY[i], qz = rotZ[i], qw = rotW[i];
+        float dx = 0.5f * h * (wx * qw + wy * qz - wz * qy);
+        float dy = 0.5f * h * (wy * qw + wz * qx - wx * qz);
+        float dz = 0.5f * h * (wz * qw + wx * qy - wy * qx);
+        float dw = 0.5f * h * (-wx * qx - wy * qy - wz * qz);
+        qx += dx; qy += dy; qz += dz; qw += dw;
+        float inv = 1 / std::sqrt(qx * qx + qy * qy + qz * qz + qw * qw);
+        qx *= inv; qy *= inv; qz *= inv; qw *= inv;
+
+        // lowest point of the cube is its half width along each rotated axis, projected onto y
+        float r10 = 2 * (qx * qy + qw * qz), r11 = 1 - 2 * (qx * qx + qz * qz), r12 = 2 * (qy * qz - qw * qx);
+        float extent = half[i] * (std::fabs(r10) + std::fabs(r11) + std::fabs(r12));
+        bool onFloor = py <= extent;
+        if(onFloor) {
+            py = extent;
+            if(vy < 0)
+                vy = -vy * settings.restitution;
+            vx *= friction; vz *= friction;
+            wx *= friction; wy *= friction; wz *= friction;
+        }
+
+        bool slow = vx * vx + vy * vy + vz * vz < restSpeed2 && wx * wx + wy * wy + wz * wz < restAngular2;
+        // with gravity a cube at the top of its arc is slow too, it only rests on the floor
+        resting[i] = slow && (onFloor || !needsFloor) ? resting[i] + h : 0;
+        // rested cubes are left until they're removed, and decaying further would only reach denormals
+        if(resting[i] >= settings.restTime) {
+            vx = vy = vz = 0;
+            wx = wy = wz = 0;
+        }
+
+        posX[i] = px; posY[i] = py; posZ[i] = pz;
+        velX[i] = vx; velY[i] = vy; velZ[i] = vz;
+        rotX[i] = qx; rotY[i] = qy; rotZ[i] = qz; rotW[i] = qw;
+        angX[i] = wx; angY[i] = wy; angZ[i] = wz;
+    }
+}
+#pragma endregion
@@ -0,0 +1,218 @@
+#include "core/qubesconfig.hpp"
+#include "core/trace.hpp"
+
+using namespace Qubes;
+
+// you do one tiny little bit of jank in your config, and you end up with migration code in your mod forever
+bool Qubes::migrateDocument(rapidjson::Document& cfg) {
+    TRACE_ZONE("migrate");
+    if(!cfg.HasMember("cubes"))
+        return false;
+    auto& allocator = cfg.GetAllocator();
+    // I don't know why it ever would be there, but make sure there isn't already a default section
+    bool addDefault = !cfg.HasMember("qubes_default");
+    if(addDefault) {
+        cfg.AddMember("qubes_default", rapidjson::Value(rapidjson::kArrayType), allocator);
+    }
+    // make sure the new array exists only once as well
+    if(!cfg.HasMember("qubes")) {
+        cfg.AddMember("qubes", rapidjson::Value(rapidjson::kArrayType), allocator);
+    }
+    // adding members can move the old array, so only look it up afterwards
+    auto section = cfg["cubes"].GetArray();
+    if(addDefault && section.Size() > 0)
+        cfg["qubes_default"].GetArray().PushBack(section[0], allocator);
+    // directly copy all the old non default cubes
+    for(int i = 1; i < section.Size(); i++) {
+        cfg["qubes"].GetArray().PushBack(section[i], allocator);
+    }
+    // delete the old array
+    cfg.RemoveMember("cubes");
+    return true;
+}
+
+// all these assume config is in correct format
+void QubesConfig::Init(ConfigStorage* cfg) {
+    TRACE_ZONE("QubesConfig::Init");
+    // store config, important if we want to ever use it
+    storage = cfg;
+    auto& doc = storage->GetDocument();
+    if(doc.HasMember(name)) {
+        LoadValue();
+    } else {
+        auto& allocator = doc.GetAllocator();
+        // have to do the move thing for non-constant names, idk why
+        doc.AddMember(rapidjson::Value(name, allocator).Move(), rapidjson::Value(rapidjson::kArrayType), allocator);
+        // add default cubes
+        auto arr = doc[name].GetArray();
+        for(CubeInfo cube : defCubes) {
+            arr.PushBack(cube.ToJSON(allocator), allocator);
+            cubes.push_back(cube);
+        }
+        storage->Write();
+        snapshots->publish(cubes);
+    }
+}
+
+void QubesConfig::LoadValue() {
+    // the recorded indices could be other cubes now
+    if(history)
+        history->clear();
+    auto section = storage->GetDocument()[name].GetArray();
+    cubes.clear();
+    cubes.reserve(section.Size());
+    for(int i = 0; i < section.Size(); i++) {
+        cubes.push_back(CubeInfo(section[i]));
+    }
+    snapshots->publish(cubes);
+}
+
+void QubesConfig::SetValue() {
+    // deletes and rewrites cube section
+    auto& doc = storage->GetDocument();
+    auto& allocator = doc.GetAllocator();
+    auto section = doc[name].GetArray();
+    section.Clear();
+    section.Reserve(cubes.size(), allocator);
+    for(auto& cube : cubes) {
+        section.PushBack(cube.ToJSON(allocator), allocator);
+    }
+    storage->Write();
+    snapshots->publish(cubes);
+}
+
+void QubesConfig::AddCube(CubeInfo cube) {
+    auto& doc = storage->GetDocument();
+    auto& allocator = doc.GetAllocator();
+    auto section = doc[name].GetArray();
+    if(history)
+        history->record(eraseOp({(int) cubes.size()}));
+    section.PushBack(cube.ToJSON(allocator), allocator);
+    cubes.push_back(cube);
+    storage->Write();
+    snapshots->publish(cubes);
+}
+
+void QubesConfig::AddCubes(std::vector<CubeInfo> const& added) {
+    TRACE_ZONE("QubesConfig::AddCubes");
+    auto& doc = storage->GetDocument();
+    auto& allocator = doc.GetAllocator();
+    auto section = doc[name].GetArray();
+    if(history) {
+        std::vector<int> indices(added.size());
+        for(int i = 0; i < added.size(); i++)
+            indices[i] = cubes.size() + i;
+        history->record(eraseOp(std::move(indices)));
+    }
+    section.Reserve(section.Size() + added.size(), allocator);
+    cubes.reserve(cubes.size() + added.size());
+    for(auto& cube : added) {
+        section.PushBack(cube.ToJSON(allocator), allocator);
+        cubes.push_back(cube);
+    }
+    storage->Write();
+    snapshots->publish(cubes);
+}
+
+void QubesConfig::SetCubeValue(int index, CubeInfo value) {
+    auto& doc = storage->GetDocument();
+    auto& allocator = doc.GetAllocator();
+    auto section = doc[name].GetArray();
+    if(history)
+        history->record(setOp({index}, {cubes[index]}, {value}));
+    section[index] = value.ToJSON(allocator);
+    cubes[index] = value;
+    storage->Write();
+    snapshots->publish(cubes);
+}
+
+void QubesConfig::SetCubeValues(std::vector<int> const& indices, std::vector<CubeInfo> const& values) {
+    TRACE_ZONE("QubesConfig::SetCubeValues");
+    auto& doc = storage->GetDocument();
+    auto& allocator = doc.GetAllocator();
+    auto section = doc[name].GetArray();
+    if(history) {
+        std::vector<CubeInfo> before;
+        before.reserve(indices.size());
+        for(int i : indices)
+            before.push_back(cubes[i]);
+        history->record(setOp(indices, before, values));
+    }
+    for(int i = 0; i < indices.size(); i++) {
+        section[indices[i]] = values[i].ToJSON(allocator);
+        cubes[indices[i]] = values[i];
+    }
+    storage->Write();
+    snapshots->publish(cubes);
+}
+
+void QubesConfig::RemoveCubes(std::vector<int> const& indices) {
+    TRACE_ZONE("QubesConfig::RemoveCubes");
+    auto section = storage->GetDocument()[name].GetArray();
+    if(history) {
+        std::vector<CubeInfo> removed;
+        removed.reserve(indices.size());
+        for(int i : indices)
+            removed.push_back(cubes[i]);
+        history->record(insertOp(indices, removed));
+    }
+    // one pass over both arrays instead of shifting everything after each removed cube down
+    int kept = 0, next = 0;
+    for(int i = 0; i < cubes.size(); i++) {
+        if(next < indices.size() && indices[next] == i) {
+            next++;
+            continue;
+        }
+        if(kept != i) {
+            section[kept].Swap(section[i]);
+            cubes[kept] = std::move(cubes[i]);
+        }
+        kept++;
+    }
+    section.Erase(section.Begin() + kept, section.End());
+    cubes.resize(kept);
+    storage->Write();
+    snapshots->publish(cubes);
+}
+
+void QubesConfig::RemoveCube(int index) {
+    // needs indices of later cubes to be updated
+    auto section = storage->GetDocument()[name].GetArray();
+    if(history)
+        history->record(insertOp({index}, {cubes[index]}));
+    section.Erase(section.Begin() + index);
+    cubes.erase(cubes.begin() + index);
+    storage->Write();
+    snapshots->publish(cubes);
+}
+
+void QubesConfig::InsertCubes(std::vector<int> const& indices, std::vector<CubeInfo> const& values) {
+    TRACE_ZONE("QubesConfig::InsertCubes");
+    auto& doc = storage->GetDocument();
+    auto& allocator = doc.GetAllocator();
+    auto section = doc[name].GetArray();
+    if(history)
+        history->record(eraseOp(indices));
+    // merged into new arrays in one pass, rapidjson can only insert by shifting
+    int total = cubes.size() + indices.size();
+    rapidjson::Value merged(rapidjson::kArrayType);
+    merged.Reserve(total, allocator);
+    std::vector<CubeInfo> mergedCubes;
+    mergedCubes.reserve(total);
+    int next = 0, old = 0;
+    for(int i = 0; i < total; i++) {
+        if(next < indices.size() && indices[next] == i) {
+            merged.PushBack(values[next].ToJSON(allocator), allocator);
+            mergedCubes.push_back(values[next]);
+            next++;
+        } else {
+            merged.PushBack(section[old], allocator);
+            mergedCubes.push_back(std::move(cubes[old]));
+            old++;
+        }
+    }
+    doc[name].Swap(merged);
+    cubes = std::move(mergedCubes);
+    storage->Write();
+    snapshots->publish(cubes);
+}
@@ -0,0 +1,42 @@
+#include "core/recording.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace Qubes;
+
+struct RecordingHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t frameCount;
+    uint32_t frameSize;
+};
+
+bool Qubes::writeRecording(std::string const& path, std::vector<InputFrame> const& frames) {
+    FILE* file = fopen(path.c_str(), "wb");
+    if(!file)
+        return false;
+    RecordingHeader header = {{'Q', 'R', 'E', 'C'}, RecordingVersion, (uint32_t) frames.size(), sizeof(InputFrame)};
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    if(ok && !frames.empty())
+        ok = fwrite(frames.data(), sizeof(InputFrame), frames.size(), file) == frames.size();
+    fclose(file);
+    return ok;
+}
+
+bool Qubes::readRecording(std::string const& path, std::vector<InputFrame>& frames) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if(!file)
+        return false;
+    RecordingHeader header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1
+        && memcmp(header.magic, "QREC", 4) == 0
+        && header.version == RecordingVersion
+        && header.frameSize == sizeof(InputFrame);
+    if(ok) {
+        frames.resize(header.frameCount);
+        ok = fread(frames.data(), sizeof(InputFrame), header.frameCount, file) == header.frameCount;
+    }
+    fclose(file);
+    return ok;
+}
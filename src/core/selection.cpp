@@ -0,0 +1,104 @@
+#include "core/selection.hpp"
+#include "core/trace.hpp"
+
+#include <algorithm>
+#include <bit>
+
+using namespace Qubes;
+
+#pragma region selection
+void Selection::set(int index, bool selected) {
+    if(index < 0)
+        return;
+    if(index >= bits) {
+        if(!selected)
+            return;
+        bits = index + 1;
+        words.resize((bits + 63) >> 6);
+    }
+    uint64_t bit = uint64_t(1) << (index & 63);
+    if(selected)
+        words[index >> 6] |= bit;
+    else
+        words[index >> 6] &= ~bit;
+}
+
+void Selection::clear() {
+    words.clear();
+    bits = 0;
+}
+
+bool Selection::empty() const {
+    return std::all_of(words.begin(), words.end(), [](uint64_t word) { return word == 0; });
+}
+
+int Selection::count() const {
+    int total = 0;
+    for(uint64_t word : words)
+        total += std::popcount(word);
+    return total;
+}
+
+void Selection::indices(std::vector<int>& out) const {
+    out.clear();
+    for(int i = 0; i < words.size(); i++) {
+        // only visits set bits, so a few selected out of thousands is cheap
+        for(uint64_t word = words[i]; word; word &= word - 1)
+            out.push_back((i << 6) + std::countr_zero(word));
+    }
+}
+
+void Selection::erase(int index) {
+    if(index < 0 || index >= bits)
+        return;
+    int word = index >> 6;
+    uint64_t below = (uint64_t(1) << (index & 63)) - 1;
+    // the bits above index in its word move down by one, then each following word carries its lowest bit down
+    words[word] = (words[word] & below) | ((words[word] >> 1) & ~below);
+    for(int i = word + 1; i < words.size(); i++) {
+        words[i - 1] |= (words[i] & 1) << 63;
+        words[i] >>= 1;
+    }
+    bits--;
+    words.resize((bits + 63) >> 6);
+}
+#pragma endregion
+
+#pragma region bulk
+void Qubes::selectBox(std::vector<CubeInfo> const& cubes, Math::Vec3 a, Math::Vec3 b, float pad, Selection& selection) {
+    TRACE_ZONE("selectBox");
+    Math::Vec3 min = {std::min(a.x, b.x) - pad, std::min(a.y, b.y) - pad, std::min(a.z, b.z) - pad};
+    Math::Vec3 max = {std::max(a.x, b.x) + pad, std::max(a.y, b.y) + pad, std::max(a.z, b.z) + pad};
+    for(int i = 0; i < cubes.size(); i++) {
+        auto& pos = cubes[i].pos;
+        if(pos.x >= min.x && pos.x <= max.x && pos.y >= min.y && pos.y <= max.y && pos.z >= min.z && pos.z <= max.z)
+            selection.set(i);
+    }
+}
+
+Math::Vec3 Qubes::selectionCenter(std::vector<CubeInfo> const& cubes, std::vector<int> const& indices) {
+    Math::Vec3 sum;
+    for(int i : indices)
+        sum += cubes[i].pos;
+    return indices.empty() ? sum : sum * (1.0f / indices.size());
+}
+
+void BulkEdit::apply(CubeInfo& cube) const {
+    if(fields & Color)
+        cube.color = color;
+    if(fields & Size)
+        cube.size = size;
+    if(fields & Type)
+        cube.type = type;
+    if(fields & HitAction)
+        cube.hitAction = hitAction;
+    if(fields & Locked)
+        cube.locked = locked;
+    if(fields & Rotate) {
+        cube.pos = pivot + rotation * (cube.pos - pivot);
+        cube.rot = Math::normalized(rotation * cube.rot);
+    }
+    if(fields & Move)
+        cube.pos += offset;
+}
+#pragma endregion
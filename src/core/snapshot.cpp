@@ -0,0 +1,85 @@
+#include "core/snapshot.hpp"
+#include "core/trace.hpp"
+
+using namespace Qubes;
+
+struct SnapshotPublisher::Published : CubeSnapshot {
+    std::atomic<int> refs;
+    std::vector<CubeRecord> records;
+    std::vector<CubeInfo> infos;
+};
+
+static CubeRecord makeRecord(CubeInfo const& info) {
+    CubeRecord record;
+    record.pos[0] = info.pos.x; record.pos[1] = info.pos.y; record.pos[2] = info.pos.z;
+    record.rot[0] = info.rot.x; record.rot[1] = info.rot.y; record.rot[2] = info.rot.z; record.rot[3] = info.rot.w;
+    record.color[0] = info.color.r; record.color[1] = info.color.g; record.color[2] = info.color.b; record.color[3] = info.color.a;
+    record.size = info.size;
+    record.type = info.type;
+    record.hitAction = info.hitAction;
+    record.motion = (int) info.animation.motion;
+    record.locked = info.locked;
+    return record;
+}
+
+SnapshotPublisher::SnapshotPublisher() : acquiring(0) {
+    // empty to start with, so acquire never returns null
+    auto empty = new Published();
+    empty->version = 0;
+    empty->count = 0;
+    empty->cubes = nullptr;
+    empty->refs.store(1, std::memory_order_relaxed);
+    current.store(empty, std::memory_order_relaxed);
+}
+
+SnapshotPublisher::~SnapshotPublisher() {
+    // readers still holding snapshots keep them alive
+    release(current.load());
+    for(auto snapshot : retired)
+        release(snapshot);
+}
+
+void SnapshotPublisher::publish(std::vector<CubeInfo> const& cubes) {
+    TRACE_ZONE("SnapshotPublisher::publish");
+    auto snapshot = new Published();
+    snapshot->records.reserve(cubes.size());
+    for(auto& cube : cubes)
+        snapshot->records.push_back(makeRecord(cube));
+    snapshot->infos = cubes;
+    snapshot->version = ++version;
+    snapshot->count = snapshot->records.size();
+    snapshot->cubes = snapshot->records.data();
+    // the publisher's reference
+    snapshot->refs.store(1, std::memory_order_relaxed);
+
+    retired.push_back(current.exchange(snapshot));
+    collect();
+}
+
+void SnapshotPublisher::collect() {
+    // a reader that loaded a replaced snapshot has either taken its reference or is still counted here,
+    // and one that starts after this sees the new one, so with none counted the old ones can be let go
+    if(retired.empty() || acquiring.load() != 0)
+        return;
+    for(auto snapshot : retired)
+        release(snapshot);
+    retired.clear();
+}
+
+CubeSnapshot const* SnapshotPublisher::acquire() const {
+    acquiring.fetch_add(1);
+    auto snapshot = current.load();
+    snapshot->refs.fetch_add(1, std::memory_order_relaxed);
+    acquiring.fetch_sub(1, std::memory_order_release);
+    return snapshot;
+}
+
+void SnapshotPublisher::release(CubeSnapshot const* snapshot) {
+    auto published = static_cast<Published const*>(snapshot);
+    if(const_cast<Published*>(published)->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        delete published;
+}
+
+std::vector<CubeInfo> const& SnapshotPublisher::cubeInfos(CubeSnapshot const* snapshot) {
+    return static_cast<Published const*>(snapshot)->infos;
+}
@@ -0,0 +1,37 @@
+#include "core/stats.hpp"
+
+#include <algorithm>
+
+using namespace Qubes;
+
+std::atomic<int> Stats::activeCubes = 0, Stats::debrisAlive = 0, Stats::coroutines = 0, Stats::menus = 0;
+std::atomic<int> Stats::staticCubes = 0;
+std::atomic<uint32_t> Stats::grabLatencyMicros = 0;
+std::atomic<int> Stats::configWrites = 0;
+std::atomic<int> Stats::cubes = 0;
+std::atomic<uint64_t> Stats::spriteBytes = 0;
+std::atomic<bool> Stats::timing = false;
+std::atomic<uint64_t> Stats::frameNanos = 0;
+Stats::FrameTimes Stats::frames;
+
+void Stats::FrameTimes::push(uint64_t nanos) {
+    times[next] = (uint32_t) std::min<uint64_t>(nanos, UINT32_MAX);
+    next = (next + 1) % Size;
+    count = std::min(count + 1, Size);
+}
+
+uint32_t Stats::FrameTimes::percentile(float p) const {
+    if(count == 0)
+        return 0;
+    // only runs on refresh, so a copy is fine
+    std::array<uint32_t, Size> sorted = times;
+    int index = std::clamp((int) (p * (count - 1) + 0.5f), 0, count - 1);
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.begin() + count);
+    return sorted[index];
+}
+
+void Stats::endFrame() {
+    uint64_t nanos = frameNanos.exchange(0, std::memory_order_relaxed);
+    if(timing.load(std::memory_order_relaxed))
+        frames.push(nanos);
+}
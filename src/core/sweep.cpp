@@ -0,0 +1,284 @@
+#include "core/sweep.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace Qubes;
+
+// boxes per leaf, one packet
+constexpr int packetSize = 4;
+// boxes thinner than this are sampled as if they were this thick, cubes are never made that small
+constexpr float minHalf = 1e-3;
+// a blade tip moves at around 20 m/s at most, a third of a metre in a 60 hz frame
+// further than this is a teleport, a pause or a tracking jump, not a swing
+constexpr float maxTravel = 1.5;
+// most segments one box is tested at, enough for boxes down to 1.5 mm across at the longest swing
+constexpr int maxSteps = 1024;
+
+SweepHit Qubes::makeHit(int id, OBB const& box, BladeSweep const& blade, float t) {
+    // the motion of the point on the blade that hit
+    Math::Vec3 prevPoint = blade.prevBottom + (blade.prevTop - blade.prevBottom) * t;
+    Math::Vec3 point = blade.bottom + (blade.top - blade.bottom) * t;
+    Math::Vec3 cutDirVec = point - prevPoint;
+    Math::Vec3 bladeDir = blade.top - blade.bottom;
+    // the plane swept by the blade, the normal is up in the orientation
+    Math::Vec3 normal = Math::normalized(Math::cross(bladeDir, cutDirVec));
+    Math::Quat orientation = Math::lookRotation(bladeDir, normal);
+    // the point of the cut plane closest to the center
+    Math::Vec3 cutPoint = box.center - normal * Math::dot(box.center - point, normal);
+    return {id, cutPoint, orientation, cutDirVec};
+}
+
+// half size of the world aligned box around an oriented one
+static Math::Vec3 worldExtents(OBB const& box) {
+    Math::Vec3 x = box.rot * Math::Vec3{box.half.x, 0, 0};
+    Math::Vec3 y = box.rot * Math::Vec3{0, box.half.y, 0};
+    Math::Vec3 z = box.rot * Math::Vec3{0, 0, box.half.z};
+    return {
+        Math::abs(x.x) + Math::abs(y.x) + Math::abs(z.x),
+        Math::abs(x.y) + Math::abs(y.y) + Math::abs(z.y),
+        Math::abs(x.z) + Math::abs(y.z) + Math::abs(z.z)
+    };
+}
+
+static float axis(Math::Vec3 const& v, int i) {
+    return i == 0 ? v.x : (i == 1 ? v.y : v.z);
+}
+
+void SweepBVH::setLane(Packet& packet, int lane, int id) {
+    auto& box = boxes[id];
+    Math::Quat inv = Math::inverse(box.rot);
+    Math::Vec3 cols[3] = {inv * Math::Vec3::right(), inv * Math::Vec3::up(), inv * Math::Vec3::forward()};
+    for(int row = 0; row < 3; row++) {
+        for(int col = 0; col < 3; col++)
+            packet.m[row * 3 + col][lane] = axis(cols[col], row);
+    }
+    packet.cx[lane] = box.center.x;
+    packet.cy[lane] = box.center.y;
+    packet.cz[lane] = box.center.z;
+    packet.hx[lane] = box.half.x;
+    packet.hy[lane] = box.half.y;
+    packet.hz[lane] = box.half.z;
+    packet.id[lane] = id;
+}
+
+int SweepBVH::buildNode(std::vector<int>& order, int begin, int end, int parent, std::vector<Math::Vec3> const& centers, std::vector<Math::Vec3> const& extents) {
+    int index = nodes.size();
+    nodes.push_back({});
+    parents.push_back(parent);
+    Math::Vec3 min = centers[order[begin]] - extents[order[begin]];
+    Math::Vec3 max = centers[order[begin]] + extents[order[begin]];
+    Math::Vec3 centerMin = centers[order[begin]], centerMax = centerMin;
+    for(int i = begin + 1; i < end; i++) {
+        Math::Vec3 lo = centers[order[i]] - extents[order[i]];
+        Math::Vec3 hi = centers[order[i]] + extents[order[i]];
+        min = {std::min(min.x, lo.x), std::min(min.y, lo.y), std::min(min.z, lo.z)};
+        max = {std::max(max.x, hi.x), std::max(max.y, hi.y), std::max(max.z, hi.z)};
+        Math::Vec3 c = centers[order[i]];
+        centerMin = {std::min(centerMin.x, c.x), std::min(centerMin.y, c.y), std::min(centerMin.z, c.z)};
+        centerMax = {std::max(centerMax.x, c.x), std::max(centerMax.y, c.y), std::max(centerMax.z, c.z)};
+    }
+    nodes[index].min = min;
+    nodes[index].max = max;
+
+    if(end - begin <= packetSize) {
+        Packet packet = {};
+        for(int lane = 0; lane < packetSize; lane++) {
+            // unused lanes are still tested, but skipped by their id
+            if(begin + lane >= end) {
+                packet.id[lane] = -1;
+                continue;
+            }
+            int id = order[begin + lane];
+            setLane(packet, lane, id);
+            slots[id] = packets.size() * packetSize + lane;
+        }
+        nodes[index].first = packets.size();
+        nodes[index].count = 1;
+        packets.push_back(packet);
+        packetNodes.push_back(index);
+        return index;
+    }
+
+    // median split along the longest axis of the centers
+    Math::Vec3 size = centerMax - centerMin;
+    int split = size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+    int mid = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end, [&centers, split](int a, int b) {
+        return axis(centers[a], split) < axis(centers[b], split);
+    });
+    int left = buildNode(order, begin, mid, index, centers, extents);
+    int right = buildNode(order, mid, end, index, centers, extents);
+    // children are wherever they ended up, so store them explicitly
+    nodes[index].first = left;
+    nodes[index].count = -right;
+    return index;
+}
+
+void SweepBVH::build(std::vector<OBB> const& newBoxes) {
+    clear();
+    boxes = newBoxes;
+    if(boxes.empty())
+        return;
+    std::vector<int> order(boxes.size());
+    std::vector<Math::Vec3> centers(boxes.size()), extents(boxes.size());
+    for(int i = 0; i < boxes.size(); i++) {
+        order[i] = i;
+        centers[i] = boxes[i].center;
+        extents[i] = worldExtents(boxes[i]);
+    }
+    nodes.reserve(boxes.size() / 2 + 1);
+    parents.reserve(boxes.size() / 2 + 1);
+    packets.reserve(boxes.size() / packetSize + 1);
+    packetNodes.reserve(boxes.size() / packetSize + 1);
+    slots.resize(boxes.size());
+    buildNode(order, 0, boxes.size(), -1, centers, extents);
+    stale.assign(nodes.size(), 0);
+}
+
+void SweepBVH::clear() {
+    nodes.clear();
+    packets.clear();
+    boxes.clear();
+    parents.clear();
+    slots.clear();
+    packetNodes.clear();
+    stale.clear();
+}
+
+void SweepBVH::update(int id, OBB const& box) {
+    boxes[id] = box;
+    int packet = slots[id] / packetSize;
+    setLane(packets[packet], slots[id] % packetSize, id);
+    // everything above a stale node is already stale
+    for(int node = packetNodes[packet]; node >= 0 && !stale[node]; node = parents[node])
+        stale[node] = 1;
+}
+
+void SweepBVH::refit() {
+    // backwards, so children are done before their parents
+    for(int i = (int) nodes.size() - 1; i >= 0; i--) {
+        if(!stale[i])
+            continue;
+        stale[i] = 0;
+        auto& node = nodes[i];
+        if(node.count < 0) {
+            auto& left = nodes[node.first];
+            auto& right = nodes[-node.count];
+            node.min = {std::min(left.min.x, right.min.x), std::min(left.min.y, right.min.y), std::min(left.min.z, right.min.z)};
+            node.max = {std::max(left.max.x, right.max.x), std::max(left.max.y, right.max.y), std::max(left.max.z, right.max.z)};
+            continue;
+        }
+        auto& packet = packets[node.first];
+        node.min = {INFINITY, INFINITY, INFINITY};
+        node.max = {-INFINITY, -INFINITY, -INFINITY};
+        for(int id : packet.id) {
+            if(id < 0)
+                continue;
+            Math::Vec3 extents = worldExtents(boxes[id]);
+            Math::Vec3 lo = boxes[id].center - extents, hi = boxes[id].center + extents;
+            node.min = {std::min(node.min.x, lo.x), std::min(node.min.y, lo.y), std::min(node.min.z, lo.z)};
+            node.max = {std::max(node.max.x, hi.x), std::max(node.max.y, hi.y), std::max(node.max.z, hi.z)};
+        }
+    }
+}
+
+// slab test of one segment against the four boxes of a packet, written so the lanes vectorize
+// returns a mask of hit lanes and the fraction along the segment they were entered at
+static int testPacket(const float* __restrict p, const float* __restrict d, const float (&cx)[4], const float (&cy)[4], const float (&cz)[4], const float (&m)[9][4], const float (&hx)[4], const float (&hy)[4], const float (&hz)[4], float (&entry)[4]) {
+    float tmin[4], tmax[4];
+    for(int lane = 0; lane < 4; lane++) {
+        float rx = p[0] - cx[lane], ry = p[1] - cy[lane], rz = p[2] - cz[lane];
+        tmin[lane] = 0;
+        tmax[lane] = 1;
+        const float* half[3] = {hx, hy, hz};
+        for(int row = 0; row < 3; row++) {
+            // segment start and direction in the box's local space
+            float lp = m[row * 3][lane] * rx + m[row * 3 + 1][lane] * ry + m[row * 3 + 2][lane] * rz;
+            float ld = m[row * 3][lane] * d[0] + m[row * 3 + 1][lane] * d[1] + m[row * 3 + 2][lane] * d[2];
+            float h = half[row][lane];
+            // a parallel segment outside the slab gets an empty range from the infinities
+            float inv = 1 / ld;
+            float t1 = (-h - lp) * inv;
+            float t2 = (h - lp) * inv;
+            tmin[lane] = std::max(tmin[lane], std::min(t1, t2));
+            tmax[lane] = std::min(tmax[lane], std::max(t1, t2));
+        }
+    }
+    int mask = 0;
+    for(int lane = 0; lane < 4; lane++) {
+        entry[lane] = tmin[lane];
+        mask |= (tmin[lane] <= tmax[lane]) << lane;
+    }
+    return mask;
+}
+
+void SweepBVH::sweep(BladeSweep const& blade, std::vector<SweepHit>& hits) const {
+    if(nodes.empty())
+        return;
+    // every point of the blade moves at most as far as one of its ends
+    float travel = std::max(Math::magnitude(blade.top - blade.prevTop), Math::magnitude(blade.bottom - blade.prevBottom));
+    // also catches nan and infinity
+    if(!(travel <= maxTravel))
+        return;
+
+    Math::Vec3 points[4] = {blade.prevBottom, blade.prevTop, blade.bottom, blade.top};
+    Math::Vec3 min = points[0], max = points[0];
+    for(auto& point : points) {
+        min = {std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z)};
+        max = {std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z)};
+    }
+
+    // the median split keeps the depth at about log2 of the packet count
+    int stack[64];
+    int depth = 0;
+    stack[depth++] = 0;
+    while(depth > 0) {
+        auto& node = nodes[stack[--depth]];
+        if(node.max.x < min.x || node.min.x > max.x || node.max.y < min.y || node.min.y > max.y || node.max.z < min.z || node.min.z > max.z)
+            continue;
+        if(node.count < 0) {
+            stack[depth++] = -node.count;
+            stack[depth++] = node.first;
+            continue;
+        }
+        auto& packet = packets[node.first];
+        // each box splits the sweep so the blade moves at most half its thinnest side between segments
+        // a blade crossing a box can't skip past it, only one clipping a corner can fall between two segments
+        // counts are powers of two, so each box is tested at the same points whichever boxes share its packet
+        int steps[packetSize], segments = 1, found = 0;
+        for(int lane = 0; lane < packetSize; lane++) {
+            steps[lane] = 1;
+            // unused lanes count as already found
+            if(packet.id[lane] < 0) {
+                found |= 1 << lane;
+                continue;
+            }
+            float half = std::max(std::min({packet.hx[lane], packet.hy[lane], packet.hz[lane]}), minHalf);
+            while(steps[lane] < maxSteps && steps[lane] * half < travel)
+                steps[lane] *= 2;
+            segments = std::max(segments, steps[lane]);
+        }
+        // the start of this frame was tested as the end of the last one
+        for(int segment = 1; segment <= segments && found != 0b1111; segment++) {
+            int due = 0;
+            for(int lane = 0; lane < packetSize; lane++)
+                due |= (segment % (segments / steps[lane]) == 0) << lane;
+            if(!(due & ~found))
+                continue;
+            float s = (float) segment / segments;
+            Math::Vec3 bladeBottom = Math::lerp(blade.prevBottom, blade.bottom, s);
+            Math::Vec3 bladeTop = Math::lerp(blade.prevTop, blade.top, s);
+            Math::Vec3 dir = bladeTop - bladeBottom;
+            float p[3] = {bladeBottom.x, bladeBottom.y, bladeBottom.z}, d[3] = {dir.x, dir.y, dir.z};
+            float entry[4];
+            int mask = testPacket(p, d, packet.cx, packet.cy, packet.cz, packet.m, packet.hx, packet.hy, packet.hz, entry) & due & ~found;
+            for(int lane = 0; lane < packetSize; lane++) {
+                if(!(mask & (1 << lane)))
+                    continue;
+                found |= 1 << lane;
+                hits.push_back(makeHit(packet.id[lane], boxes[packet.id[lane]], blade, entry[lane]));
+            }
+        }
+    }
+}
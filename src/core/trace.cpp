@@ -0,0 +1,102 @@
+#include "core/trace.hpp"
+#include "core/ringbuffer.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+using namespace Qubes;
+
+struct TraceEvent {
+    const char* name;
+    uint64_t start;
+    uint64_t duration;
+    uint32_t thread;
+};
+
+std::atomic<bool> Trace::enabled = false;
+
+static RingBuffer<TraceEvent, 8192> events;
+static std::thread writer;
+static std::atomic<bool> writing = false;
+static FILE* file = nullptr;
+static bool firstEvent = true;
+
+// small ids are easier to read in the viewer than real thread ids
+static uint32_t threadId() {
+    static std::atomic<uint32_t> next = 1;
+    thread_local uint32_t id = next.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+uint64_t Trace::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Trace::record(const char* name, uint64_t start, uint64_t end) {
+    events.tryPush([name, start, end](TraceEvent& event) {
+        event.name = name;
+        event.start = start;
+        event.duration = end - start;
+        event.thread = threadId();
+    });
+}
+
+static void writeEvent(TraceEvent& event) {
+    // timestamps are in microseconds
+    fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+        firstEvent ? "" : ",", event.name, event.start / 1000.0, event.duration / 1000.0, event.thread);
+    firstEvent = false;
+}
+
+static void writeLoop() {
+    while(writing.load(std::memory_order_acquire)) {
+        bool any = false;
+        while(events.tryPop(writeEvent))
+            any = true;
+        if(!any)
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    // whatever came in while stopping
+    while(events.tryPop(writeEvent));
+}
+
+void Trace::buffer() {
+    enabled = true;
+}
+
+bool Trace::start(std::string const& path) {
+    if(running())
+        return true;
+    file = fopen(path.c_str(), "w");
+    if(!file)
+        return false;
+    // the array format, which doesn't even need the closing bracket if the game crashes
+    fprintf(file, "[");
+    firstEvent = true;
+    writing = true;
+    enabled = true;
+    writer = std::thread(writeLoop);
+    return true;
+}
+
+void Trace::stop() {
+    enabled = false;
+    if(!running()) {
+        while(events.tryPop([](TraceEvent&) {}));
+        events.takeDropped();
+        return;
+    }
+    writing = false;
+    writer.join();
+    // note lost events in the trace itself
+    if(size_t dropped = events.takeDropped())
+        fprintf(file, "%s\n{\"name\":\"%zu events dropped\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":1,\"tid\":0}", firstEvent ? "" : ",", dropped, now() / 1000.0);
+    fprintf(file, "\n]\n");
+    fclose(file);
+    file = nullptr;
+}
+
+bool Trace::running() {
+    return writing.load(std::memory_order_relaxed);
+}
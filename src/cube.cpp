@@ -1,32 +1,43 @@
 #include "main.hpp"
 #include "assets.hpp"
+#include "core/cut.hpp"
+#include "core/stats.hpp"
+#include "core/allocations.hpp"
+#include "core/memory.hpp"
 
 #include "GlobalNamespace/ILevelRestartController.hpp"
 #include "GlobalNamespace/IReturnToMenuController.hpp"
-#include "GlobalNamespace/CuttableBySaber_WasCutBySaberDelegate.hpp"
 #include "GlobalNamespace/ColorType.hpp"
 #include "GlobalNamespace/INoteDebrisDidFinishEvent.hpp"
 #include "GlobalNamespace/ILazyCopyHashSet_1.hpp"
 #include "GlobalNamespace/SharedCoroutineStarter.hpp"
 #include "GlobalNamespace/SaberTypeObject.hpp"
 #include "GlobalNamespace/SaberTypeExtensions.hpp"
+#include "GlobalNamespace/GamePause.hpp"
+#include "GlobalNamespace/PauseMenuManager.hpp"
+#include "GlobalNamespace/BeatmapObjectManager.hpp"
+#include "System/Action.hpp"
 #include "Libraries/HM/HMLib/VR/HapticPresetSO.hpp"
 
 #include "UnityEngine/EventSystems/PointerEventData.hpp"
 #include "UnityEngine/MeshRenderer.hpp"
-#include "UnityEngine/Random.hpp"
+#include "UnityEngine/BoxCollider.hpp"
 #include "UnityEngine/Time.hpp"
-#include "UnityEngine/Mathf.hpp"
 
 #include "System/Collections/IEnumerator.hpp"
 #include "UnityEngine/WaitForSeconds.hpp"
 
 #include "questui/shared/BeatSaberUI.hpp"
 
+#include <unordered_map>
+
 DEFINE_TYPE(Qubes, DefaultCube);
 DEFINE_TYPE(Qubes, Cube);
 DEFINE_TYPE(Qubes, EditMenu);
 
+static_assert(sizeof(Math::Vec3) == sizeof(UnityEngine::Vector3) && offsetof(Math::Vec3, z) == offsetof(UnityEngine::Vector3, z));
+static_assert(sizeof(Math::Quat) == sizeof(UnityEngine::Quaternion) && offsetof(Math::Quat, w) == offsetof(UnityEngine::Quaternion, w));
+
 using namespace Qubes;
 using namespace QuestUI;
 
@@ -36,72 +47,147 @@ using namespace QuestUI;
 
 #pragma region nonClass
 const std::vector<std::string> cubeTypes = { "Blank", "Dot", "Arrow" };
-const std::vector<std::string> cutEvents = { "None", "Pause", "Restart", "Menu", "Crash" };
 
 #define START_CO(coroutine) StartCoroutine(custom_types::Helpers::CoroutineHelper::New(coroutine))
 #define COROUTINE(coroutine) GlobalNamespace::SharedCoroutineStarter::get_instance()->START_CO(coroutine)
 
-#define GET_SPRITE(name) auto name##_arr = Array<uint8_t>::NewLength(name##_png::getLength()); \
+#define GET_SPRITE(name) TRACK_ALLOC("GET_SPRITE " #name, sizeof(Array<uint8_t>) + name##_png::getLength()); \
+Stats::spriteBytes.fetch_add(name##_png::getLength() + Memory::pngTextureBytes(name##_png::getData(), name##_png::getLength()), std::memory_order_relaxed); \
+auto name##_arr = Array<uint8_t>::NewLength(name##_png::getLength()); \
 memcpy(name##_arr->values, name##_png::getData(), name##_png::getLength()); \
 auto name##_sprite = BeatSaberUI::ArrayToSprite(name##_arr);
 
 custom_types::Helpers::Coroutine crashCoroutine() {
+    Stats::Scoped running(Stats::coroutines);
+    TRACK_ALLOC("crashCoroutine WaitForSeconds", sizeof(UnityEngine::WaitForSeconds));
     co_yield (System::Collections::IEnumerator*) UnityEngine::WaitForSeconds::New_ctor(0.5);
+    // logged directly since the queue won't be written after this
     getLogger().info("Crashing");
     SAFE_ABORT();
     co_return;
 }
+// hit actions, the built in ones keep the ids they had before other mods could add more
+static void pauseAction(CutEvent const& event, void*) {
+    LOG_INFO("pause");
+    // pauser->Pause(); // doesn't work with fish utils's pause tweaks
+    if(pauser->get_canPause()) {
+        pauser->paused = true;
+        pauser->gamePause->Pause();
+        pauser->pauseMenuManager->ShowMenu();
+        pauser->beatmapObjectManager->HideAllBeatmapObjects(true);
+        pauser->beatmapObjectManager->PauseAllBeatmapObjects(true);
+        if(pauser->didPauseEvent)
+            pauser->didPauseEvent->Invoke();
+        pointer = UnityEngine::Resources::FindObjectsOfTypeAll<VRUIControls::VRPointer*>()[1];
+        inMenu = true;
+        updateBroadphase();
+    }
+}
+static void restartAction(CutEvent const& event, void*) {
+    LOG_INFO("restart");
+    pauser->levelRestartController->RestartLevel();
+}
+static void menuAction(CutEvent const& event, void*) {
+    LOG_INFO("menu");
+    pauser->returnToMenuController->ReturnToMenu();
+}
+static void crashAction(CutEvent const& event, void*) {
+    LOG_INFO("crash");
+    COROUTINE(crashCoroutine());
+}
+
+// made before any mod's load, so the built in ones are always first in the menus
+static HitActionTable builtinHitActions() {
+    HitActionTable table;
+    table.addBuiltin(0, "None", nullptr);
+    table.addBuiltin(1, "Pause", pauseAction);
+    table.addBuiltin(2, "Restart", restartAction);
+    table.addBuiltin(3, "Menu", menuAction);
+    table.addBuiltin(4, "Crash", crashAction);
+    return table;
+}
+HitActionTable hitActions = builtinHitActions();
+CutBus cutBus;
+
+// cubes by their hitbox, for the cut hook
+static std::unordered_map<GlobalNamespace::BoxCuttableBySaber*, Cube*> cutTargets;
+
+void addCutTarget(Cube* cube) {
+    cutTargets[cube->getHitbox()] = cube;
+}
+
+void removeCutTarget(Cube* cube) {
+    cutTargets.erase(cube->getHitbox());
+}
+
+Cube* findCutTarget(GlobalNamespace::BoxCuttableBySaber* hitbox) {
+    auto found = cutTargets.find(hitbox);
+    return found == cutTargets.end() ? nullptr : found->second;
+}
+
 custom_types::Helpers::Coroutine deleteCoroutine(GlobalNamespace::NoteDebris* debris) {
+    Stats::Scoped running(Stats::coroutines);
+    TRACK_ALLOC("deleteCoroutine WaitForSeconds", sizeof(UnityEngine::WaitForSeconds));
     co_yield (System::Collections::IEnumerator*) UnityEngine::WaitForSeconds::New_ctor(1.5);
-    getLogger().info("Deleting debris");
+    LOG_DEBUG("Deleting debris");
     auto ob = debris->get_gameObject();
     if(ob)
         UnityEngine::Object::Destroy(ob);
+    Stats::debrisAlive.fetch_sub(1, std::memory_order_relaxed);
     co_return;
 }
 
-void spawnDebris(UnityEngine::Vector3 cutPoint, UnityEngine::Vector3 cutNormal, float saberSpeed, UnityEngine::Vector3 saberDir, UnityEngine::Vector3 notePos, UnityEngine::Quaternion noteRotation, UnityEngine::Vector3 noteScale, UnityEngine::Color color) {
-    GlobalNamespace::NoteDebris* noteDebris = UnityEngine::Object::Instantiate<GlobalNamespace::NoteDebris*>(debrisPrefab);
-    GlobalNamespace::NoteDebris* noteDebris2 = UnityEngine::Object::Instantiate<GlobalNamespace::NoteDebris*>(debrisPrefab);
+// visual randomness for debris, doesn't need unity's generator
+Math::Random debrisRandom;
 
-    UnityEngine::Vector3 vector = saberDir * (saberSpeed * 0.1);
+void spawnDebris(GlobalNamespace::NoteDebris* prefab, Math::Vec3 cutPoint, Math::Vec3 cutNormal, float saberSpeed, Math::Vec3 saberDir, Math::Vec3 notePos, Math::Quat noteRotation, Math::Vec3 noteScale, UnityEngine::Color color) {
+    GlobalNamespace::NoteDebris* noteDebris = UnityEngine::Object::Instantiate<GlobalNamespace::NoteDebris*>(prefab);
+    GlobalNamespace::NoteDebris* noteDebris2 = UnityEngine::Object::Instantiate<GlobalNamespace::NoteDebris*>(prefab);
+
+    Math::Vec3 vector = saberDir * (saberSpeed * 0.1);
     if(cutPoint.y < 1.3)
         vector.y = std::min(vector.y, (float)0);
     else if(cutPoint.y > 1.3)
         vector.y = std::max(vector.y, (float)0);
 
-    UnityEngine::Quaternion rotation = UnityEngine::Quaternion::get_identity();
-    UnityEngine::Vector3 force = rotation * (-(cutNormal + UnityEngine::Random::get_onUnitSphere() * 0.1) * 2 + vector);
-    UnityEngine::Vector3 force2 = rotation * ((cutNormal + UnityEngine::Random::get_onUnitSphere() * 0.1) * 2 + vector);
-    UnityEngine::Vector3 vector2 = rotation * UnityEngine::Vector3::Cross(cutNormal, saberDir) * 0.5;
+    Math::Quat rotation = Math::Quat::identity();
+    Math::Vec3 force = rotation * (-(cutNormal + debrisRandom.onUnitSphere() * 0.1) * 2 + vector);
+    Math::Vec3 force2 = rotation * ((cutNormal + debrisRandom.onUnitSphere() * 0.1) * 2 + vector);
+    Math::Vec3 vector2 = rotation * Math::cross(cutNormal, saberDir) * 0.5;
     
     lastColor = color;
-    noteDebris->Init(GlobalNamespace::ColorType::_get_None(), notePos, noteRotation, UnityEngine::Vector3::get_zero(), noteScale, UnityEngine::Vector3::get_zero(), rotation, cutPoint, -cutNormal, force, -vector2, 2);
-    noteDebris2->Init(GlobalNamespace::ColorType::_get_None(), notePos, noteRotation, UnityEngine::Vector3::get_zero(), noteScale, UnityEngine::Vector3::get_zero(), rotation, cutPoint, cutNormal, force2, vector2, 2);
+    noteDebris->Init(GlobalNamespace::ColorType::_get_None(), notePos, noteRotation, Math::Vec3::zero(), noteScale, Math::Vec3::zero(), rotation, cutPoint, -cutNormal, force, -vector2, 2);
+    noteDebris2->Init(GlobalNamespace::ColorType::_get_None(), notePos, noteRotation, Math::Vec3::zero(), noteScale, Math::Vec3::zero(), rotation, cutPoint, cutNormal, force2, vector2, 2);
+    Stats::debrisAlive.fetch_add(2, std::memory_order_relaxed);
     noteDebris->START_CO(deleteCoroutine(noteDebris));
     noteDebris2->START_CO(deleteCoroutine(noteDebris2));
 
-    getLogger().info("Custom debris spawned"); // actually just copied from the game, with some unnecessary variables removed
+    LOG_DEBUG("Custom debris spawned"); // actually just copied from the game, with some unnecessary variables removed
 }
 #pragma endregion
 
 #pragma region defaultCube
-UnityEngine::Transform* DefaultCube::findTransform(std::string_view name) {
-    // finds children transforms by name
-    return get_transform()->Find(name);
-}
-
 void DefaultCube::init(UnityEngine::Color color, int cubeType, int onHit, float cubeSize, bool lock, QubesConfig& cfg, int cfg_index) {
-    getLogger().info("Initializing cube");
+    LOG_DEBUG("Initializing cube");
+    Stats::cubes.fetch_add(1, std::memory_order_relaxed);
 
     material = GetComponent<UnityEngine::MeshRenderer*>()->get_material();
 
-    UnityEngine::Object::Destroy(findTransform("BigCuttable")->get_gameObject());
+    // the prototype was baked with these at fixed indices, no need to search by name
+    auto t = get_transform();
+    arrow = t->GetChild(cubeParts.arrow);
+    arrowGlow = t->GetChild(cubeParts.arrowGlow);
+    circleGlow = t->GetChild(cubeParts.circleGlow);
+    cuttable = t->GetChild(cubeParts.cuttable);
 
     menuActive = false;
     typeSet = false;
+    glowHidden = false;
+    staticId = -1;
+    animSlot = -1;
+    physSlot = -1;
     // shows dot for one frame because it doesn't render if you don't
-    findTransform("NoteCircleGlow")->get_gameObject()->set_active(true);
+    circleGlow->get_gameObject()->set_active(true);
     type = cubeType;
 
     config = &cfg;
@@ -111,17 +197,28 @@ void DefaultCube::init(UnityEngine::Color color, int cubeType, int onHit, float
     setColor(color);
     setSize(cubeSize);
 
-    auto renderers = GetComponentsInChildren<UnityEngine::Renderer*>();
-    for(int i = 0; i < renderers.Length(); i++) {
-        renderers[i]->set_enabled(true);
-    }
-    findTransform("SmallCuttable")->GetComponent<GlobalNamespace::BoxCuttableBySaber*>()->set_colliderSize({0.5, 0.5, 0.5});
-
     get_gameObject()->set_active(true);
 }
 
+void DefaultCube::OnDestroy() {
+    Stats::cubes.fetch_sub(1, std::memory_order_relaxed);
+    if(staticId >= 0)
+        removeStatic(staticId);
+    removeCubeAnimation(this);
+    stopCubePhysics(this);
+    // only placed cubes are cuttable ones
+    if(placed)
+        removeCutTarget((Cube*) this);
+}
+
+void DefaultCube::destroy() {
+    if(menu)
+        UnityEngine::Object::Destroy(menu->get_gameObject());
+    UnityEngine::Object::Destroy(get_gameObject());
+}
+
 void DefaultCube::makeMenu() {
-    getLogger().info("Creating menu");
+    LOG_DEBUG("Creating menu");
     auto go = BeatSaberUI::CreateCanvas();
     UnityEngine::Object::DontDestroyOnLoad(go);
     // makes it render on the same layer as the pause menu
@@ -131,6 +228,8 @@ void DefaultCube::makeMenu() {
 }
 
 void DefaultCube::setActive(bool active) {
+    if(staticId >= 0 && get_gameObject()->get_activeSelf() != active)
+        markStaticDirty(staticId);
     get_gameObject()->set_active(active);
     if(!typeSet && active)
         setType(type);
@@ -148,27 +247,102 @@ void DefaultCube::setMenuActive(bool active) {
 }
 
 void DefaultCube::save() {
-    config->SetCubeValue(index, CubeInfo(this));
+    config->SetCubeValue(index, getInfo());
+}
+
+CubeInfo DefaultCube::getInfo() {
+    auto t = get_transform();
+    CubeInfo info(t->get_position(), t->get_rotation(), color, type, hitAction, size, locked);
+    // animated cubes save the pose they move around, not where they are right now
+    if(animSlot >= 0)
+        animatedInfo(animSlot, info);
+    return info;
+}
+
+// halfway to white, or to black for colors that are already bright
+static UnityEngine::Color highlightColor(UnityEngine::Color color) {
+    float target = color.r * 0.3 + color.g * 0.59 + color.b * 0.11 > 0.75 ? 0 : 1;
+    return {(color.r + target) / 2, (color.g + target) / 2, (color.b + target) / 2, color.a};
+}
+
+UnityEngine::Color DefaultCube::getShownColor() {
+    return highlighted ? highlightColor(color) : color;
 }
 
 void DefaultCube::setColor(UnityEngine::Color color) {
     this->color = color;
-    material->set_color(color);
+    auto shown = getShownColor();
+    material->set_color(shown);
+    if(staticId >= 0)
+        setStaticColor(staticId, shown);
     if(menu)
         menu->colButtonController->SetColor(color);
 }
 
+void DefaultCube::setHighlighted(bool highlight) {
+    if(highlight == highlighted)
+        return;
+    highlighted = highlight;
+    setColor(color);
+}
+
 void DefaultCube::setType(int cubeType) {
     type = cubeType;
     typeSet = true;
-    findTransform("NoteArrow")->get_gameObject()->set_active(false);
+    arrow->get_gameObject()->set_active(false);
     // 0: nothing, 1: dot, 2: arrow
-    findTransform("NoteCircleGlow")->get_gameObject()->set_active(cubeType == 1);
-    findTransform("NoteArrowGlow")->get_gameObject()->set_active(cubeType == 2);
+    circleGlow->get_gameObject()->set_active(cubeType == 1 && !glowHidden);
+    arrowGlow->get_gameObject()->set_active(cubeType == 2 && !glowHidden);
+}
+
+void DefaultCube::setFlashing(bool flash) {
+    flashing = flash;
+    refreshStatic();
+}
+
+void DefaultCube::setLocked(bool lock) {
+    locked = lock;
+    refreshStatic();
+}
+
+void DefaultCube::refreshStatic() {
+    bool shouldBeStatic = placed && !flashing && animSlot < 0 && physSlot < 0 && (locked || getModConfig().FreezeLayout.GetValue());
+    if(shouldBeStatic == isStatic())
+        return;
+    auto renderer = GetComponent<UnityEngine::MeshRenderer*>();
+    if(shouldBeStatic) {
+        // nothing can move it anymore, so clamp once instead of every frame
+        auto t = get_transform();
+        Math::Vec3 pos = t->get_position();
+        if(pos.y < 0)
+            t->set_position(clampAboveFloor(pos));
+        staticId = addStatic(this);
+        renderer->set_enabled(false);
+        // the type still has to be set a frame after creation, Update turns it off after that
+        set_enabled(!typeSet);
+    } else {
+        removeStatic(staticId);
+        staticId = -1;
+        renderer->set_enabled(true);
+        set_enabled(true);
+    }
+}
+
+void DefaultCube::setGlowHidden(bool hidden) {
+    if(hidden == glowHidden)
+        return;
+    glowHidden = hidden;
+    if(typeSet)
+        setType(type);
 }
 
 void DefaultCube::setSize(float newSize) {
     size = newSize;
+    markBroadphaseDirty();
+    if(staticId >= 0)
+        markStaticDirty(staticId);
+    if(animSlot >= 0)
+        resizeAnimatedCube(this);
     get_transform()->set_localScale({size, size, size});
     if(menu) {
         float inv_size = 0.03/size;
@@ -179,15 +353,19 @@ void DefaultCube::setSize(float newSize) {
 
 #pragma region cube
 custom_types::Helpers::Coroutine Cube::respawnCoroutine() {
+    Stats::Scoped running(Stats::coroutines);
+    TRACK_ALLOC("respawnCoroutine WaitForSeconds", sizeof(UnityEngine::WaitForSeconds));
     co_yield (System::Collections::IEnumerator*) UnityEngine::WaitForSeconds::New_ctor(getModConfig().RespawnTime.GetValue());
     auto ob = get_gameObject();
     // don't respawn if in menu and show in menu is disabled
-    if(ob && !(inMenu && !getModConfig().ShowInMenu.GetValue()))
-        ob->set_active(true);
+    if(ob && !pooled && !(inMenu && !getModConfig().ShowInMenu.GetValue()))
+        setActive(true);
     co_return;
 }
 
 custom_types::Helpers::Coroutine Cube::cuttableCoroutine(bool cuttable, float seconds) {
+    Stats::Scoped running(Stats::coroutines);
+    TRACK_ALLOC("cuttableCoroutine WaitForSeconds", sizeof(UnityEngine::WaitForSeconds));
     co_yield (System::Collections::IEnumerator*) UnityEngine::WaitForSeconds::New_ctor(seconds);
     if(hitbox)
         hitbox->set_canBeCut(cuttable);
@@ -204,13 +382,29 @@ void Cube::setCuttableDelay(bool cuttable, float seconds) {
 void Cube::init(UnityEngine::Color color, int cubeType, int onHit, float cubeSize, bool lock, QubesConfig& cfg, int cfg_index) {
     DefaultCube::init(color, cubeType, onHit, cubeSize, lock, cfg, cfg_index);
 
-    hitbox = findTransform("SmallCuttable")->GetComponent<GlobalNamespace::BoxCuttableBySaber*>();
+    hitbox = cuttable->GetComponent<GlobalNamespace::BoxCuttableBySaber*>();
+    sweepId = -1;
+    placed = true;
+    refreshStatic();
+
+    addCutTarget(this);
+}
+
+OBB Cube::getCutBounds() {
+    auto t = hitbox->get_transform();
+    // the collider size was set to 0.5 on the prototype
+    return {t->get_position(), t->get_rotation(), Math::Vec3(t->get_lossyScale()) * 0.25f};
+}
+
+bool Cube::cuttableNow() {
+    return get_gameObject()->get_activeInHierarchy() && hitbox->get_canBeCut();
+}
 
-    hitbox->add_wasCutBySaberEvent(il2cpp_utils::MakeDelegate<GlobalNamespace::CuttableBySaber::WasCutBySaberDelegate*>(classof(GlobalNamespace::CuttableBySaber::WasCutBySaberDelegate*),
-      (std::function<void(GlobalNamespace::Saber* saber, UnityEngine::Vector3 cutPoint, UnityEngine::Quaternion orientation, UnityEngine::Vector3 cutDirVec)>)
-      [this](GlobalNamespace::Saber* saber, UnityEngine::Vector3 cutPoint, UnityEngine::Quaternion orientation, UnityEngine::Vector3 cutDirVec){
-        this->handleCut(saber, cutPoint, orientation, cutDirVec);
-    }));
+void Cube::setColliderEnabled(bool enabled) {
+    if(colliderOff == !enabled)
+        return;
+    colliderOff = !enabled;
+    hitbox->GetComponent<UnityEngine::BoxCollider*>()->set_enabled(enabled);
 }
 
 void Cube::setMenuActive(bool active) {
@@ -222,145 +416,169 @@ void Cube::setMenuActive(bool active) {
     }
 }
 
+void Cube::setInfo(CubeInfo const& info) {
+    stopCubePhysics(this);
+    // the new animation moves around the new pose, not the old base
+    removeCubeAnimation(this);
+    get_transform()->SetPositionAndRotation(info.pos, info.rot);
+    setColor(info.color);
+    setType(info.type);
+    setHitAction(info.hitAction);
+    setSize(info.size);
+    setLocked(info.locked);
+    if(info.animation.motion != Motion::None)
+        setCubeAnimation(this, info.animation);
+    if(staticId >= 0)
+        markStaticDirty(staticId);
+    markBroadphaseDirty();
+}
+
 void Cube::Update() {
-    // avoid moving underground
-    if(get_transform()->get_position().y < 0) {
-        auto pos = get_transform()->get_position();
-        get_transform()->set_position({pos.x, 0, pos.z});
+    TRACE_ZONE("Cube::Update");
+    FRAME_TIMER();
+    auto t = get_transform();
+    // avoid moving underground, thrown cubes land on the floor instead
+    Math::Vec3 pos = t->get_position();
+    if(pos.y < 0 && physSlot < 0 && !controller) {
+        if(getModConfig().ThrowCubes.GetValue() && animSlot < 0)
+            throwCube(this, Math::Vec3::zero(), Math::Vec3::zero());
+        else
+            t->set_position(clampAboveFloor(pos));
     }
     if(!typeSet)
         setType(type);
+    // static cubes only run once, to set the type
+    if(isStatic()) {
+        set_enabled(false);
+        return;
+    }
 
     if(!pointer || locked)
         return;
 
     // check if being grabbed
     bool wasGrabbing = !(controller == nullptr);
-    if(pointer->get_vrController()->get_triggerValue() > 0.9) {
+    if(pointer->get_vrController()->get_triggerValue() > GrabTrigger) {
         // pointerData can be null when not loaded (aka on soft restarts, generally)
         if(controller == pointer->get_vrController() || !pointer->pointerData)
             return;
         // check if pointer is on the cube
         if(pointer->pointerData->pointerCurrentRaycast.get_gameObject() == hitbox->get_gameObject()) {
             controller = pointer->get_vrController();
-            grabPos = pointer->get_vrController()->get_transform()->InverseTransformPoint(get_transform()->get_position());
-            grabRot = UnityEngine::Quaternion::Inverse(pointer->get_vrController()->get_transform()->get_rotation()) * get_transform()->get_rotation();
+            auto ct = controller->get_transform();
+            grab.begin({ct->get_position(), ct->get_rotation()}, {t->get_position(), t->get_rotation()});
+            // catching a thrown cube
+            stopCubePhysics(this);
+            throwTracker.reset();
         } else
             controller = nullptr;
     } else
         controller = nullptr;
     // save config on release
-    if(wasGrabbing && !controller)
+    if(wasGrabbing && !controller) {
+        grabReleased();
+        if(animSlot >= 0)
+            moveAnimatedCube(this);
+        // saved once it comes to rest
+        if(getModConfig().ThrowCubes.GetValue() && animSlot < 0 && Math::magnitude(throwTracker.velocity()) > ThrowSpeed) {
+            throwCube(this, throwTracker.velocity(), throwTracker.angularVelocity());
+            return;
+        }
         save();
+    }
 }
 
 void Cube::LateUpdate() {
+    TRACE_ZONE("Cube::LateUpdate");
+    FRAME_TIMER();
     if(!controller || locked || !pointer)
         return;
-    // thumbstick movement
-    if(pointer->_get__lastControllerUsedWasRight() == !getModConfig().LeftThumbMove.GetValue()) {
-        float diff = controller->get_verticalAxisValue() * UnityEngine::Time::get_unscaledDeltaTime() * getModConfig().MoveSpeed.GetValue();
-        // no movement if too close
-        if(grabPos.get_magnitude() < 0.5 * size && diff > 0)
-            diff = 0;
-        grabPos = grabPos - (UnityEngine::Vector3::get_forward() * diff);
-    }
+    float deltaTime = UnityEngine::Time::get_unscaledDeltaTime();
+    GrabSettings settings = {getModConfig().MoveSpeed.GetValue(), getModConfig().RotSpeed.GetValue(), getModConfig().LeftThumbMove.GetValue()};
+    grab.applyThumbsticks(controller->get_horizontalAxisValue(), controller->get_verticalAxisValue(), pointer->_get__lastControllerUsedWasRight(), settings, size, deltaTime);
 
-    // thumbstick rotation
-    if(pointer->_get__lastControllerUsedWasRight() == getModConfig().LeftThumbMove.GetValue()) {
-        // scale values to a reasonable "1" speed
-        float v_move = -20 * controller->get_verticalAxisValue() * UnityEngine::Time::get_unscaledDeltaTime() * getModConfig().RotSpeed.GetValue();
-        float h_move = -20 * controller->get_horizontalAxisValue() * UnityEngine::Time::get_unscaledDeltaTime() * getModConfig().RotSpeed.GetValue();
-        auto extraRot = UnityEngine::Quaternion::Euler({0, h_move, 0}) * UnityEngine::Quaternion::Euler({v_move, 0, 0});
-        grabRot = grabRot * extraRot;
+    if(getModConfig().DirectGrab.GetValue()) {
+        holdUntilRender(this, controller, deltaTime);
+        return;
     }
+    auto t = get_transform();
+    auto ct = controller->get_transform();
+    auto target = grab.target({ct->get_position(), ct->get_rotation()});
+    auto pose = followGrab({t->get_position(), t->get_rotation()}, target, deltaTime);
+    t->SetPositionAndRotation(pose.pos, pose.rot);
+    throwTracker.push(pose, deltaTime);
+    recordGrabLatency(controller, pose.pos, target.pos, deltaTime);
+}
 
-    auto pos = controller->get_transform()->TransformPoint(grabPos);
-    auto rot = controller->get_transform()->get_rotation() * grabRot;
-    
-    get_transform()->set_position(UnityEngine::Vector3::Lerp(get_transform()->get_position(), pos, 10 * UnityEngine::Time::get_unscaledDeltaTime()));
-    get_transform()->set_rotation(UnityEngine::Quaternion::Slerp(get_transform()->get_rotation(), rot, 5 * UnityEngine::Time::get_unscaledDeltaTime()));
+void Cube::applyGrab(float deltaTime) {
+    // released or locked since LateUpdate
+    if(!controller || locked)
+        return;
+    // the controller was already read again for this
+    auto t = get_transform();
+    auto ct = controller->get_transform();
+    auto target = grab.target({ct->get_position(), ct->get_rotation()});
+    auto pose = smoothGrab({t->get_position(), t->get_rotation()}, target, getModConfig().GrabSmoothing.GetValue(), deltaTime);
+    t->SetPositionAndRotation(pose.pos, pose.rot);
+    throwTracker.push(pose, deltaTime);
+    recordGrabLatency(controller, pose.pos, target.pos, deltaTime);
 }
 
-#include "GlobalNamespace/GamePause.hpp"
-#include "GlobalNamespace/PauseMenuManager.hpp"
-#include "GlobalNamespace/BeatmapObjectManager.hpp"
-#include "System/Action.hpp"
+void Cube::OnEnable() {
+    Stats::activeCubes.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Cube::OnDisable() {
+    Stats::activeCubes.fetch_sub(1, std::memory_order_relaxed);
+}
 
 void Cube::handleCut(GlobalNamespace::Saber* saber, UnityEngine::Vector3 cutPoint, UnityEngine::Quaternion orientation, UnityEngine::Vector3 cutDirVec) {
-    getLogger().info("Qube cut");
+    TRACE_ZONE("handleCut");
+    FRAME_TIMER();
+    LOG_DEBUG("Qube cut");
     
-    if(getModConfig().ReqDirection.GetValue() && type == 2) {
-        using UnityEngine::Mathf;
-        auto cutDirVec2 = get_transform()->InverseTransformVector(cutDirVec);
-        bool flag = Mathf::Abs(cutDirVec2.z) > Mathf::Abs(cutDirVec2.x) * 10 && Mathf::Abs(cutDirVec2.z) > Mathf::Abs(cutDirVec2.y) * 10;
-        float cutDirAngle = Mathf::Atan2(cutDirVec2.y, cutDirVec2.x) * 57.29578;
-        float cutAngleTolerance = 50; // 60 default, 40 on strict angles
-        bool dirOk = !flag && cutDirAngle > -90 - cutAngleTolerance && cutDirAngle < -90 + cutAngleTolerance;
-        if(!dirOk)
-            return;
-    }
+    // 60 default tolerance, 40 on strict angles, we use 50
+    if(getModConfig().ReqDirection.GetValue() && type == 2 && !cutDirectionOk(get_transform()->InverseTransformVector(cutDirVec), 50))
+        return;
     // avoid nullptr
-    if(debrisPrefab && getModConfig().Debris.GetValue())
-        spawnDebris(cutPoint, orientation * UnityEngine::Vector3::get_up(), saber->get_bladeSpeed(), cutDirVec.get_normalized(), get_transform()->get_position(), get_transform()->get_rotation(), get_transform()->get_localScale(), color);
+    // the quality governor can pick lighter debris or none at all
+    auto prefab = getModConfig().Debris.GetValue() ? takeDebrisPrefab() : nullptr;
+    if(prefab)
+        spawnDebris(prefab, cutPoint, Math::Quat(orientation) * Math::Vec3::up(), saber->get_bladeSpeed(), Math::normalized(cutDirVec), get_transform()->get_position(), get_transform()->get_rotation(), get_transform()->get_localScale(), color);
     
     // give haptic feedback
-    static Libraries::HM::HMLib::VR::HapticPresetSO* hapticPreset = Libraries::HM::HMLib::VR::HapticPresetSO::New_ctor();
+    static Libraries::HM::HMLib::VR::HapticPresetSO* hapticPreset = nullptr;
+    if(!hapticPreset) {
+        TRACK_ALLOC("handleCut HapticPresetSO", sizeof(Libraries::HM::HMLib::VR::HapticPresetSO));
+        hapticPreset = Libraries::HM::HMLib::VR::HapticPresetSO::New_ctor();
+    }
     hapticPreset->strength = getModConfig().Vibration.GetValue();
     haptics->PlayHapticFeedback(GlobalNamespace::SaberTypeExtensions::Node(saber->saberType->get_saberType()), hapticPreset);
 
     if(getModConfig().RespawnTime.GetValue() > 0) {
-        get_gameObject()->set_active(false);
+        setActive(false);
         COROUTINE(respawnCoroutine());
     } else {
         // avoid cutting at an unreasonable rate
         hitbox->set_canBeCut(false);
         setCuttableDelay(true, 0.1);
     }
+    CutEvent event = {get_gameObject(), {cutPoint.x, cutPoint.y, cutPoint.z}, {}, saber->get_bladeSpeed(), saber->get_saberType().value, type, hitAction, inGameplay};
+    Math::Vec3 direction = Math::normalized(cutDirVec);
+    std::copy(&direction.x, &direction.x + 3, event.direction);
+    cutBus.dispatch(event);
     // no hit actions in menu
-    if(!inGameplay)
-        return;
-    switch (hitAction) {
-        case 1:
-            getLogger().info("pause");
-            // pauser->Pause(); // doesn't work with fish utils's pause tweaks
-            if(pauser->get_canPause()) {
-                pauser->paused = true;
-                pauser->gamePause->Pause();
-                pauser->pauseMenuManager->ShowMenu();
-                pauser->beatmapObjectManager->HideAllBeatmapObjects(true);
-                pauser->beatmapObjectManager->PauseAllBeatmapObjects(true);
-                if(pauser->didPauseEvent)
-                    pauser->didPauseEvent->Invoke();
-                pointer = UnityEngine::Resources::FindObjectsOfTypeAll<VRUIControls::VRPointer*>()[1];
-                inMenu = true;
-            }
-            break;
-        case 2:
-            getLogger().info("restart");
-            pauser->levelRestartController->RestartLevel();
-            break;
-        case 3:
-            getLogger().info("menu");
-            pauser->returnToMenuController->ReturnToMenu();
-            break;
-        case 4:
-            getLogger().info("crash");
-            COROUTINE(crashCoroutine());
-            break;
-        default:
-            break;
-    }
+    if(inGameplay)
+        hitActions.run(hitAction, event);
 }
 
 bool Cube::deletePressed(UnityEngine::Transform* hit) {
-    if(locked)
+    // also covers frozen layouts
+    if(locked || isStatic())
         return false;
     if(hit == hitbox->get_transform()) {
         config->RemoveCube(index);
-        if(menu)
-            UnityEngine::Object::Destroy(menu->get_gameObject());
-        UnityEngine::Object::Destroy(get_gameObject());
+        destroy();
         return true;
     }
     return false;
@@ -397,17 +615,22 @@ void Cube::editPressed(UnityEngine::Transform* hit) {
 #include "questui/shared/CustomTypes/Components/Backgroundable.hpp"
 
 void EditMenu::LateUpdate() {
+    FRAME_TIMER();
     // lock non-vertical axis rotation relative to cube
     auto t = get_transform();
     float y = t->get_eulerAngles().y;
     t->set_eulerAngles({0, y, 0});
     // set the position to an x offset rotated based on y rotation
-    auto pos = t->get_parent()->get_position();
+    Math::Vec3 pos = t->get_parent()->get_position();
     // 1.5 = x offset from center
-    auto offsetVec = UnityEngine::Quaternion::AngleAxis(y, UnityEngine::Vector3::get_up()) * UnityEngine::Vector3{1.5, 0, 0};
+    auto offsetVec = Math::angleAxis(y, Math::Vec3::up()) * Math::Vec3{1.5, 0, 0};
     t->set_position(offsetVec + pos);
 }
 
+void EditMenu::OnDestroy() {
+    Stats::menus.fetch_sub(1, std::memory_order_relaxed);
+}
+
 void setButtons(IncrementSetting* inc) {
     auto arr = inc->get_gameObject()->get_transform()->GetChild(1)->GetComponentsInChildren<UnityEngine::UI::Button*>();
     auto decButton = arr[0];
@@ -416,7 +639,9 @@ void setButtons(IncrementSetting* inc) {
     incButton->set_interactable(inc->CurrentValue != inc->MaxValue);
 }
 void EditMenu::init(DefaultCube* parent) {
-    getLogger().info("menu init");
+    TRACE_ZONE("EditMenu::init");
+    LOG_DEBUG("menu init");
+    Stats::menus.fetch_add(1, std::memory_order_relaxed);
     auto background = get_gameObject()->AddComponent<Backgroundable*>();
     background->ApplyBackgroundWithAlpha("round-rect-panel", 0.5);
     background->background->set_raycastTarget(true);
@@ -449,15 +674,37 @@ void EditMenu::init(DefaultCube* parent) {
     typeInc->get_transform()->get_parent()->get_gameObject()->GetComponent<UnityEngine::UI::LayoutElement*>()->set_preferredWidth(60);
     typeInc->Text->SetText(cubeTypes[parent->getType()]);
 
-    eventInc = BeatSaberUI::CreateIncrementSetting(valVertical->get_transform(), "Hit Action", 0, 1, parent->getHitAction(), 0, 4, [parent, this](int value){
-        parent->setHitAction(value);
+    // steps through the table's order, the cube keeps the action's id
+    eventInc = BeatSaberUI::CreateIncrementSetting(valVertical->get_transform(), "Hit Action", 0, 1, std::max(hitActions.index(parent->getHitAction()), 0), 0, hitActions.size() - 1, [parent, this](int value){
+        parent->setHitAction(hitActions.id(value));
         parent->save();
-        this->eventInc->Text->SetText(cutEvents[value]);
+        this->eventInc->Text->SetText(hitActions.name(hitActions.id(value)));
         setButtons(this->eventInc);
     });
     setButtons(eventInc);
     eventInc->get_transform()->get_parent()->get_gameObject()->GetComponent<UnityEngine::UI::LayoutElement*>()->set_preferredWidth(60);
-    eventInc->Text->SetText(cutEvents[parent->getHitAction()]);
+    eventInc->Text->SetText(hitActions.name(parent->getHitAction()));
+
+    // the preview cube doesn't animate
+    if(parent->isPlaced()) {
+        auto animation = parent->getInfo().animation;
+        // paths can only be made in the config or through the api
+        int maxMotion = (int) (animation.path.size() >= 2 ? Motion::Path : Motion::Orbit);
+        motionInc = BeatSaberUI::CreateIncrementSetting(valVertical->get_transform(), "Motion", 0, 1, (int) animation.motion, 0, maxMotion, [parent, this](int value){
+            auto animation = parent->getInfo().animation;
+            // spread out cubes given the same motion so they don't move in sync
+            if(animation.motion == Motion::None)
+                animation.phase = std::fmod(parent->index * 0.618034f, 1.0f);
+            animation.motion = (Motion) value;
+            setCubeAnimation((Cube*) parent, animation);
+            parent->save();
+            this->motionInc->Text->SetText(motionName((Motion) value));
+            setButtons(this->motionInc);
+        });
+        setButtons(motionInc);
+        motionInc->get_transform()->get_parent()->get_gameObject()->GetComponent<UnityEngine::UI::LayoutElement*>()->set_preferredWidth(60);
+        motionInc->Text->SetText(motionName(animation.motion));
+    }
 
     BeatSaberUI::CreateSliderSetting(valVertical->get_transform(), "Qube Size", 0.01, parent->getSize(), 0.25, 1.5, 0, [parent](float value){
         parent->setSize(value);
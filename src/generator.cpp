@@ -0,0 +1,216 @@
+#include "main.hpp"
+#include "core/generator.hpp"
+#include "core/layouts.hpp"
+
+#include "questui/shared/BeatSaberUI.hpp"
+#include "questui/shared/CustomTypes/Components/Settings/IncrementSetting.hpp"
+#include "HMUI/Touchable.hpp"
+#include "UnityEngine/Time.hpp"
+
+#include <ctime>
+
+DEFINE_TYPE(Qubes, GeneratorSettings);
+
+using namespace QuestUI;
+
+#pragma region generating
+Generator configGenerator() {
+    Generator generator;
+    generator.shape = (Shape) std::clamp(getModConfig().GenShape.GetValue(), 0, (int) Shape::Count - 1);
+    generator.count = getModConfig().GenCount.GetValue();
+    generator.seed = getModConfig().GenSeed.GetValue();
+    generator.spacing = getModConfig().GenSpacing.GetValue();
+    // default cube might not be made yet
+    generator.base = defaultCube ? defaultCube->getInfo() : QubesConfigs[1].cubes[0];
+    return generator;
+}
+
+int generateCubes(Generator const& generator, QubesConfig& config) {
+    TRACE_ZONE("generateCubes");
+    auto cubes = generator.generate();
+    int allowed = cubeAllowance();
+    if((int) cubes.size() > allowed) {
+        lastRefusal = "Only " + std::to_string(allowed) + " of " + std::to_string(cubes.size()) + " qubes generated, the qube limits were reached";
+        LOG_WARNING("%s", lastRefusal.c_str());
+        showMessage(lastRefusal);
+        cubes.resize(allowed);
+    }
+    if(cubes.empty())
+        return 0;
+    // one write, and one undo step for all of them
+    int start = config.cubes.size();
+    config.AddCubes(cubes);
+    // other mods make theirs with CreateCube
+    if(&config == &QubesConfigs[0] && created) {
+        cubeArr.reserve(cubeArr.size() + cubes.size());
+        for(int i = 0; i < cubes.size(); i++)
+            cubeArr.push_back(makeCube(cubes[i], config, start + i));
+        markBroadphaseDirty();
+    }
+    return cubes.size();
+}
+#pragma endregion
+
+#pragma region stressTest
+// each step generates this many cubes in a layout of its own, then measures frames while they're shown
+static constexpr int StressCounts[] = {100, 1000, 5000, 10000};
+static constexpr char StressLayout[] = "Stress Test";
+// frames after generating that aren't counted, while everything settles
+static constexpr int WarmupFrames = 30;
+// as many as the frame time buffer holds
+static constexpr int MeasuredFrames = 256;
+
+static bool stressRunning = false;
+static int stressStep = 0, stressFrame = 0;
+static Generator stressGenerator;
+static StressResult stressResult;
+static std::vector<StressResult> stressResults;
+static Stats::FrameTimes stressFrames;
+static std::string stressReturnLayout, stressStatus;
+
+static double millisSince(uint64_t start) {
+    return (Trace::now() - start) / 1e6;
+}
+
+static void startStressStep() {
+    auto& config = QubesConfigs[0];
+    std::vector<int> all(cubeArr.size());
+    for(int i = 0; i < all.size(); i++)
+        all[i] = i;
+    eraseCubes(all);
+
+    stressGenerator.count = StressCounts[stressStep];
+    stressResult = {};
+    stressResult.shape = stressGenerator.shape;
+    auto start = Trace::now();
+    stressResult.cubes = generateCubes(stressGenerator, config);
+    stressResult.createMs = millisSince(start);
+    start = Trace::now();
+    config.storage->Write();
+    stressResult.saveMs = millisSince(start);
+    start = Trace::now();
+    auto loaded = loadLayout(layoutFolder(), StressLayout);
+    stressResult.loadMs = millisSince(start);
+    if(!loaded.error.empty())
+        LOG_WARNING("Stress test couldn't read its layout back: %s", loaded.error.c_str());
+
+    stressFrame = 0;
+    stressFrames.clear();
+    stressStatus = "Measuring " + std::to_string(stressResult.cubes) + " qubes";
+}
+
+static void finishStressTest() {
+    stressRunning = false;
+    std::string path = getDataDir(modInfo) + "stress_" + std::to_string(std::time(nullptr)) + ".csv";
+    auto csv = stressCsv(stressResults);
+    if(FILE* file = fopen(path.c_str(), "w")) {
+        fwrite(csv.data(), 1, csv.size(), file);
+        fclose(file);
+        stressStatus = "Results written to " + path;
+        LOG_INFO("%s", stressStatus.c_str());
+    } else {
+        stressStatus = "Couldn't write " + path;
+        LOG_ERROR("%s", stressStatus.c_str());
+    }
+    // a level would have switched to its own already
+    if(activeLayout() == StressLayout)
+        switchLayout(stressReturnLayout);
+    deleteLayout(StressLayout);
+    // back to recording edits
+    initHistory();
+}
+
+bool startStressTest() {
+    if(stressRunning || !created || !inMenu)
+        return false;
+    // left over from a run that was interrupted
+    deleteLayout(StressLayout);
+    stressReturnLayout = activeLayout();
+    if(!createLayout(StressLayout) || !switchLayout(StressLayout)) {
+        stressStatus = "Couldn't make the stress test layout";
+        return false;
+    }
+    LOG_INFO("Starting stress test");
+    stressGenerator = configGenerator();
+    stressResults.clear();
+    stressStep = 0;
+    stressRunning = true;
+    // erasing thousands of cubes between steps would fill the history for nothing
+    QubesConfigs[0].history = nullptr;
+    startStressStep();
+    return true;
+}
+
+void updateStressTest() {
+    if(!stressRunning)
+        return;
+    // a level started, which switched layouts anyway
+    if(!inMenu || activeLayout() != StressLayout) {
+        LOG_WARNING("Stress test interrupted after %i steps", (int) stressResults.size());
+        finishStressTest();
+        return;
+    }
+    if(stressFrame++ >= WarmupFrames)
+        stressFrames.push(UnityEngine::Time::get_unscaledDeltaTime() * 1e9);
+    if(stressFrame < WarmupFrames + MeasuredFrames)
+        return;
+    stressResult.frameMsP50 = stressFrames.percentile(0.5) / 1e6;
+    stressResult.frameMsP99 = stressFrames.percentile(0.99) / 1e6;
+    stressResult.memoryBytes = memoryReport().total;
+    stressResults.push_back(stressResult);
+    // past the limits the later steps would only repeat this one
+    if(++stressStep < std::size(StressCounts) && stressResult.cubes == StressCounts[stressStep - 1])
+        startStressStep();
+    else
+        finishStressTest();
+}
+#pragma endregion
+
+#pragma region generatorSettings
+static IncrementSetting* shapeInc = nullptr;
+
+void GeneratorSettings::DidActivate(bool firstActivation, bool addedToHierarchy, bool screenSystemEnabling) {
+    if(!firstActivation) {
+        refresh();
+        return;
+    }
+    get_gameObject()->AddComponent<HMUI::Touchable*>();
+    auto vertical = BeatSaberUI::CreateVerticalLayoutGroup(get_transform());
+    vertical->set_childControlHeight(false);
+    vertical->set_childForceExpandHeight(false);
+    vertical->set_spacing(1);
+    auto verticalTransform = vertical->get_transform();
+
+    BeatSaberUI::CreateText(verticalTransform, "Generate Qubes")->set_alignment(514);
+
+    shapeInc = BeatSaberUI::CreateIncrementSetting(verticalTransform, getModConfig().GenShape.GetName(), 0, 1, getModConfig().GenShape.GetValue(), 0, (int) Shape::Count - 1, [](int value) {
+        getModConfig().GenShape.SetValue(value);
+        shapeInc->Text->SetText(shapeName((Shape) value));
+    });
+    shapeInc->Text->SetText(shapeName(configGenerator().shape));
+    AddConfigValueIncrementInt(verticalTransform, getModConfig().GenCount, 100, 100, 10000);
+    AddConfigValueIncrementInt(verticalTransform, getModConfig().GenSeed, 1, 0, 9999);
+    AddConfigValueIncrementFloat(verticalTransform, getModConfig().GenSpacing, 2, 0.05, 0.1, 2);
+
+    // with the default cube's settings, into the shown layout
+    BeatSaberUI::CreateUIButton(verticalTransform, "Generate", [this]() {
+        int made = generateCubes(configGenerator(), QubesConfigs[0]);
+        LOG_INFO("Generated %i qubes", made);
+        refresh();
+    });
+    BeatSaberUI::CreateUIButton(verticalTransform, "Run Stress Test", [this]() {
+        startStressTest();
+        refresh();
+    });
+    statusText = BeatSaberUI::CreateText(verticalTransform, "");
+    statusText->set_fontSize(3);
+    refresh();
+}
+
+void GeneratorSettings::refresh() {
+    std::string status = std::to_string(QubesConfigs[0].cubes.size()) + " qubes in " + activeLayout();
+    if(!stressStatus.empty())
+        status += "\n" + stressStatus;
+    statusText->SetText(status);
+}
+#pragma endregion
@@ -0,0 +1,90 @@
+#include "main.hpp"
+
+#include "UnityEngine/Application.hpp"
+#include "UnityEngine/Events/UnityAction.hpp"
+
+static GrabLatency latency;
+// cubes held this frame, with their delta time, moved in onBeforeRender
+static std::vector<std::pair<Cube*, float>> held;
+// controllers holding those cubes, each one is read again once
+static std::vector<GlobalNamespace::VRController*> holding;
+
+// when each controller last read its pose, there are only a few of them
+struct ControllerSample {
+    GlobalNamespace::VRController* controller;
+    uint64_t time;
+};
+static std::array<ControllerSample, 4> samples;
+
+// grabs moved this frame, their latency is measured right before rendering, the same point for both grab modes
+struct LatencySample {
+    GlobalNamespace::VRController* controller;
+    Math::Vec3 applied, target;
+    float deltaTime;
+};
+static std::vector<LatencySample> pending;
+
+void controllerSampled(GlobalNamespace::VRController* controller) {
+    uint64_t now = Qubes::Trace::now();
+    for(auto& sample : samples) {
+        if(sample.controller == controller || !sample.controller) {
+            sample = {controller, now};
+            return;
+        }
+    }
+}
+
+// seconds since the pose was read, until now
+static float poseAge(GlobalNamespace::VRController* controller, uint64_t now) {
+    for(auto& sample : samples) {
+        if(sample.controller == controller)
+            return (now - sample.time) / 1e9;
+    }
+    return 0;
+}
+
+void grabReleased() {
+    latency.reset();
+    Stats::grabLatencyMicros.store(0, std::memory_order_relaxed);
+}
+
+static void beforeRender() {
+    if(held.empty() && pending.empty())
+        return;
+    TRACE_ZONE("grab before render");
+    FRAME_TIMER();
+    // the game read these poses in Update, reading them again gets what was tracked since
+    for(auto controller : holding)
+        controller->Update();
+    for(auto [cube, deltaTime] : held)
+        cube->applyGrab(deltaTime);
+    held.clear();
+    holding.clear();
+    uint64_t now = Qubes::Trace::now();
+    for(auto& sample : pending)
+        latency.record(poseAge(sample.controller, now), sample.applied, sample.target, sample.deltaTime);
+    pending.clear();
+    Stats::grabLatencyMicros.store(latency.get() * 1e6, std::memory_order_relaxed);
+}
+
+static void registerBeforeRender() {
+    static bool registered = false;
+    if(registered)
+        return;
+    TRACK_ALLOC("onBeforeRender MakeDelegate", sizeof(UnityEngine::Events::UnityAction) + sizeof(std::function<void()>));
+    UnityEngine::Application::add_onBeforeRender(il2cpp_utils::MakeDelegate<UnityEngine::Events::UnityAction*>(classof(UnityEngine::Events::UnityAction*),
+        (std::function<void()>) beforeRender));
+    registered = true;
+}
+
+void recordGrabLatency(GlobalNamespace::VRController* controller, Math::Vec3 applied, Math::Vec3 target, float deltaTime) {
+    registerBeforeRender();
+    pending.push_back({controller, applied, target, deltaTime});
+}
+
+void holdUntilRender(Cube* cube, GlobalNamespace::VRController* controller, float deltaTime) {
+    registerBeforeRender();
+    held.emplace_back(cube, deltaTime);
+    if(std::find(holding.begin(), holding.end(), controller) == holding.end())
+        holding.push_back(controller);
+}
@@ -0,0 +1,108 @@
+#include "main.hpp"
+#include "core/history.hpp"
+
+using namespace Qubes;
+
+// only the shown layout's edits, switching layouts clears it
+static History history;
+
+void initHistory() {
+    setHistoryLimit();
+    QubesConfigs[0].history = &history;
+}
+
+void setHistoryLimit() {
+    history.setLimit((size_t) getModConfig().UndoMemory.GetValue() * 1024);
+}
+
+History const& layoutHistory() {
+    return history;
+}
+
+void clearHistory() {
+    history.clear();
+}
+
+#pragma region cubes
+void eraseCubes(std::vector<int> const& indices) {
+    TRACE_ZONE("eraseCubes");
+    for(int i : indices)
+        cubeArr[i]->destroy();
+    int kept = 0, next = 0;
+    for(int i = 0; i < cubeArr.size(); i++) {
+        if(next < indices.size() && indices[next] == i) {
+            next++;
+            continue;
+        }
+        cubeArr[kept] = cubeArr[i];
+        cubeArr[kept]->index = kept;
+        kept++;
+    }
+    cubeArr.resize(kept);
+    QubesConfigs[0].RemoveCubes(indices);
+    for(int i = indices.size() - 1; i >= 0; i--)
+        selectionErased(indices[i]);
+    markBroadphaseDirty();
+}
+
+void insertCubes(std::vector<int> const& indices, std::vector<CubeInfo> const& values) {
+    TRACE_ZONE("insertCubes");
+    // selected indices would have to move up, it's simpler to start over
+    clearSelection();
+    auto& config = QubesConfigs[0];
+    config.InsertCubes(indices, values);
+    std::vector<Cube*> merged;
+    merged.reserve(cubeArr.size() + indices.size());
+    int next = 0, old = 0;
+    for(int i = 0; i < cubeArr.size() + indices.size(); i++) {
+        if(next < indices.size() && indices[next] == i)
+            merged.push_back(makeCube(values[next++], config, i));
+        else {
+            merged.push_back(cubeArr[old++]);
+            merged.back()->index = i;
+        }
+    }
+    cubeArr = std::move(merged);
+    markBroadphaseDirty();
+}
+#pragma endregion
+
+#pragma region undo
+// applies op without recording it, then keeps its inverse on the other side
+static void step(bool undo) {
+    // frozen layouts can't be edited any other way either
+    if(!created || getModConfig().FreezeLayout.GetValue())
+        return;
+    auto op = undo ? history.takeUndo() : history.takeRedo();
+    if(!op)
+        return;
+    TRACE_ZONE("history step");
+    auto& config = QubesConfigs[0];
+    auto inverse = invertOp(*op, config.cubes);
+    config.history = nullptr;
+    if(op->kind == LayoutOp::Set) {
+        auto values = opValues(*op, config.cubes);
+        for(int i = 0; i < op->indices.size(); i++)
+            cubeArr[op->indices[i]]->setInfo(values[i]);
+        config.SetCubeValues(op->indices, values);
+    } else if(op->kind == LayoutOp::Insert)
+        insertCubes(op->indices, opValues(*op, config.cubes));
+    else
+        eraseCubes(op->indices);
+    config.history = &history;
+    if(undo)
+        history.pushRedo(std::move(inverse));
+    else
+        history.pushUndo(std::move(inverse));
+}
+
+void undoLayout() {
+    LOG_DEBUG("undo pressed");
+    step(true);
+}
+
+void redoLayout() {
+    LOG_DEBUG("redo pressed");
+    step(false);
+}
+#pragma endregion
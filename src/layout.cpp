@@ -0,0 +1,226 @@
+#include "main.hpp"
+#include "core/layoutindex.hpp"
+
+#include "GlobalNamespace/SimpleTextTableCell.hpp"
+#include "GlobalNamespace/SharedCoroutineStarter.hpp"
+#include "HMUI/Touchable.hpp"
+#include "UnityEngine/Camera.hpp"
+#include "UnityEngine/RectTransform.hpp"
+#include "UnityEngine/WaitForSeconds.hpp"
+#include "System/Collections/IEnumerator.hpp"
+#include "questui/shared/BeatSaberUI.hpp"
+#include "questui/shared/CustomTypes/Components/List/CustomListTableData.hpp"
+#include "custom-types/shared/coroutine.hpp"
+
+DEFINE_TYPE(Qubes, LayoutTableData);
+DEFINE_TYPE(Qubes, LayoutView);
+
+using namespace QuestUI;
+
+// the snapshot the rows are read from, held while the view is open
+static CubeSnapshot const* shown = nullptr;
+static LayoutIndex layoutIndex;
+static LayoutFilter filter;
+// cube indices of the rows
+static std::vector<int> rows;
+static int selected = -1;
+
+static const std::vector<std::string> lockedNames = { "Any", "Unlocked", "Locked" };
+
+static ConstString reuseIdentifier("QubesLayoutCell");
+
+#pragma region tableData
+static std::string rowText(int cube) {
+    auto& record = shown->cubes[cube];
+    char color[8];
+    snprintf(color, sizeof(color), "%02X%02X%02X", (int) (std::clamp(record.color[0], 0.0f, 1.0f) * 255),
+        (int) (std::clamp(record.color[1], 0.0f, 1.0f) * 255), (int) (std::clamp(record.color[2], 0.0f, 1.0f) * 255));
+    char text[160];
+    snprintf(text, sizeof(text), "<color=#%s>■</color> #%d %s, %s%s  (%.1f, %.1f, %.1f)", color, cube,
+        cubeTypes[std::clamp(record.type, 0, 2)].c_str(), hitActions.name(record.hitAction).c_str(), record.locked ? ", locked" : "",
+        record.pos[0], record.pos[1], record.pos[2]);
+    return text;
+}
+
+HMUI::TableCell* LayoutTableData::CellForIdx(HMUI::TableView* tableView, int idx) {
+    // the game's dropdown cell, only a text and a background
+    auto cell = (GlobalNamespace::SimpleTextTableCell*) tableView->DequeueReusableCellForIdentifier(reuseIdentifier);
+    if(!cell) {
+        static GlobalNamespace::SimpleTextTableCell* prefab = nullptr;
+        if(!prefab)
+            prefab = UnityEngine::Resources::FindObjectsOfTypeAll<GlobalNamespace::SimpleTextTableCell*>()[0];
+        cell = UnityEngine::Object::Instantiate(prefab);
+        cell->set_reuseIdentifier(reuseIdentifier);
+    }
+    cell->set_text(rowText(rows[idx]));
+    return cell;
+}
+
+float LayoutTableData::CellSize() {
+    return 6;
+}
+
+int LayoutTableData::NumberOfCells() {
+    return rows.size();
+}
+#pragma endregion
+
+#pragma region layoutView
+// only one cube flashes at a time, a newer flash takes over
+static int flashGeneration = 0;
+static Cube* flashCube = nullptr;
+static bool flashWasActive = false;
+
+// flashes the selection tint, which isn't saved, so edits and saves during it keep the real color
+custom_types::Helpers::Coroutine highlightCoroutine(int cubeIndex) {
+    Stats::Scoped running(Stats::coroutines);
+    auto cube = cubeArr[cubeIndex];
+    // flashing the same cube again keeps whether it was shown before the first flash
+    bool wasActive = cube == flashCube ? flashWasActive : cube->get_gameObject()->get_activeSelf();
+    int generation = ++flashGeneration;
+    flashCube = cube;
+    flashWasActive = wasActive;
+    cube->setFlashing(true);
+    cube->setActive(true);
+    for(int i = 0; ; i++) {
+        // deleted, or parked by a layout switch, which clears the tint itself
+        if(std::find(cubeArr.begin(), cubeArr.end(), cube) == cubeArr.end()) {
+            if(generation == flashGeneration)
+                flashCube = nullptr;
+            co_return;
+        }
+        bool replaced = generation != flashGeneration;
+        if(replaced || i == 12) {
+            // put back unless a newer flash of the same cube will
+            if(!replaced || flashCube != cube) {
+                cube->setHighlighted(isSelected(cube->index));
+                cube->setFlashing(false);
+                cube->setActive(wasActive);
+            }
+            if(!replaced)
+                flashCube = nullptr;
+            co_return;
+        }
+        bool selected = isSelected(cube->index);
+        cube->setHighlighted(i % 2 == 0 ? !selected : selected);
+        TRACK_ALLOC("highlightCoroutine WaitForSeconds", sizeof(UnityEngine::WaitForSeconds));
+        co_yield (System::Collections::IEnumerator*) UnityEngine::WaitForSeconds::New_ctor(0.25);
+    }
+}
+
+// increment settings show the value as a name, and -1 as any
+static void showName(IncrementSetting* inc, std::string const& name) {
+    inc->Text->SetText(inc->CurrentValue < 0 ? "Any" : name);
+}
+
+void LayoutView::DidActivate(bool firstActivation, bool addedToHierarchy, bool screenSystemEnabling) {
+    if(!firstActivation) {
+        refresh();
+        return;
+    }
+    get_gameObject()->AddComponent<HMUI::Touchable*>();
+    auto horizontal = BeatSaberUI::CreateHorizontalLayoutGroup(get_transform());
+    horizontal->set_spacing(2);
+    auto horizontalTransform = horizontal->get_transform();
+
+    list = BeatSaberUI::CreateScrollableList(horizontalTransform, {80, 60}, [](int idx) {
+        selected = rows[idx];
+    });
+    // the list's own data would need a row object for every cube, this makes rows from the index as they're shown
+    data = list->get_gameObject()->AddComponent<LayoutTableData*>();
+    list->tableView->SetDataSource(reinterpret_cast<HMUI::TableView::IDataSource*>(data), false);
+
+    auto vertical = BeatSaberUI::CreateVerticalLayoutGroup(horizontalTransform);
+    vertical->set_childControlHeight(false);
+    vertical->set_childForceExpandHeight(false);
+    auto verticalTransform = vertical->get_transform();
+
+    countText = BeatSaberUI::CreateText(verticalTransform, "");
+    typeInc = BeatSaberUI::CreateIncrementSetting(verticalTransform, "Type", 0, 1, filter.type, -1, cubeTypes.size() - 1, [this](int value) {
+        filter.type = value;
+        showName(typeInc, value < 0 ? "" : cubeTypes[value]);
+        refresh();
+    });
+    showName(typeInc, filter.type < 0 ? "" : cubeTypes[filter.type]);
+    // steps through the table's order, the filter is by id
+    actionInc = BeatSaberUI::CreateIncrementSetting(verticalTransform, "Hit Action", 0, 1, filter.hitAction < 0 ? -1 : hitActions.index(filter.hitAction), -1, hitActions.size() - 1, [this](int value) {
+        filter.hitAction = hitActions.id(value);
+        showName(actionInc, value < 0 ? "" : hitActions.name(filter.hitAction));
+        refresh();
+    });
+    showName(actionInc, filter.hitAction < 0 ? "" : hitActions.name(filter.hitAction));
+    lockedInc = BeatSaberUI::CreateIncrementSetting(verticalTransform, "Locked", 0, 1, filter.locked + 1, 0, 2, [this](int value) {
+        filter.locked = value - 1;
+        lockedInc->Text->SetText(lockedNames[value]);
+        refresh();
+    });
+    lockedInc->Text->SetText(lockedNames[filter.locked + 1]);
+    hueMinInc = BeatSaberUI::CreateIncrementSetting(verticalTransform, "Hue From", 0, 15, filter.hueMin, 0, 360, [this](float value) {
+        filter.hueMin = value;
+        refresh();
+    });
+    hueMaxInc = BeatSaberUI::CreateIncrementSetting(verticalTransform, "Hue To", 0, 15, filter.hueMax, 0, 360, [this](float value) {
+        filter.hueMax = value;
+        refresh();
+    });
+    distanceInc = BeatSaberUI::CreateIncrementSetting(verticalTransform, "Max Distance", 0, 1, filter.maxDistance, 0, 50, [this](float value) {
+        filter.maxDistance = value;
+        refresh();
+    });
+
+    BeatSaberUI::CreateUIButton(verticalTransform, "Jump To", [this]() {
+        int cube = selectedCube();
+        if(cube < 0)
+            return;
+        // opens its edit menu, which shows up next to it
+        cubeArr[cube]->setActive(true);
+        cubeArr[cube]->setMenuActive(true);
+    });
+    BeatSaberUI::CreateUIButton(verticalTransform, "Highlight", [this]() {
+        int cube = selectedCube();
+        if(cube < 0)
+            return;
+        GlobalNamespace::SharedCoroutineStarter::get_instance()->StartCoroutine(custom_types::Helpers::CoroutineHelper::New(highlightCoroutine(cube)));
+    });
+    refresh();
+}
+
+void LayoutView::DidDeactivate(bool removedFromHierarchy, bool screenSystemDisabling) {
+    if(shown)
+        SnapshotPublisher::release(shown);
+    shown = nullptr;
+    rows.clear();
+    list->tableView->ReloadData();
+}
+
+void LayoutView::refresh() {
+    TRACE_ZONE("LayoutView::refresh");
+    auto latest = QubesConfigs[0].snapshots->acquire();
+    if(shown)
+        SnapshotPublisher::release(shown);
+    shown = latest;
+    layoutIndex.build(*shown);
+
+    auto camera = UnityEngine::Camera::get_main();
+    if(camera)
+        filter.from = camera->get_transform()->get_position();
+    layoutIndex.query(filter, rows);
+    selected = -1;
+    countText->SetText(std::to_string(rows.size()) + " of " + std::to_string(shown->count) + " qubes");
+    list->tableView->ReloadData();
+}
+
+int LayoutView::selectedCube() {
+    if(selected < 0 || !shown)
+        return -1;
+    // rows are indices into the shown snapshot, any save since may have added or removed cubes before them
+    auto latest = QubesConfigs[0].snapshots->acquire();
+    bool changed = latest->version != shown->version;
+    SnapshotPublisher::release(latest);
+    if(changed) {
+        refresh();
+        return -1;
+    }
+    return selected < (int) cubeArr.size() ? selected : -1;
+}
+#pragma endregion
@@ -0,0 +1,325 @@
+#include "main.hpp"
+#include "core/layouts.hpp"
+
+#include "questui/shared/BeatSaberUI.hpp"
+#include "questui/shared/CustomTypes/Components/Settings/IncrementSetting.hpp"
+#include "HMUI/Touchable.hpp"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+
+DEFINE_TYPE(Qubes, LayoutSettings);
+
+using namespace QuestUI;
+
+// only the shown layout is in memory, and the one likely needed next is being read
+static LayoutBindings bindings;
+static LayoutLoader* loader = nullptr;
+static std::string activeName = DefaultLayout;
+static std::atomic<bool> showingDefault = true;
+static std::unique_ptr<LayoutFile> activeFile;
+// the config's own storage, for the default layout
+static ConfigStorage* defaultStorage = nullptr;
+// for binding and prefetching, as selected in the level list
+static std::string selectedSong, selectedPlaylist;
+
+// cubes left over from switching to a smaller layout, hidden until a bigger one needs them
+static std::vector<Cube*> pool;
+constexpr int MaxPooled = 256;
+
+#pragma region switching
+void loadLayouts() {
+    auto& config = QubesConfigs[0];
+    defaultStorage = config.storage;
+    std::string folder = getDataDir(modInfo) + "layouts/";
+    mkdir(folder.c_str(), 0777);
+    loader = new LayoutLoader(folder);
+    auto& doc = defaultStorage->GetDocument();
+    auto member = doc.FindMember("layouts");
+    if(member != doc.MemberEnd())
+        bindings.Load(member->value);
+    // the menu one is needed as soon as the cubes are made
+    loader->prefetch(bindings.menu);
+}
+
+static void saveBindings() {
+    auto& doc = defaultStorage->GetDocument();
+    auto& allocator = doc.GetAllocator();
+    auto value = bindings.ToJSON(allocator);
+    auto member = doc.FindMember("layouts");
+    if(member != doc.MemberEnd())
+        member->value = value;
+    else
+        doc.AddMember("layouts", value, allocator);
+    defaultStorage->Write();
+}
+
+std::string const& activeLayout() {
+    return activeName;
+}
+
+bool defaultLayoutShown() {
+    return showingDefault.load(std::memory_order_acquire);
+}
+
+ConfigStorage* defaultLayoutStorage() {
+    return defaultStorage;
+}
+
+std::vector<std::string> listLayouts() {
+    std::vector<std::string> names;
+    if(DIR* dir = opendir(loader->getFolder().c_str())) {
+        while(auto entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if(name.size() > 5 && name.ends_with(".json")) {
+                name.resize(name.size() - 5);
+                if(validLayoutName(name))
+                    names.push_back(name);
+            }
+        }
+        closedir(dir);
+    }
+    std::sort(names.begin(), names.end());
+    names.insert(names.begin(), DefaultLayout);
+    return names;
+}
+
+std::string const& layoutFolder() {
+    return loader->getFolder();
+}
+
+bool createLayout(std::string const& name) {
+    if(!validLayoutName(name))
+        return false;
+    auto path = layoutPath(loader->getFolder(), name);
+    if(FILE* existing = fopen(path.c_str(), "r")) {
+        fclose(existing);
+        return false;
+    }
+    // an empty layout, filled by switching to it and making cubes
+    LayoutFile file(path);
+    file.GetDocument().AddMember("qubes", rapidjson::Value(rapidjson::kArrayType), file.GetDocument().GetAllocator());
+    file.Write();
+    return true;
+}
+
+void deleteLayout(std::string const& name) {
+    if(name == DefaultLayout)
+        return;
+    if(name == activeName)
+        switchLayout(DefaultLayout);
+    loader->forget(name);
+    remove(layoutPath(loader->getFolder(), name).c_str());
+    bindings.unbind(name);
+    saveBindings();
+}
+
+static void parkCube(Cube* cube) {
+    removeCubeAnimation(cube);
+    stopCubePhysics(cube);
+    if(cube->hasMenu())
+        cube->setMenuActive(false);
+    // held ones would still be moved and saved by their controller
+    if(pool.size() >= MaxPooled || cube->isHeld()) {
+        cube->destroy();
+        return;
+    }
+    cube->pooled = true;
+    cube->setActive(false);
+    pool.push_back(cube);
+}
+
+static Cube* unparkCube(CubeInfo const& info, int index) {
+    if(pool.empty())
+        return makeCube(info, QubesConfigs[0], index);
+    auto cube = pool.back();
+    pool.pop_back();
+    cube->pooled = false;
+    cube->index = index;
+    // parked with the broadphase's collider state, the next rebuild turns it off again if it's in use
+    cube->setColliderEnabled(true);
+    // the selection was cleared with the layout, but a flash from the layout browser could have left the tint
+    cube->setHighlighted(false);
+    cube->setFlashing(false);
+    cube->setInfo(info);
+    cube->setActive(inGameplay ? getModConfig().ShowInLevel.GetValue() : getModConfig().ShowInMenu.GetValue());
+    return cube;
+}
+
+void applyLayout(std::vector<CubeInfo> cubes, LayoutDiff const& diff) {
+    TRACE_ZONE("applyLayout");
+    auto& config = QubesConfigs[0];
+    // indices are about to mean other cubes
+    clearSelection();
+    clearHistory();
+    // parked first, so that the new ones can take them
+    for(int i : diff.removed)
+        parkCube(cubeArr[i]);
+    std::vector<Cube*> updated(cubes.size());
+    for(int i = 0; i < cubes.size(); i++) {
+        if(diff.source[i] >= 0) {
+            updated[i] = cubeArr[diff.source[i]];
+            updated[i]->index = i;
+        } else
+            updated[i] = unparkCube(cubes[i], i);
+    }
+    for(int i : diff.changed) {
+        if(diff.source[i] >= 0)
+            updated[i]->setInfo(cubes[i]);
+    }
+    cubeArr = std::move(updated);
+    config.cubes = std::move(cubes);
+    config.snapshots->publish(config.cubes);
+    markBroadphaseDirty();
+}
+
+bool switchLayout(std::string const& name) {
+    if(name == activeName)
+        return true;
+    TRACE_ZONE("switchLayout");
+    std::vector<CubeInfo> cubes;
+    std::unique_ptr<LayoutFile> file;
+    if(name == DefaultLayout) {
+        for(auto& cube : defaultStorage->GetDocument()["qubes"].GetArray())
+            cubes.emplace_back(cube);
+    } else {
+        auto loaded = loader->take(name);
+        if(!loaded.error.empty()) {
+            LOG_WARNING("Couldn't load layout %s (%s), keeping %s", name.c_str(), loaded.error.c_str(), activeName.c_str());
+            return false;
+        }
+        cubes = std::move(loaded.cubes);
+        file = std::move(loaded.file);
+    }
+    LOG_INFO("Switching layout from %s to %s", activeName.c_str(), name.c_str());
+    auto& config = QubesConfigs[0];
+    // cubes keep pointing at the same config, only where it saves to changes
+    config.storage = file ? file.get() : defaultStorage;
+    activeFile = std::move(file);
+    activeName = name;
+    showingDefault.store(name == DefaultLayout, std::memory_order_release);
+    if(created) {
+        auto diff = diffLayouts(config.cubes, cubes);
+        applyLayout(std::move(cubes), diff);
+    } else {
+        clearHistory();
+        config.cubes = std::move(cubes);
+        config.snapshots->publish(config.cubes);
+    }
+    return true;
+}
+
+void switchBoundLayout() {
+    switchLayout(bindings.resolve(inGameplay, selectedSong, selectedPlaylist));
+    // the way back to the menu is the next switch from a level
+    if(inGameplay && bindings.menu != activeName)
+        loader->prefetch(bindings.menu);
+}
+
+static void prefetchSelected() {
+    auto& next = bindings.resolve(true, selectedSong, selectedPlaylist);
+    if(next != activeName)
+        loader->prefetch(next);
+}
+
+void songSelected(std::string const& levelId) {
+    selectedSong = levelId;
+    prefetchSelected();
+}
+
+void playlistSelected(std::string const& name) {
+    selectedPlaylist = name;
+    prefetchSelected();
+}
+#pragma endregion
+
+#pragma region layoutSettings
+static std::vector<std::string> layoutNames;
+static int shownLayout = 0;
+static std::string newLayoutName;
+
+// after the list of files changed, keeps the shown one if it's still there
+static void relist(IncrementSetting* inc, std::string const& show) {
+    layoutNames = listLayouts();
+    auto found = std::find(layoutNames.begin(), layoutNames.end(), show);
+    shownLayout = found == layoutNames.end() ? 0 : found - layoutNames.begin();
+    inc->MaxValue = layoutNames.size() - 1;
+    inc->CurrentValue = shownLayout;
+}
+
+void LayoutSettings::DidActivate(bool firstActivation, bool addedToHierarchy, bool screenSystemEnabling) {
+    if(!firstActivation) {
+        relist(layoutInc, activeName);
+        refresh();
+        return;
+    }
+    layoutNames = listLayouts();
+    shownLayout = std::find(layoutNames.begin(), layoutNames.end(), activeName) - layoutNames.begin();
+
+    get_gameObject()->AddComponent<HMUI::Touchable*>();
+    auto vertical = BeatSaberUI::CreateVerticalLayoutGroup(get_transform());
+    vertical->set_childControlHeight(false);
+    vertical->set_childForceExpandHeight(false);
+    vertical->set_spacing(1);
+    auto verticalTransform = vertical->get_transform();
+
+    BeatSaberUI::CreateText(verticalTransform, "Layouts")->set_alignment(514);
+    statusText = BeatSaberUI::CreateText(verticalTransform, "");
+    statusText->set_fontSize(3);
+
+    layoutInc = BeatSaberUI::CreateIncrementSetting(verticalTransform, "Layout", 0, 1, shownLayout, 0, layoutNames.size() - 1, [this](int value) {
+        shownLayout = value;
+        refresh();
+    });
+    // edits go to whichever layout is shown
+    BeatSaberUI::CreateUIButton(verticalTransform, "Show And Edit", [this]() {
+        switchLayout(layoutNames[shownLayout]);
+        refresh();
+    });
+
+    auto bindRow = BeatSaberUI::CreateHorizontalLayoutGroup(verticalTransform)->get_transform();
+    auto bindButton = [this, bindRow](std::string text, LayoutContext context) {
+        BeatSaberUI::CreateUIButton(bindRow, text, [this, context]() {
+            auto& key = context == LayoutContext::Song ? selectedSong : selectedPlaylist;
+            bindings.bind(context, key, layoutNames[shownLayout]);
+            saveBindings();
+            refresh();
+        });
+    };
+    bindButton("Menu", LayoutContext::Menu);
+    bindButton("Levels", LayoutContext::Gameplay);
+    bindButton("Song", LayoutContext::Song);
+    bindButton("Playlist", LayoutContext::Playlist);
+
+    auto createRow = BeatSaberUI::CreateHorizontalLayoutGroup(verticalTransform)->get_transform();
+    BeatSaberUI::CreateStringSetting(createRow, "New Layout", "", [](StringW value) {
+        newLayoutName = value;
+    });
+    BeatSaberUI::CreateUIButton(createRow, "Create", [this]() {
+        if(!createLayout(newLayoutName))
+            return;
+        relist(layoutInc, newLayoutName);
+        refresh();
+    });
+    BeatSaberUI::CreateUIButton(verticalTransform, "Delete Layout", [this]() {
+        deleteLayout(layoutNames[shownLayout]);
+        relist(layoutInc, DefaultLayout);
+        refresh();
+    });
+    refresh();
+}
+
+void LayoutSettings::refresh() {
+    auto& name = layoutNames[shownLayout];
+    layoutInc->Text->SetText(name);
+    std::string status = "Showing: " + activeName + "\nMenu: " + bindings.menu + ", Levels: " + bindings.gameplay;
+    if(!selectedSong.empty())
+        status += "\nSelected song: " + bindings.resolve(true, selectedSong, "");
+    if(!selectedPlaylist.empty())
+        status += "\nSelected playlist (" + selectedPlaylist + "): " + bindings.resolve(true, "", selectedPlaylist);
+    statusText->SetText(status);
+}
+#pragma endregion
@@ -0,0 +1,60 @@
+#include "main.hpp"
+
+#include "core/ringbuffer.hpp"
+
+#include <chrono>
+#include <cstdarg>
+#include <thread>
+
+using namespace Qubes;
+
+struct LogEntry {
+    Log::Level level;
+    char message[251];
+};
+
+static RingBuffer<LogEntry, 256> queue;
+
+void Log::push(Level level, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    // only formats into the slot, the actual logging happens on the writer thread
+    queue.tryPush([level, format, &args](LogEntry& entry) {
+        entry.level = level;
+        vsnprintf(entry.message, sizeof(entry.message), format, args);
+    });
+    va_end(args);
+}
+
+static void write(LogEntry& entry) {
+    switch(entry.level) {
+        case Log::Level::Debug:
+            getLogger().debug("%s", entry.message);
+            break;
+        case Log::Level::Info:
+            getLogger().info("%s", entry.message);
+            break;
+        case Log::Level::Warning:
+            getLogger().warning("%s", entry.message);
+            break;
+        case Log::Level::Error:
+            getLogger().error("%s", entry.message);
+            break;
+    }
+}
+
+void Log::startWriter() {
+    static bool started = false;
+    if(started)
+        return;
+    started = true;
+    std::thread([]() {
+        while(true) {
+            while(queue.tryPop(write));
+            if(size_t dropped = queue.takeDropped())
+                getLogger().warning("%zu log messages were dropped", dropped);
+            // nothing waits on this thread, so polling is fine
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }).detach();
+}
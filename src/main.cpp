@@ -11,9 +11,16 @@
 #include "GlobalNamespace/GameplayCoreInstaller.hpp"
 #include "GlobalNamespace/NoteDebrisPoolInstaller.hpp"
 #include "GlobalNamespace/NoteDebris.hpp"
+#include "GlobalNamespace/Saber.hpp"
+#include "GlobalNamespace/LevelCollectionViewController.hpp"
+#include "GlobalNamespace/LevelCollectionTableView.hpp"
+#include "GlobalNamespace/IPreviewBeatmapLevel.hpp"
+#include "GlobalNamespace/AnnotatedBeatmapLevelCollectionsViewController.hpp"
+#include "GlobalNamespace/IAnnotatedBeatmapLevelCollection.hpp"
 
 #include "UnityEngine/Physics.hpp"
 #include "UnityEngine/Collider.hpp"
+#include "UnityEngine/Renderer.hpp"
 #include "UnityEngine/Random.hpp"
 #include "UnityEngine/MaterialPropertyBlock.hpp"
 #include "GlobalNamespace/PauseController.hpp"
@@ -24,6 +31,13 @@
 #include "GlobalNamespace/NoteDebrisPhysics.hpp"
 #include "GlobalNamespace/MaterialPropertyBlockController.hpp"
 
+#include "core/cut.hpp"
+#include "core/cubeindex.hpp"
+#include "core/stats.hpp"
+#include "overlay.hpp"
+
+#include <ctime>
+
 using namespace GlobalNamespace;
 
 ModInfo modInfo;
@@ -31,6 +45,7 @@ DEFINE_CONFIG(ModConfig);
 
 std::vector<Cube*> cubeArr;
 NoteDebris* debrisPrefab;
+NoteDebris* debrisPrefabLight;
 UnityEngine::Color lastColor;
 VRUIControls::VRPointer* pointer;
 HapticFeedbackController* haptics;
@@ -48,6 +63,7 @@ std::vector<QubesConfig> QubesConfigs = {
 
 UnityEngine::GameObject* gameNote;
 DefaultCube* defaultCube;
+CubeParts cubeParts;
 const std::vector<OVRInput::Button> buttons = {
     OVRInput::Button::PrimaryHandTrigger,
     OVRInput::Button::One,
@@ -79,6 +95,31 @@ void logHierarchy() {
     }
 }
 
+// strip and set up the copied note once, so that making a cube is only a clone
+void bakePrototype(UnityEngine::GameObject* prototype) {
+    static ConstString bigCuttableName("BigCuttable");
+    static ConstString smallCuttableName("SmallCuttable");
+    static ConstString arrowName("NoteArrow");
+    static ConstString arrowGlowName("NoteArrowGlow");
+    static ConstString circleGlowName("NoteCircleGlow");
+    auto t = prototype->get_transform();
+    // immediate so that the sibling indices below are already correct
+    UnityEngine::Object::DestroyImmediate(t->Find(bigCuttableName)->get_gameObject());
+
+    // the prototype is inactive, so inactive children have to be included
+    auto renderers = prototype->GetComponentsInChildren<UnityEngine::Renderer*>(true);
+    for(int i = 0; i < renderers.Length(); i++) {
+        renderers[i]->set_enabled(true);
+    }
+    auto cuttable = t->Find(smallCuttableName);
+    cuttable->GetComponent<BoxCuttableBySaber*>()->set_colliderSize({0.5, 0.5, 0.5});
+
+    cubeParts.arrow = t->Find(arrowName)->GetSiblingIndex();
+    cubeParts.arrowGlow = t->Find(arrowGlowName)->GetSiblingIndex();
+    cubeParts.circleGlow = t->Find(circleGlowName)->GetSiblingIndex();
+    cubeParts.cuttable = cuttable->GetSiblingIndex();
+}
+
 // make cubes
 Cube* makeCube(CubeInfo info, QubesConfig& cfg, int index) {
     auto ob = UnityEngine::Object::Instantiate(gameNote, info.pos, info.rot);
@@ -87,6 +128,8 @@ Cube* makeCube(CubeInfo info, QubesConfig& cfg, int index) {
     // needs to be set active before init
     ob->set_active(true);
     cube->init(info.color, info.type, info.hitAction, info.size, info.locked, cfg, index);
+    if(info.animation.motion != Motion::None)
+        setCubeAnimation(cube, info.animation);
     return cube;
 }
 DefaultCube* makeDefaultCube(CubeInfo info, QubesConfig& cfg, int index) {
@@ -99,15 +142,31 @@ DefaultCube* makeDefaultCube(CubeInfo info, QubesConfig& cfg, int index) {
     return cube;
 }
 
+// start or stop writing traces to match the config
+void updateTracing() {
+    if(getModConfig().Tracing.GetValue()) {
+        if(!Qubes::Trace::running()) {
+            std::string path = getDataDir(modInfo) + "trace_" + std::to_string(std::time(nullptr)) + ".json";
+            if(Qubes::Trace::start(path))
+                LOG_INFO("Writing trace to %s", path.c_str());
+        }
+    } else
+        Qubes::Trace::stop();
+}
+
 // Hooks
 MAKE_HOOK_MATCH(SceneChanged, &UnityEngine::SceneManagement::SceneManager::Internal_ActiveSceneChanged, void, UnityEngine::SceneManagement::Scene prevScene, UnityEngine::SceneManagement::Scene nextScene) {
     SceneChanged(prevScene, nextScene);
+    // keep recordings split by scene, also saves when recording was turned off
+    saveRecording();
+    updateTracing();
     // names = MainMenu, GameCore (QuestInit, EmptyTransition, HealthWarning, ShaderWarmup)
     if(nextScene && nextScene.IsValid() && nextScene.get_name() == "ShaderWarmup") {
         // fix a few soft restart bugs
         pointer = nullptr;
         if(!created) {
-            getLogger().info("Creating cubes");
+            TRACE_ZONE("create cubes");
+            LOG_INFO("Creating cubes");
             static ConstString normalNoteName("NormalGameNote");
             static ConstString cubeName("NoteCube");
             // scene where the cube transform model is available
@@ -116,8 +175,10 @@ MAKE_HOOK_MATCH(SceneChanged, &UnityEngine::SceneManagement::SceneManager::Inter
             gameNote = UnityEngine::Object::Instantiate(transform)->get_gameObject();
             UnityEngine::Object::DontDestroyOnLoad(gameNote);
             gameNote->set_active(false);
+            bakePrototype(gameNote);
 
-            // cubes config loaded in the config init
+            // cubes config loaded in the config init, or the menu's layout if it has its own
+            switchBoundLayout();
             for(auto info : QubesConfigs[0].cubes)
                 cubeArr.push_back(makeCube(info, QubesConfigs[0], cubeArr.size()));
 
@@ -129,6 +190,9 @@ MAKE_HOOK_MATCH(SceneChanged, &UnityEngine::SceneManagement::SceneManager::Inter
     }
     if(nextScene && nextScene.get_name() == "MainMenu") {
         inMenu = true;
+        inGameplay = false;
+        // before they're shown, cubes taken from the pool are shown to match
+        switchBoundLayout();
         // get pointer every time, since it changes in pause
         pointer = UnityEngine::Resources::FindObjectsOfTypeAll<VRUIControls::VRPointer*>()[0];
         
@@ -142,6 +206,9 @@ MAKE_HOOK_MATCH(SceneChanged, &UnityEngine::SceneManagement::SceneManager::Inter
 
     if(nextScene && nextScene.get_name() == "GameCore") {
         inGameplay = true;
+        // the selection is only for editing in the menu
+        clearSelection();
+        switchBoundLayout();
         // activate or deactivate all cubes based on ShowInLevel
         auto active = getModConfig().ShowInLevel.GetValue();
         for(auto cube : cubeArr) {
@@ -153,12 +220,15 @@ MAKE_HOOK_MATCH(SceneChanged, &UnityEngine::SceneManagement::SceneManager::Inter
         // only need to get the addresses once
         if(!haptics)
             haptics = UnityEngine::Resources::FindObjectsOfTypeAll<HapticFeedbackController*>()[0];
-        if(!debrisPrefab)
-            debrisPrefab = UnityEngine::Resources::FindObjectsOfTypeAll<NoteDebrisPoolInstaller*>()[0]->normalNoteDebrisHDPrefab;
+        if(!debrisPrefab) {
+            auto installer = UnityEngine::Resources::FindObjectsOfTypeAll<NoteDebrisPoolInstaller*>()[0];
+            debrisPrefab = installer->normalNoteDebrisHDPrefab;
+            debrisPrefabLight = installer->normalNoteDebrisLWPrefab;
+        }
     } else inGameplay = false;
+    updateBroadphase();
 }
 
-#define toVector3(vector4) UnityEngine::Vector3(vector4.x, vector4.y, vector4.z)
 #define toVector4(vector3) UnityEngine::Vector4(vector3.x, vector3.y, vector3.z, 0)
 MAKE_HOOK_MATCH(DebrisInit, &NoteDebris::Init, void, NoteDebris* self, ColorType colorType, UnityEngine::Vector3 notePos, UnityEngine::Quaternion noteRot, UnityEngine::Vector3 noteMoveVec, UnityEngine::Vector3 noteScale, UnityEngine::Vector3 positionOffset, UnityEngine::Quaternion rotationOffset, UnityEngine::Vector3 cutPoint, UnityEngine::Vector3 cutNormal, UnityEngine::Vector3 force, UnityEngine::Vector3 torque, float lifeTime) {
     // leave it normal if the debris is not from a cube
@@ -166,31 +236,17 @@ MAKE_HOOK_MATCH(DebrisInit, &NoteDebris::Init, void, NoteDebris* self, ColorType
         DebrisInit(self, colorType, notePos, noteRot, noteMoveVec, noteScale, positionOffset, rotationOffset, cutPoint, cutNormal, force, torque, lifeTime); // I have no idea why this doesn't work
         return;
     }
+    TRACE_ZONE("DebrisInit");
     // don't call what we're hooking to avoid custom debris
-    UnityEngine::Quaternion quaternion = UnityEngine::Quaternion::Inverse(noteRot);
-    UnityEngine::Vector3 vector = quaternion * (cutPoint - notePos);
-    UnityEngine::Vector3 vector2 = quaternion * cutNormal;
-    float sqrMagnitude = vector.get_sqrMagnitude();
-    if (sqrMagnitude > self->maxCutPointCenterDistance * self->maxCutPointCenterDistance)
-        vector = self->maxCutPointCenterDistance * vector / sqrt(sqrMagnitude);
-    UnityEngine::Vector4 vector3 = {vector2.x, vector2.y, vector2.z, 0};
-    vector3.w = 0 - UnityEngine::Vector3::Dot(vector2, vector);
-    float num = sqrt(UnityEngine::Vector4::Dot(vector3, vector3));
-    UnityEngine::Vector3 zero = UnityEngine::Vector3::get_zero();
-    int num2 = self->_get__meshVertices().Length();
-    for (int i = 0; i < num2; i++) {
-        UnityEngine::Vector3 vector4 = self->_get__meshVertices()[i];
-        float num3 = UnityEngine::Vector3::Dot(toVector3(vector3), vector4) + vector3.w;
-        if (num3 < 0) {
-            float num4 = num3 / num;
-            UnityEngine::Vector3 vector5 = vector4 - toVector3(vector3) * num4;
-            zero = zero + vector5 / num2;
-        } else
-            zero = zero + vector4 / num2;
-    }
-    UnityEngine::Quaternion quaternion2 = rotationOffset * noteRot;
+    auto plane = localCutPlane(notePos, noteRot, cutPoint, cutNormal, self->maxCutPointCenterDistance);
+    UnityEngine::Vector4 vector3 = {plane.normal.x, plane.normal.y, plane.normal.z, plane.offset};
+    auto vertices = self->_get__meshVertices();
+    Math::Vec3 zero = Math::Vec3::zero();
+    if(vertices.Length() > 0)
+        zero = debrisCenter(reinterpret_cast<Math::Vec3 const*>(&vertices[0]), vertices.Length(), plane);
+    Math::Quat quaternion2 = Math::Quat(rotationOffset) * Math::Quat(noteRot);
     UnityEngine::Transform* obj = self->get_transform();
-    obj->SetPositionAndRotation(rotationOffset * notePos + positionOffset + quaternion2 * zero, quaternion2);
+    obj->SetPositionAndRotation(Math::Quat(rotationOffset) * Math::Vec3(notePos) + Math::Vec3(positionOffset) + quaternion2 * zero, quaternion2);
     obj->set_localScale(noteScale);
     self->meshTransform->set_localPosition(-zero);
     self->physics->Init(force, torque);
@@ -213,41 +269,51 @@ MAKE_HOOK_MATCH(DebrisInit, &NoteDebris::Init, void, NoteDebris* self, ColorType
 // just an object that is guaranteed active
 MAKE_HOOK_MATCH(AnUpdate, &HMMainThreadDispatcher::Update, void, HMMainThreadDispatcher* self) {
     AnUpdate(self);
+    Qubes::Stats::endFrame();
+    TRACE_ZONE("AnUpdate");
+    // covers the updates below too, they only have trace zones of their own
+    FRAME_TIMER();
+    profileAllocations();
+    updateQuality();
+    updateStaticBatches();
+    updateAnimations();
+    updatePhysics();
+    applyConfigReload();
+    updateStressTest();
+    // only once a scene with ui is loaded
+    if((inMenu || inGameplay) && getModConfig().ShowOverlay.GetValue() != Qubes::Stats::timing.load(std::memory_order_relaxed))
+        Qubes::setOverlayActive(getModConfig().ShowOverlay.GetValue());
+    if(pointer && getModConfig().RecordInput.GetValue())
+        recordInput(buttons);
     // don't listen for buttons in gameplay
     if(!pointer || (!inMenu))
         return;
+    if(getModConfig().BtnEdit.GetValue() < buttons.size())
+        updateSelection(buttons[getModConfig().BtnEdit.GetValue()]);
     int i = 0; // keep track of index
     for(auto button : buttons) {
         bool lbut = OVRInput::GetDown(button, OVRInput::Controller::LTouch);
         bool rbut = OVRInput::GetDown(button, OVRInput::Controller::RTouch);
         bool isRight = pointer->_get__lastControllerUsedWasRight();
         if((lbut && !isRight) || (rbut && isRight)) {
-            // check button with configured buttons and controller with configured controllers for all three
+            // check button with configured buttons and controller with configured controllers for each action
             if(i == getModConfig().BtnDel.GetValue() && (getModConfig().CtrlDel.GetValue() == 2 || getModConfig().CtrlDel.GetValue() == (isRight? 1 : 0))) {
-                getLogger().info("delete pressed");
-                // only delete one cube
-                bool deleted = false;
+                LOG_DEBUG("delete pressed");
                 // physics raycast allows interaction through ui elements
                 UnityEngine::RaycastHit hit;
                 if(UnityEngine::Physics::Raycast(pointer->get_vrController()->get_position(), pointer->get_vrController()->get_forward(), hit, 100)) {
                     // iterate through cubes to find the one to be deleted
                     auto hitTransform = hit.get_collider()->get_transform();
-                    for(auto iter = cubeArr.begin(); iter != cubeArr.end(); ++iter) {
-                        if(!deleted && (*iter)->deletePressed(hitTransform)) {
-                            // destroyed and removed from config in deletePressed
-                            cubeArr.erase(iter);
-                            deleted = true;
-                            // subtract one from the iterator since we removed one from the array
-                            --iter;
-                        } else if(deleted) {
-                            // decrement indices of all later cubes
-                            (*iter)->index--;
-                        }
+                    // destroyed and removed from config in deletePressed
+                    int deleted = findIndexed(cubeArr, [hitTransform](Cube* cube) { return cube->deletePressed(hitTransform); });
+                    if(deleted >= 0) {
+                        eraseIndexed(cubeArr, deleted);
+                        selectionErased(deleted);
                     }
                 }
             }
-            if(i == getModConfig().BtnMake.GetValue() && (getModConfig().CtrlMake.GetValue() == 2 || getModConfig().CtrlMake.GetValue() == (isRight? 1 : 0))) {
-                getLogger().info("create pressed");
+            if(i == getModConfig().BtnMake.GetValue() && (getModConfig().CtrlMake.GetValue() == 2 || getModConfig().CtrlMake.GetValue() == (isRight? 1 : 0)) && canMakeCube()) {
+                LOG_DEBUG("create pressed");
                 // use pointer to get creation position
                 auto ctrlr = pointer->get_vrController();
                 auto pos = ctrlr->get_position() + (ctrlr->get_forward().get_normalized() * (1.5 * getModConfig().CreateDist.GetValue()));
@@ -257,11 +323,17 @@ MAKE_HOOK_MATCH(AnUpdate, &HMMainThreadDispatcher::Update, void, HMMainThreadDis
                 cubeArr.push_back(makeCube(info, QubesConfigs[0], cubeArr.size()));
                 QubesConfigs[0].AddCube(info);
             }
+            if(i == getModConfig().BtnUndo.GetValue() && (getModConfig().CtrlUndo.GetValue() == 2 || getModConfig().CtrlUndo.GetValue() == (isRight? 1 : 0)))
+                undoLayout();
+            if(i == getModConfig().BtnRedo.GetValue() && (getModConfig().CtrlRedo.GetValue() == 2 || getModConfig().CtrlRedo.GetValue() == (isRight? 1 : 0)))
+                redoLayout();
             if(i == getModConfig().BtnEdit.GetValue() && (getModConfig().CtrlEdit.GetValue() == 2 || getModConfig().CtrlEdit.GetValue() == (isRight? 1 : 0))) {
-                getLogger().info("edit pressed");
+                LOG_DEBUG("edit pressed");
                 // physics raycast allows interaction through ui elements
                 UnityEngine::RaycastHit hit;
-                if(UnityEngine::Physics::Raycast(pointer->get_vrController()->get_position(), pointer->get_vrController()->get_forward(), hit, 100)) {
+                if(getModConfig().MultiSelect.GetValue())
+                    selectPressed(isRight);
+                else if(UnityEngine::Physics::Raycast(pointer->get_vrController()->get_position(), pointer->get_vrController()->get_forward(), hit, 100)) {
                     auto hitTransform = hit.get_collider()->get_transform();
                     // cubes handle it internally
                     for(auto cube : cubeArr) {
@@ -274,6 +346,42 @@ MAKE_HOOK_MATCH(AnUpdate, &HMMainThreadDispatcher::Update, void, HMMainThreadDis
     }
 }
 
+// timestamps controller poses for the grab latency counter
+MAKE_HOOK_MATCH(ControllerUpdate, &VRController::Update, void, VRController* self) {
+    ControllerUpdate(self);
+    controllerSampled(self);
+}
+
+// after the blade positions are updated for the frame
+MAKE_HOOK_MATCH(SaberUpdate, &Saber::ManualUpdate, void, Saber* self) {
+    SaberUpdate(self);
+    sweepSaber(self);
+}
+
+// every cube's hitbox ends up here, so creating one doesn't need its own delegate
+MAKE_HOOK_MATCH(BoxCut, &BoxCuttableBySaber::Cut, void, BoxCuttableBySaber* self, Saber* saber, UnityEngine::Vector3 cutPoint, UnityEngine::Quaternion orientation, UnityEngine::Vector3 cutDirVec) {
+    // the original only fires the event when it can be cut
+    bool canBeCut = self->get_canBeCut();
+    BoxCut(self, saber, cutPoint, orientation, cutDirVec);
+    if(!canBeCut)
+        return;
+    if(auto cube = findCutTarget(self))
+        cube->handleCut(saber, cutPoint, orientation, cutDirVec);
+}
+
+// reads the layout the selected song would use ahead of time, so starting it doesn't wait on the disk
+MAKE_HOOK_MATCH(LevelSelected, &LevelCollectionViewController::HandleLevelCollectionTableViewDidSelectLevel, void, LevelCollectionViewController* self, LevelCollectionTableView* tableView, IPreviewBeatmapLevel* level) {
+    LevelSelected(self, tableView, level);
+    if(level)
+        songSelected(level->get_levelID());
+}
+
+MAKE_HOOK_MATCH(PlaylistSelected, &AnnotatedBeatmapLevelCollectionsViewController::HandleDidSelectAnnotatedBeatmapLevelCollection, void, AnnotatedBeatmapLevelCollectionsViewController* self, IAnnotatedBeatmapLevelCollection* collection) {
+    PlaylistSelected(self, collection);
+    if(collection)
+        playlistSelected(collection->get_collectionName());
+}
+
 MAKE_HOOK_MATCH(Pause, &PauseController::Pause, void, PauseController* self) {
     Pause(self);
     // this crashes it and i have no clue why, its not *too* annoying so im just leaving it
@@ -282,6 +390,7 @@ MAKE_HOOK_MATCH(Pause, &PauseController::Pause, void, PauseController* self) {
     //pointer = UnityEngine::Resources::FindObjectsOfTypeAll<VRUIControls::VRPointer*>();
     //getLogger().info("Success");;
     inMenu = true;
+    updateBroadphase();
 }
 
 MAKE_HOOK_MATCH(Resume, &PauseAnimationController::StartResumeFromPauseAnimation, void, PauseAnimationController* self) {
@@ -293,6 +402,7 @@ MAKE_HOOK_MATCH(Resume, &PauseAnimationController::StartResumeFromPauseAnimation
         cube->setCuttableDelay(true, 0.75);
     }
     inMenu = false;
+    updateBroadphase();
 }
 
 extern "C" void setup(ModInfo& info) {
@@ -300,25 +410,43 @@ extern "C" void setup(ModInfo& info) {
     info.version = VERSION;
     modInfo = info;
 	
-    getLogger().info("Completed setup!");
+    LOG_INFO("Completed setup!");
 }
 
 extern "C" void load() {
-    il2cpp_functions::Init();
-
-    custom_types::Register::AutoRegister();
-
-    getModConfig().Init(modInfo);
-    QuestUI::Init();
-    QuestUI::Register::RegisterModSettingsFlowCoordinator<ModSettings*>(modInfo);
-    QuestUI::Register::RegisterMainMenuModSettingsFlowCoordinator<ModSettings*>(modInfo);
-
-    getLogger().info("Installing hooks...");
-    LoggerContextObject logger = getLogger().WithContext("load");
-    INSTALL_HOOK(logger, SceneChanged);
-    INSTALL_HOOK(logger, DebrisInit);
-    INSTALL_HOOK(logger, AnUpdate);
-    INSTALL_HOOK(logger, Pause);
-    INSTALL_HOOK(logger, Resume);
-    getLogger().info("Installed all hooks!");
+    Qubes::Log::startWriter();
+    // the config isn't loaded yet, so keep events until it says whether to write them
+    Qubes::Trace::buffer();
+    {
+        TRACE_ZONE("load");
+        il2cpp_functions::Init();
+
+        custom_types::Register::AutoRegister();
+
+        {
+            TRACE_ZONE("ModConfig::Init");
+            getModConfig().Init(modInfo);
+        }
+        loadLayouts();
+        initHistory();
+        watchConfig();
+        QuestUI::Init();
+        QuestUI::Register::RegisterModSettingsFlowCoordinator<ModSettings*>(modInfo);
+        QuestUI::Register::RegisterMainMenuModSettingsFlowCoordinator<ModSettings*>(modInfo);
+
+        LOG_INFO("Installing hooks...");
+        LoggerContextObject logger = getLogger().WithContext("load");
+        INSTALL_HOOK(logger, SceneChanged);
+        INSTALL_HOOK(logger, DebrisInit);
+        INSTALL_HOOK(logger, AnUpdate);
+        INSTALL_HOOK(logger, Pause);
+        INSTALL_HOOK(logger, Resume);
+        INSTALL_HOOK(logger, SaberUpdate);
+        INSTALL_HOOK(logger, BoxCut);
+        INSTALL_HOOK(logger, ControllerUpdate);
+        INSTALL_HOOK(logger, LevelSelected);
+        INSTALL_HOOK(logger, PlaylistSelected);
+        LOG_INFO("Installed all hooks!");
+    }
+    updateTracing();
 }
\ No newline at end of file
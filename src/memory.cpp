@@ -0,0 +1,83 @@
+#include "main.hpp"
+#include "core/memory.hpp"
+#include "core/stats.hpp"
+
+#include "UnityEngine/Transform.hpp"
+
+#include "questui/shared/BeatSaberUI.hpp"
+
+using namespace QuestUI;
+
+std::string lastRefusal;
+
+Memory::Report memoryReport() {
+    TRACE_ZONE("memoryReport");
+    Memory::Counts counts = {
+        Stats::cubes.load(std::memory_order_relaxed),
+        // the pool and the preview aren't in it
+        (int) cubeArr.size(),
+        Stats::menus.load(std::memory_order_relaxed),
+        Stats::debrisAlive.load(std::memory_order_relaxed),
+        Stats::spriteBytes.load(std::memory_order_relaxed),
+        Memory::jsonBytes(getModConfig().config->config)
+    };
+    return Memory::estimate(counts);
+}
+
+uint64_t cubeMemory(DefaultCube* cube) {
+    Memory::Costs costs;
+    uint64_t bytes = costs.cube + costs.material + costs.cutTarget;
+    auto config = cube->getConfig();
+    auto& doc = config->storage->GetDocument();
+    if(doc.HasMember(config->name) && cube->index < doc[config->name].Size())
+        bytes += Memory::jsonBytes(doc[config->name][cube->index]);
+    // every menu makes the same sprites
+    int menus = Stats::menus.load(std::memory_order_relaxed);
+    if(cube->hasMenu() && menus > 0)
+        bytes += costs.menu + Stats::spriteBytes.load(std::memory_order_relaxed) / menus;
+    return bytes;
+}
+
+// shows text in front of the pointer for a few seconds
+void showMessage(std::string const& message) {
+    if(!pointer)
+        return;
+    auto go = BeatSaberUI::CreateCanvas();
+    auto t = go->get_transform();
+    auto controller = pointer->get_vrController();
+    Math::Vec3 forward = controller->get_forward();
+    forward.y = 0;
+    Math::Vec3 pos = controller->get_position();
+    t->set_position(pos + Math::normalized(forward) * 1.5 + Math::Vec3::up() * 0.3);
+    t->set_rotation(Math::angleAxis(Math::atan2(forward.x, forward.z) * Math::Rad2Deg, Math::Vec3::up()));
+    t->set_localScale({0.02, 0.02, 0.02});
+    auto text = BeatSaberUI::CreateText(t, message, {0, 0}, {80, 10});
+    text->set_alignment(TMPro::TextAlignmentOptions::Center);
+    text->set_color(UnityEngine::Color::get_red());
+    UnityEngine::Object::Destroy(go, 3);
+}
+
+static Memory::Limits limits() {
+    return {getModConfig().MaxCubes.GetValue(), (uint64_t) getModConfig().MemoryLimit.GetValue() * 1024 * 1024};
+}
+
+int cubeAllowance() {
+    auto limits = ::limits();
+    if(limits.maxCubes <= 0 && limits.maxBytes == 0)
+        return INT_MAX;
+    return Memory::cubeAllowance(memoryReport(), limits);
+}
+
+bool canMakeCube() {
+    auto limits = ::limits();
+    // skip the estimate when there's nothing to check
+    if(limits.maxCubes <= 0 && limits.maxBytes == 0)
+        return true;
+    auto reason = Memory::refuseCube(memoryReport(), limits);
+    if(reason.empty())
+        return true;
+    lastRefusal = "Qube not created, " + reason;
+    LOG_WARNING("%s", lastRefusal.c_str());
+    showMessage(lastRefusal);
+    return false;
+}
@@ -6,11 +6,14 @@
 #include "HMUI/ViewController_AnimationDirection.hpp"
 #include "questui/shared/BeatSaberUI.hpp"
 
+#include "core/allocations.hpp"
+
 DEFINE_TYPE(Qubes, GlobalSettings);
 DEFINE_TYPE(Qubes, CreationSettings);
 DEFINE_TYPE(Qubes, ButtonSettings);
 DEFINE_TYPE(Qubes, ModSettings);
 DEFINE_TYPE(Qubes, CreditsView);
+DEFINE_TYPE(Qubes, MemoryView);
 
 using namespace QuestUI;
 
@@ -36,14 +39,46 @@ void Qubes::ModSettings::DidActivate(bool firstActivation, bool addedToHierarchy
         buttonSettings = BeatSaberUI::CreateViewController<Qubes::ButtonSettings*>();
     if(!credits)
         credits = BeatSaberUI::CreateViewController<Qubes::CreditsView*>();
+    if(!memoryView)
+        memoryView = BeatSaberUI::CreateViewController<Qubes::MemoryView*>();
     showBackButton = true;
     static ConstString title("Qube Settings");
     SetTitle(title, HMUI::ViewController::AnimationType::In);
 
-    ProvideInitialViewControllers(globalSettings, creationSettings, buttonSettings, credits, nullptr);
+    ProvideInitialViewControllers(globalSettings, creationSettings, buttonSettings, credits, memoryView);
+}
+
+void Qubes::ModSettings::showLayout() {
+    if(!layoutView)
+        layoutView = BeatSaberUI::CreateViewController<Qubes::LayoutView*>();
+    PresentViewController(layoutView, nullptr, HMUI::ViewController::AnimationDirection::Horizontal, false);
+}
+
+void Qubes::ModSettings::showLayoutSettings() {
+    if(!layoutSettings)
+        layoutSettings = BeatSaberUI::CreateViewController<Qubes::LayoutSettings*>();
+    PresentViewController(layoutSettings, nullptr, HMUI::ViewController::AnimationDirection::Horizontal, false);
+}
+
+void Qubes::ModSettings::showGenerator() {
+    if(!generatorSettings)
+        generatorSettings = BeatSaberUI::CreateViewController<Qubes::GeneratorSettings*>();
+    PresentViewController(generatorSettings, nullptr, HMUI::ViewController::AnimationDirection::Horizontal, false);
 }
 
 void Qubes::ModSettings::BackButtonWasPressed(HMUI::ViewController* topViewController) {
+    if(layoutView && topViewController == layoutView) {
+        DismissViewController(layoutView, HMUI::ViewController::AnimationDirection::Horizontal, nullptr, false);
+        return;
+    }
+    if(layoutSettings && topViewController == layoutSettings) {
+        DismissViewController(layoutSettings, HMUI::ViewController::AnimationDirection::Horizontal, nullptr, false);
+        return;
+    }
+    if(generatorSettings && topViewController == generatorSettings) {
+        DismissViewController(generatorSettings, HMUI::ViewController::AnimationDirection::Horizontal, nullptr, false);
+        return;
+    }
     parentFlowCoordinator->DismissFlowCoordinator(this, HMUI::ViewController::AnimationDirection::Horizontal, nullptr, false);
     
     // set back to show in menu value
@@ -55,8 +90,10 @@ void Qubes::ModSettings::BackButtonWasPressed(HMUI::ViewController* topViewContr
 
 #pragma region globalSettings
 void Qubes::GlobalSettings::DidActivate(bool firstActivation, bool addedToHierarchy, bool screenSystemEnabling) {
-    if(!firstActivation)
+    if(!firstActivation) {
+        qualityText->SetText(std::string("Current Quality: ") + tierName(governor.getTier()));
         return;
+    }
     
     get_gameObject()->AddComponent<HMUI::Touchable*>();
     auto vertical = BeatSaberUI::CreateVerticalLayoutGroup(get_transform());
@@ -74,6 +111,30 @@ void Qubes::GlobalSettings::DidActivate(bool firstActivation, bool addedToHierar
     AddConfigValueToggle(verticalTransform, getModConfig().Debris);
     AddConfigValueIncrementFloat(verticalTransform, getModConfig().RespawnTime, 1, 0.5, 0, 5);
     AddConfigValueIncrementFloat(verticalTransform, getModConfig().Vibration, 1, 0.1, 0, 2);
+    AddConfigValueToggle(verticalTransform, getModConfig().FreezeLayout);
+    AddConfigValueToggle(verticalTransform, getModConfig().Broadphase);
+    AddConfigValueToggle(verticalTransform, getModConfig().AdaptiveQuality);
+    qualityText = BeatSaberUI::CreateText(verticalTransform, std::string("Current Quality: ") + tierName(governor.getTier()));
+    AddConfigValueToggle(verticalTransform, getModConfig().RecordInput);
+    AddConfigValueToggle(verticalTransform, getModConfig().Tracing);
+    AddConfigValueToggle(verticalTransform, getModConfig().ProfileAllocs);
+    AddConfigValueIncrementInt(verticalTransform, getModConfig().AllocBudget, 1, 0, 64);
+    AddConfigValueToggle(verticalTransform, getModConfig().ShowOverlay);
+    BeatSaberUI::CreateUIButton(verticalTransform, "Browse Layout", []() {
+        auto flow = BeatSaberUI::GetMainFlowCoordinator()->YoungestChildFlowCoordinatorOrSelf();
+        if(auto settings = il2cpp_utils::try_cast<Qubes::ModSettings>(flow))
+            settings.value()->showLayout();
+    });
+    BeatSaberUI::CreateUIButton(verticalTransform, "Manage Layouts", []() {
+        auto flow = BeatSaberUI::GetMainFlowCoordinator()->YoungestChildFlowCoordinatorOrSelf();
+        if(auto settings = il2cpp_utils::try_cast<Qubes::ModSettings>(flow))
+            settings.value()->showLayoutSettings();
+    });
+    BeatSaberUI::CreateUIButton(verticalTransform, "Generate Qubes", []() {
+        auto flow = BeatSaberUI::GetMainFlowCoordinator()->YoungestChildFlowCoordinatorOrSelf();
+        if(auto settings = il2cpp_utils::try_cast<Qubes::ModSettings>(flow))
+            settings.value()->showGenerator();
+    });
 }
 #pragma endregion
 
@@ -109,10 +170,14 @@ void Qubes::CreationSettings::DidActivate(bool firstActivation, bool addedToHier
 #pragma region buttonSettings
 // makes the paired dropdown menus for controller bindings
 void makeDropdowns(UnityEngine::Transform* parent, ConfigUtils::ConfigValue<int>& buttonSetting, ConfigUtils::ConfigValue<int>& controllerSetting) {
+    for(auto& name : buttonNames)
+        TRACK_ALLOC("makeDropdowns StringW list", sizeof(Il2CppString) + name.size() * sizeof(Il2CppChar));
     std::vector<StringW> buttonNamesList(buttonNames.begin(), buttonNames.end());
     auto layout = BeatSaberUI::CreateHorizontalLayoutGroup(parent)->get_transform();
     auto d = BeatSaberUI::CreateDropdown(layout, buttonSetting.GetName(), buttonNamesList[buttonSetting.GetValue()], buttonNamesList, [&buttonSetting](StringW value){
         for(int i = 0; i < buttonNames.size(); i++) {
+            // compares as utf8, so this copies the managed string every time
+            TRACK_ALLOC("button dropdown StringW compare", ((Il2CppString*) value)->length);
             if(value == buttonNames[i]) {
                 buttonSetting.SetValue(i);
                 break;
@@ -125,9 +190,12 @@ void makeDropdowns(UnityEngine::Transform* parent, ConfigUtils::ConfigValue<int>
     ((UnityEngine::RectTransform*) p->Find(labelName))->set_anchorMax({2, 1});
     p->get_gameObject()->GetComponent<UnityEngine::UI::LayoutElement*>()->set_preferredWidth(48);
 
+    for(auto& name : controllerNames)
+        TRACK_ALLOC("makeDropdowns StringW list", sizeof(Il2CppString) + name.size() * sizeof(Il2CppChar));
     std::vector<StringW> controllerNamesList(controllerNames.begin(), controllerNames.end());
     d = BeatSaberUI::CreateDropdown(layout, controllerSetting.GetName(), controllerNamesList[controllerSetting.GetValue()], controllerNamesList, [&controllerSetting](StringW value){
         for(int i = 0; i < controllerNames.size(); i++) {
+            TRACK_ALLOC("controller dropdown StringW compare", ((Il2CppString*) value)->length);
             if(controllerNames[i] == value) {
                 controllerSetting.SetValue(i);
                 break;
@@ -157,10 +225,57 @@ void Qubes::ButtonSettings::DidActivate(bool firstActivation, bool addedToHierar
     makeDropdowns(verticalTransform, getModConfig().BtnMake, getModConfig().CtrlMake);
     makeDropdowns(verticalTransform, getModConfig().BtnEdit, getModConfig().CtrlEdit);
     makeDropdowns(verticalTransform, getModConfig().BtnDel, getModConfig().CtrlDel);
+    makeDropdowns(verticalTransform, getModConfig().BtnUndo, getModConfig().CtrlUndo);
+    makeDropdowns(verticalTransform, getModConfig().BtnRedo, getModConfig().CtrlRedo);
     
     AddConfigValueIncrementFloat(verticalTransform, getModConfig().MoveSpeed, 1, 0.1, 0, 5);
     AddConfigValueIncrementFloat(verticalTransform, getModConfig().RotSpeed, 1, 0.1, 0, 5);
     AddConfigValueToggle(verticalTransform, getModConfig().LeftThumbMove);
+    AddConfigValueToggle(verticalTransform, getModConfig().MultiSelect);
+    AddConfigValueToggle(verticalTransform, getModConfig().DirectGrab);
+    AddConfigValueIncrementFloat(verticalTransform, getModConfig().GrabSmoothing, 2, 0.01, 0, 0.2);
+    AddConfigValueToggle(verticalTransform, getModConfig().ThrowCubes);
+    AddConfigValueIncrementFloat(verticalTransform, getModConfig().Gravity, 1, 0.5, 0, 9.8);
+}
+#pragma endregion
+
+#pragma region memoryView
+void Qubes::MemoryView::DidActivate(bool firstActivation, bool addedToHierarchy, bool screenSystemEnabling) {
+    if(firstActivation) {
+        get_gameObject()->AddComponent<HMUI::Touchable*>();
+        auto horizontal = BeatSaberUI::CreateHorizontalLayoutGroup(get_transform());
+        horizontal->set_spacing(4);
+        auto horizontalTransform = horizontal->get_transform();
+
+        text = BeatSaberUI::CreateText(horizontalTransform, "");
+        text->set_fontSize(3);
+
+        auto vertical = BeatSaberUI::CreateVerticalLayoutGroup(horizontalTransform);
+        vertical->set_childControlHeight(false);
+        vertical->set_childForceExpandHeight(false);
+        auto verticalTransform = vertical->get_transform();
+        AddConfigValueIncrementInt(verticalTransform, getModConfig().MaxCubes, 25, 0, 10000);
+        AddConfigValueIncrementInt(verticalTransform, getModConfig().MemoryLimit, 16, 0, 1024);
+        BeatSaberUI::CreateIncrementSetting(verticalTransform, getModConfig().UndoMemory.GetName(), 0, 64, getModConfig().UndoMemory.GetValue(), 0, 8192, [](float value) {
+            getModConfig().UndoMemory.SetValue(value);
+            setHistoryLimit();
+        });
+        BeatSaberUI::CreateUIButton(verticalTransform, "Refresh", [this]() { refresh(); });
+    }
+    refresh();
+}
+
+void Qubes::MemoryView::refresh() {
+    auto report = memoryReport();
+    std::string lines = "Estimated memory: " + Memory::formatBytes(report.total) + "\n";
+    for(int i = 0; i < Memory::SubsystemCount; i++)
+        lines += std::string(Memory::subsystemNames[i]) + ": " + Memory::formatBytes(report.bytes[i]) + "\n";
+    lines += std::to_string(report.cubes) + " qubes, " + Memory::formatBytes(report.perCube) + " each\n";
+    auto& history = layoutHistory();
+    lines += "Undo history: " + Memory::formatBytes(history.memory()) + ", " + std::to_string(history.undoCount()) + " steps";
+    if(!lastRefusal.empty())
+        lines += "\n<color=red>" + lastRefusal + "</color>";
+    text->SetText(lines);
 }
 #pragma endregion
 
@@ -0,0 +1,70 @@
+#include "main.hpp"
+#include "overlay.hpp"
+#include "core/stats.hpp"
+
+#include "UnityEngine/Canvas.hpp"
+#include "UnityEngine/RectTransform.hpp"
+#include "UnityEngine/Time.hpp"
+
+#include "questui/shared/BeatSaberUI.hpp"
+#include "questui/shared/CustomTypes/Components/Backgroundable.hpp"
+
+DEFINE_TYPE(Qubes, PerfOverlay);
+
+using namespace QuestUI;
+
+// a few times a second, so updating the text doesn't show up in what it measures
+constexpr float refreshInterval = 0.25;
+
+static PerfOverlay* overlay = nullptr;
+
+void PerfOverlay::init() {
+    auto background = get_gameObject()->AddComponent<Backgroundable*>();
+    background->ApplyBackgroundWithAlpha("round-rect-panel", 0.5);
+    GetComponent<UnityEngine::Canvas*>()->set_sortingOrder(31);
+
+    // fixed above the left side of the menu, where it doesn't cover notes
+    auto t = get_transform();
+    t->set_position({-2, 3, 3});
+    t->set_eulerAngles({-15, -30, 0});
+    t->set_localScale({0.02, 0.02, 0.02});
+    ((UnityEngine::RectTransform*) t)->set_sizeDelta({50, 25});
+
+    text = BeatSaberUI::CreateText(t, "", {2, 0}, {46, 23});
+    text->set_fontSize(3.5);
+    elapsed = refreshInterval;
+}
+
+void PerfOverlay::Update() {
+    elapsed += UnityEngine::Time::get_unscaledDeltaTime();
+    if(elapsed < refreshInterval)
+        return;
+    float writeRate = Stats::configWrites.exchange(0, std::memory_order_relaxed) / elapsed;
+    elapsed = 0;
+
+    char buffer[256];
+    snprintf(buffer, sizeof(buffer),
+        "Qubes CPU  p50 %.3f ms  p99 %.3f ms\nCubes %i (%i static)  Debris %i  Menus %i\nCoroutines %i  Config writes %.1f/s\nGrab latency %.1f ms\nQuality %s",
+        Stats::frames.percentile(0.5) / 1e6, Stats::frames.percentile(0.99) / 1e6,
+        Stats::activeCubes.load(std::memory_order_relaxed), Stats::staticCubes.load(std::memory_order_relaxed), Stats::debrisAlive.load(std::memory_order_relaxed), Stats::menus.load(std::memory_order_relaxed),
+        Stats::coroutines.load(std::memory_order_relaxed), writeRate, Stats::grabLatencyMicros.load(std::memory_order_relaxed) / 1e3, tierName(governor.getTier()));
+    text->SetText(std::string(buffer));
+}
+
+void Qubes::setOverlayActive(bool active) {
+    Stats::timing = active;
+    if(!active) {
+        if(overlay)
+            overlay->get_gameObject()->set_active(false);
+        return;
+    }
+    if(!overlay) {
+        auto go = BeatSaberUI::CreateCanvas();
+        UnityEngine::Object::DontDestroyOnLoad(go);
+        overlay = go->AddComponent<PerfOverlay*>();
+        overlay->init();
+    }
+    // don't show times from before it was turned on
+    Stats::frames.clear();
+    overlay->get_gameObject()->set_active(true);
+}
@@ -0,0 +1,60 @@
+#include "main.hpp"
+#include "core/physics.hpp"
+
+#include "UnityEngine/Time.hpp"
+
+static PhysicsBatch batch;
+// cubes by their slot in batch
+static std::vector<Cube*> slots;
+static std::vector<int> rested;
+
+static void removeSlot(int slot) {
+    slots[slot]->physSlot = -1;
+    int moved = batch.remove(slot);
+    if(moved >= 0) {
+        slots[slot] = slots[moved];
+        slots[slot]->physSlot = slot;
+    }
+    slots.pop_back();
+}
+
+void throwCube(Cube* cube, Math::Vec3 velocity, Math::Vec3 angularVelocity) {
+    if(cube->physSlot >= 0)
+        removeSlot(cube->physSlot);
+    auto t = cube->get_transform();
+    // the same half width as the cut bounds
+    cube->physSlot = batch.add({t->get_position(), t->get_rotation()}, velocity, angularVelocity, cube->getSize() * 0.25f);
+    slots.push_back(cube);
+    // moving cubes can't be drawn from static meshes
+    cube->refreshStatic();
+}
+
+void stopCubePhysics(DefaultCube* cube) {
+    if(cube->physSlot >= 0)
+        removeSlot(cube->physSlot);
+}
+
+void updatePhysics() {
+    if(batch.size() == 0 || (inGameplay && inMenu))
+        return;
+    TRACE_ZONE("updatePhysics");
+    PhysicsSettings settings;
+    settings.gravity = getModConfig().Gravity.GetValue();
+    batch.step(UnityEngine::Time::get_deltaTime(), settings, rested);
+
+    for(int i = 0; i < batch.size(); i++) {
+        auto pose = batch.getPose(i);
+        slots[i]->get_transform()->SetPositionAndRotation(pose.pos, pose.rot);
+        moveBroadphaseCube(slots[i]);
+    }
+    // back to front so removing doesn't move a slot that is still to be removed
+    for(auto it = rested.rbegin(); it != rested.rend(); it++) {
+        auto cube = slots[*it];
+        removeSlot(*it);
+        cube->refreshStatic();
+        cube->save();
+    }
+    // refitting doesn't rebalance, so once thrown cubes land far from where they were built it's worth doing
+    if(!rested.empty())
+        markBroadphaseDirty();
+}
@@ -0,0 +1,69 @@
+#include "main.hpp"
+
+#include "UnityEngine/Camera.hpp"
+#include "UnityEngine/Time.hpp"
+#include "UnityEngine/XR/XRDevice.hpp"
+
+Governor governor;
+static RateLimiter debrisLimiter;
+
+// cuts per second once debris is capped, each one spawns two pieces
+constexpr float cappedCutRate = 3;
+constexpr float cappedCutBurst = 2;
+// glow is hidden on cubes further than this from the head
+constexpr float glowDistance = 3;
+// distances change slowly, no need to check every frame
+constexpr float glowCheckInterval = 0.5;
+static float sinceGlowCheck = 0;
+
+static void updateGlow(bool hideDistant) {
+    Math::Vec3 head;
+    if(hideDistant) {
+        auto camera = UnityEngine::Camera::get_main();
+        if(!camera)
+            return;
+        head = camera->get_transform()->get_position();
+    }
+    for(auto cube : cubeArr) {
+        Math::Vec3 pos = cube->get_transform()->get_position();
+        cube->setGlowHidden(hideDistant && Math::sqrMagnitude(pos - head) > glowDistance * glowDistance);
+    }
+}
+
+void updateQuality() {
+    if(!getModConfig().AdaptiveQuality.GetValue()) {
+        if(governor.getTier() != QualityTier::Full) {
+            governor.reset();
+            updateGlow(false);
+        }
+        return;
+    }
+    float deltaTime = UnityEngine::Time::get_unscaledDeltaTime();
+    // the headset's refresh rate, which the game can change, is the budget each frame has
+    float refreshRate = UnityEngine::XR::XRDevice::get_refreshRate();
+    if(governor.update(deltaTime, refreshRate)) {
+        LOG_INFO("Quality changed to %s", tierName(governor.getTier()));
+        if(!governor.atLeast(QualityTier::NoDistantGlow))
+            updateGlow(false);
+        // check right away when stepping into the glow tier
+        sinceGlowCheck = glowCheckInterval;
+    }
+    debrisLimiter.update(deltaTime, cappedCutRate, cappedCutBurst);
+    if(governor.atLeast(QualityTier::NoDistantGlow)) {
+        sinceGlowCheck += deltaTime;
+        if(sinceGlowCheck >= glowCheckInterval) {
+            sinceGlowCheck = 0;
+            updateGlow(true);
+        }
+    }
+}
+
+GlobalNamespace::NoteDebris* takeDebrisPrefab() {
+    if(governor.atLeast(QualityTier::NoDebris))
+        return nullptr;
+    if(governor.atLeast(QualityTier::CappedDebris) && !debrisLimiter.take())
+        return nullptr;
+    if(governor.atLeast(QualityTier::LightDebris) && debrisPrefabLight)
+        return debrisPrefabLight;
+    return debrisPrefab;
+}
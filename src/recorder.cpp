@@ -0,0 +1,49 @@
+#include "main.hpp"
+
+#include "core/recording.hpp"
+
+#include "GlobalNamespace/OVRInput.hpp"
+#include "UnityEngine/Time.hpp"
+
+#include <ctime>
+
+using namespace GlobalNamespace;
+
+// controller input for replaying in the host frame simulator, only recorded while RecordInput is enabled
+static std::vector<InputFrame> recording;
+// about five minutes at 90 fps, saved to a new file once full
+static constexpr int maxRecordedFrames = 27000;
+
+void recordInput(std::vector<OVRInput::Button> const& buttons) {
+    auto controller = pointer->get_vrController();
+    InputFrame frame = {};
+    frame.deltaTime = UnityEngine::Time::get_unscaledDeltaTime();
+    frame.pos = controller->get_position();
+    frame.rot = controller->get_rotation();
+    frame.trigger = controller->get_triggerValue();
+    frame.horizontal = controller->get_horizontalAxisValue();
+    frame.vertical = controller->get_verticalAxisValue();
+    frame.lastUsedRight = pointer->_get__lastControllerUsedWasRight();
+    for(int i = 0; i < buttons.size(); i++) {
+        if(OVRInput::Get(buttons[i], OVRInput::Controller::LTouch))
+            frame.setHeld(i, false);
+        if(OVRInput::Get(buttons[i], OVRInput::Controller::RTouch))
+            frame.setHeld(i, true);
+    }
+    recording.push_back(frame);
+    if(recording.size() >= maxRecordedFrames)
+        saveRecording();
+}
+
+void saveRecording() {
+    if(recording.empty())
+        return;
+    // a full buffer and a scene change can happen in the same second
+    static int saved = 0;
+    std::string path = getDataDir(modInfo) + "input_" + std::to_string(std::time(nullptr)) + "_" + std::to_string(saved++) + ".qrec";
+    if(writeRecording(path, recording))
+        LOG_INFO("Saved %i recorded frames to %s", (int) recording.size(), path.c_str());
+    else
+        LOG_ERROR("Failed to save recording to %s", path.c_str());
+    recording.clear();
+}
@@ -0,0 +1,162 @@
+#include "main.hpp"
+#include "core/layouts.hpp"
+
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+// a config read by the watcher, waiting for the main thread
+struct PendingReload {
+    rapidjson::Document doc;
+    std::vector<CubeInfo> cubes;
+    LayoutDiff diff;
+    // of the snapshot the diff was made against
+    uint64_t version;
+    // whether that snapshot was of the default layout, the only one the file has
+    bool againstDefault;
+};
+static std::mutex pendingMutex;
+static std::unique_ptr<PendingReload> pending;
+
+static void readConfig(std::string const& path, SnapshotPublisher& live) {
+    TRACE_ZONE("readConfig");
+    std::ifstream file(path);
+    std::stringstream text;
+    text << file.rdbuf();
+    auto reload = std::make_unique<PendingReload>();
+    auto& doc = reload->doc;
+    doc.Parse(text.str().c_str());
+    if(doc.HasParseError() || !doc.IsObject()) {
+        LOG_WARNING("Config changed but isn't valid json, not reloading");
+        return;
+    }
+    migrateDocument(doc);
+    auto section = doc.FindMember("qubes");
+    if(section == doc.MemberEnd() || !section->value.IsArray()) {
+        LOG_WARNING("Config changed but has no qubes array, not reloading");
+        return;
+    }
+    std::string error;
+    for(auto& cube : section->value.GetArray()) {
+        if(!validCube(cube, &error)) {
+            LOG_WARNING("Config changed but has a broken qube (%s), not reloading", error.c_str());
+            return;
+        }
+        reload->cubes.emplace_back(cube);
+    }
+
+    // the live cubes as of their last save, so this doesn't need the main thread
+    auto snapshot = live.acquire();
+    reload->version = snapshot->version;
+    // checked after acquiring, a switch sets it before publishing, so a default snapshot is never mistaken for another
+    reload->againstDefault = defaultLayoutShown();
+    if(reload->againstDefault)
+        reload->diff = diffLayouts(SnapshotPublisher::cubeInfos(snapshot), reload->cubes);
+    SnapshotPublisher::release(snapshot);
+    // usually our own write, but other mods' arrays may have changed too, so those are checked on apply
+    LOG_DEBUG("Config changed: %zu qubes changed, %zu removed", reload->diff.changed.size(), reload->diff.removed.size());
+
+    std::lock_guard lock(pendingMutex);
+    pending = std::move(reload);
+}
+
+// holds on to the publisher itself, QubesConfigs can move while this runs
+static void watchLoop(std::string path, std::shared_ptr<SnapshotPublisher> live) {
+    int fd = inotify_init1(IN_CLOEXEC);
+    // editors and adb often replace the file instead of writing to it, so watch the folder
+    auto slash = path.rfind('/');
+    std::string folder = path.substr(0, slash), name = path.substr(slash + 1);
+    if(fd < 0 || inotify_add_watch(fd, folder.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        LOG_ERROR("Couldn't watch the config for changes");
+        return;
+    }
+    alignas(inotify_event) char buffer[4096];
+    while(true) {
+        bool changed = false;
+        // blocks until something happens in the folder, then waits for it to be quiet for a moment
+        int timeout = -1;
+        pollfd poller = {fd, POLLIN, 0};
+        while(poll(&poller, 1, timeout) > 0) {
+            int length = read(fd, buffer, sizeof(buffer));
+            for(int offset = 0; offset < length;) {
+                auto event = (inotify_event*) (buffer + offset);
+                if(event->len > 0 && name == event->name)
+                    changed = true;
+                offset += sizeof(inotify_event) + event->len;
+            }
+            timeout = changed ? 250 : -1;
+        }
+        if(changed)
+            readConfig(path, *live);
+    }
+}
+
+void watchConfig() {
+    static bool started = false;
+    if(started)
+        return;
+    started = true;
+    std::thread(watchLoop, getConfigFilePath(modInfo), QubesConfigs[0].snapshots).detach();
+}
+
+void applyConfigReload() {
+    std::unique_ptr<PendingReload> reload;
+    {
+        std::lock_guard lock(pendingMutex);
+        reload = std::move(pending);
+    }
+    // not made yet, or nothing to do
+    if(!reload || !created)
+        return;
+    auto& config = QubesConfigs[0];
+    bool showingDefault = activeLayout() == DefaultLayout;
+    // a version from another layout's snapshot says nothing about saves of this one
+    if(showingDefault && reload->againstDefault) {
+        auto snapshot = config.snapshots->acquire();
+        uint64_t version = snapshot->version;
+        SnapshotPublisher::release(snapshot);
+        // saved since the file was read, that save's own write will come through again
+        if(version != reload->version)
+            return;
+    }
+    TRACE_ZONE("applyConfigReload");
+
+    // other mods' cubes are theirs to remake, but their arrays have to match the file so saving doesn't undo the edit
+    for(int i = 1; i < QubesConfigs.size(); i++) {
+        auto& other = QubesConfigs[i];
+        auto& doc = other.storage->GetDocument();
+        auto section = reload->doc.FindMember(other.name);
+        if(section == reload->doc.MemberEnd() || !section->value.IsArray() || section->value == doc[other.name])
+            continue;
+        bool valid = true;
+        for(auto& cube : section->value.GetArray())
+            valid &= validCube(cube);
+        if(!valid)
+            continue;
+        doc[other.name].CopyFrom(section->value, doc.GetAllocator());
+        other.LoadValue();
+    }
+    // the file only has the default layout, while another one is shown only the document takes the edit
+    // so that the next write of the config, like saving bindings, doesn't put the old cubes back
+    if(!showingDefault) {
+        auto& doc = defaultLayoutStorage()->GetDocument();
+        doc["qubes"].CopyFrom(reload->doc["qubes"], doc.GetAllocator());
+        return;
+    }
+    // read while another layout was shown, so there's no diff against the default one yet
+    if(!reload->againstDefault)
+        reload->diff = diffLayouts(config.cubes, reload->cubes);
+    if(reload->diff.empty())
+        return;
+    LOG_INFO("Reloading config: %zu qubes changed, %zu removed", reload->diff.changed.size(), reload->diff.removed.size());
+
+    applyLayout(std::move(reload->cubes), reload->diff);
+    // the file already has these, so only the document and the cubes in memory change
+    auto& doc = config.storage->GetDocument();
+    doc["qubes"].CopyFrom(reload->doc["qubes"], doc.GetAllocator());
+}
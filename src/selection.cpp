@@ -0,0 +1,285 @@
+#include "main.hpp"
+#include "core/selection.hpp"
+
+#include "questui/shared/BeatSaberUI.hpp"
+#include "questui/shared/CustomTypes/Components/Backgroundable.hpp"
+#include "HMUI/Touchable.hpp"
+#include "UnityEngine/Canvas.hpp"
+#include "UnityEngine/Collider.hpp"
+#include "UnityEngine/Physics.hpp"
+#include "UnityEngine/RectTransform.hpp"
+
+using namespace GlobalNamespace;
+using namespace QuestUI;
+
+static Selection selection;
+static std::vector<int> selected;
+
+// what holding the edit button does, decided by whether it was pressed on a cube
+enum class Drag { None, Paint, Box };
+static Drag drag = Drag::None;
+static bool dragRight = false;
+// painting selects or deselects, whichever the first cube wasn't
+static bool paintSelects = true;
+static Math::Vec3 boxStart;
+// boxes are grown by this on every side, so dragging across a flat row still catches it
+constexpr float BoxPad = 0.25;
+
+static UnityEngine::GameObject* bulkMenu = nullptr;
+static TMPro::TextMeshProUGUI* countText = nullptr;
+static IncrementSetting *typeInc = nullptr, *actionInc = nullptr;
+static Math::Color bulkColor = {1, 1, 1, 1};
+
+#pragma region selecting
+// where the pointer would create a cube
+static Math::Vec3 pointerTarget() {
+    auto controller = pointer->get_vrController();
+    return controller->get_position() + controller->get_forward().get_normalized() * (1.5 * getModConfig().CreateDist.GetValue());
+}
+
+static Cube* pointedCube() {
+    auto controller = pointer->get_vrController();
+    UnityEngine::RaycastHit hit;
+    if(!UnityEngine::Physics::Raycast(controller->get_position(), controller->get_forward(), hit, 100))
+        return nullptr;
+    auto hitbox = hit.get_collider()->GetComponent<BoxCuttableBySaber*>();
+    return hitbox ? findCutTarget(hitbox) : nullptr;
+}
+
+static void makeBulkMenu();
+
+// shows the bulk menu in front of the pointer when something was first selected, and hides it once nothing is
+static void refreshBulkMenu() {
+    int count = selection.count();
+    if(count == 0) {
+        if(bulkMenu)
+            bulkMenu->set_active(false);
+        return;
+    }
+    if(!bulkMenu)
+        makeBulkMenu();
+    if(!bulkMenu->get_active()) {
+        auto controller = pointer->get_vrController();
+        float yaw = controller->get_rotation().get_eulerAngles().y;
+        auto forward = Math::angleAxis(yaw, Math::Vec3::up()) * Math::Vec3{0, 0, 1};
+        bulkMenu->get_transform()->SetPositionAndRotation(Math::Vec3(controller->get_position()) + forward, Math::angleAxis(yaw, Math::Vec3::up()));
+        bulkMenu->set_active(true);
+    }
+    countText->SetText(std::to_string(count) + (count == 1 ? " qube selected" : " qubes selected"));
+}
+
+bool isSelected(int index) {
+    return selection.test(index);
+}
+
+static void setSelected(Cube* cube, bool select) {
+    selection.set(cube->index, select);
+    cube->setHighlighted(select);
+}
+
+void selectPressed(bool right) {
+    dragRight = right;
+    if(auto cube = pointedCube()) {
+        drag = Drag::Paint;
+        paintSelects = !selection.test(cube->index);
+        setSelected(cube, paintSelects);
+        refreshBulkMenu();
+    } else {
+        drag = Drag::Box;
+        boxStart = pointerTarget();
+    }
+}
+
+void updateSelection(OVRInput::Button editButton) {
+    if(!getModConfig().MultiSelect.GetValue()) {
+        if(!selection.empty())
+            clearSelection();
+        drag = Drag::None;
+        return;
+    }
+    if(drag == Drag::None || !pointer)
+        return;
+    bool held = OVRInput::Get(editButton, dragRight ? OVRInput::Controller::RTouch : OVRInput::Controller::LTouch);
+    if(drag == Drag::Paint) {
+        auto cube = pointedCube();
+        if(cube && selection.test(cube->index) != paintSelects) {
+            setSelected(cube, paintSelects);
+            refreshBulkMenu();
+        }
+    } else if(!held) {
+        auto boxEnd = pointerTarget();
+        // pressing on nothing without dragging clears instead
+        if(Math::magnitude(boxEnd - boxStart) < 0.05)
+            clearSelection();
+        else {
+            TRACE_ZONE("box select");
+            selectBox(QubesConfigs[0].cubes, boxStart, boxEnd, BoxPad, selection);
+            selection.indices(selected);
+            for(int i : selected)
+                cubeArr[i]->setHighlighted(true);
+            refreshBulkMenu();
+        }
+    }
+    if(!held)
+        drag = Drag::None;
+}
+
+void clearSelection() {
+    selection.indices(selected);
+    for(int i : selected) {
+        if(i < cubeArr.size())
+            cubeArr[i]->setHighlighted(false);
+    }
+    selection.clear();
+    drag = Drag::None;
+    refreshBulkMenu();
+}
+
+void selectionErased(int index) {
+    selection.erase(index);
+    refreshBulkMenu();
+}
+#pragma endregion
+
+#pragma region bulkEdit
+// locked cubes, or all of them with FreezeLayout, can't be moved or deleted
+static bool pinned(int i) {
+    return cubeArr[i]->getLocked() || cubeArr[i]->isStatic();
+}
+
+// every selected cube is changed first, then saved with a single write
+// locked cubes are skipped by moves and turns and stay selected, like moving them one at a time
+static void applyBulk(BulkEdit edit) {
+    TRACE_ZONE("applyBulk");
+    selection.indices(selected);
+    if(edit.fields & (BulkEdit::Move | BulkEdit::Rotate))
+        std::erase_if(selected, pinned);
+    if(selected.empty())
+        return;
+    auto& config = QubesConfigs[0];
+    // turns around the cubes that actually move
+    if(edit.fields & BulkEdit::Rotate)
+        edit.pivot = selectionCenter(config.cubes, selected);
+    std::vector<CubeInfo> values;
+    values.reserve(selected.size());
+    for(int i : selected) {
+        CubeInfo info = config.cubes[i];
+        edit.apply(info);
+        // only marks batches and the broadphase dirty, they're rebuilt once next frame
+        cubeArr[i]->setInfo(info);
+        values.push_back(std::move(info));
+    }
+    config.SetCubeValues(selected, values);
+}
+
+// locked cubes are skipped and stay selected, like deleting them one at a time
+static void deleteSelected() {
+    TRACE_ZONE("deleteSelected");
+    selection.indices(selected);
+    std::erase_if(selected, pinned);
+    if(selected.empty())
+        return;
+    // the locked ones that are left move down too
+    eraseCubes(selected);
+}
+
+static void makeBulkMenu() {
+    bulkMenu = BeatSaberUI::CreateCanvas();
+    UnityEngine::Object::DontDestroyOnLoad(bulkMenu);
+    bulkMenu->GetComponent<UnityEngine::Canvas*>()->set_sortingOrder(31);
+    auto background = bulkMenu->AddComponent<Backgroundable*>();
+    background->ApplyBackgroundWithAlpha("round-rect-panel", 0.5);
+    background->background->set_raycastTarget(true);
+    bulkMenu->AddComponent<HMUI::Touchable*>();
+    auto transform = (UnityEngine::RectTransform*) bulkMenu->get_transform();
+    transform->set_localScale({0.03, 0.03, 0.03});
+    transform->set_sizeDelta({80, 70});
+
+    auto vertical = BeatSaberUI::CreateVerticalLayoutGroup(transform);
+    vertical->set_childControlHeight(true);
+    vertical->set_childForceExpandHeight(false);
+    vertical->set_spacing(0.5);
+    auto verticalTransform = vertical->get_transform();
+    auto row = [verticalTransform]() {
+        return BeatSaberUI::CreateHorizontalLayoutGroup(verticalTransform)->get_transform();
+    };
+
+    countText = BeatSaberUI::CreateText(verticalTransform, "");
+    countText->set_alignment(TMPro::TextAlignmentOptions::Center);
+
+    // each step is one edit and one write, so these don't use sliders
+    typeInc = BeatSaberUI::CreateIncrementSetting(verticalTransform, "Cube Type", 0, 1, 0, 0, cubeTypes.size() - 1, [](int value) {
+        BulkEdit edit;
+        edit.fields = BulkEdit::Type;
+        edit.type = value;
+        applyBulk(edit);
+        typeInc->Text->SetText(cubeTypes[value]);
+    });
+    typeInc->Text->SetText(cubeTypes[0]);
+    actionInc = BeatSaberUI::CreateIncrementSetting(verticalTransform, "Hit Action", 0, 1, 0, 0, hitActions.size() - 1, [](int value) {
+        BulkEdit edit;
+        edit.fields = BulkEdit::HitAction;
+        edit.hitAction = hitActions.id(value);
+        applyBulk(edit);
+        actionInc->Text->SetText(hitActions.name(edit.hitAction));
+    });
+    actionInc->Text->SetText(hitActions.name(hitActions.id(0)));
+    BeatSaberUI::CreateIncrementSetting(verticalTransform, "Qube Size", 2, 0.05, 1, 0.25, 1.5, [](float value) {
+        BulkEdit edit;
+        edit.fields = BulkEdit::Size;
+        edit.size = value;
+        applyBulk(edit);
+    });
+
+    // the color is only applied with the button, dragging a slider would save on every step
+    for(int channel = 0; channel < 3; channel++) {
+        BeatSaberUI::CreateSliderSetting(verticalTransform, std::string(1, "RGB"[channel]), 1, 255, 0, 255, 0, [channel](float value) {
+            (&bulkColor.r)[channel] = value / 255;
+        });
+    }
+    auto colorRow = row();
+    BeatSaberUI::CreateUIButton(colorRow, "Apply Color", []() {
+        BulkEdit edit;
+        edit.fields = BulkEdit::Color;
+        edit.color = bulkColor;
+        applyBulk(edit);
+    });
+
+    auto lockRow = row();
+    for(bool lock : {true, false}) {
+        BeatSaberUI::CreateUIButton(lockRow, lock ? "Lock" : "Unlock", [lock]() {
+            BulkEdit edit;
+            edit.fields = BulkEdit::Locked;
+            edit.locked = lock;
+            applyBulk(edit);
+        });
+    }
+
+    // in world axes, a tenth of a meter at a time
+    auto moveRow = row();
+    const char* moveNames[] = {"X-", "X+", "Y-", "Y+", "Z-", "Z+"};
+    for(int i = 0; i < 6; i++) {
+        BeatSaberUI::CreateUIButton(moveRow, moveNames[i], [i]() {
+            BulkEdit edit;
+            edit.fields = BulkEdit::Move;
+            (&edit.offset.x)[i / 2] = i % 2 ? 0.1 : -0.1;
+            applyBulk(edit);
+        });
+    }
+
+    // around the vertical axis through the middle of the selection
+    auto turnRow = row();
+    for(float angle : {-15.0f, 15.0f}) {
+        BeatSaberUI::CreateUIButton(turnRow, angle < 0 ? "Turn Left" : "Turn Right", [angle]() {
+            BulkEdit edit;
+            edit.fields = BulkEdit::Rotate;
+            edit.rotation = Math::angleAxis(angle, Math::Vec3::up());
+            applyBulk(edit);
+        });
+    }
+
+    auto endRow = row();
+    BeatSaberUI::CreateUIButton(endRow, "Delete", deleteSelected);
+    BeatSaberUI::CreateUIButton(endRow, "Deselect", clearSelection);
+}
+#pragma endregion
@@ -0,0 +1,126 @@
+#include "main.hpp"
+#include "core/batching.hpp"
+#include "core/allocations.hpp"
+
+#include "UnityEngine/CombineInstance.hpp"
+#include "UnityEngine/Matrix4x4.hpp"
+#include "UnityEngine/Mesh.hpp"
+#include "UnityEngine/MeshFilter.hpp"
+#include "UnityEngine/MeshRenderer.hpp"
+
+#include <unordered_map>
+
+static StaticBatches batches;
+// cubes by their id in batches
+static std::vector<DefaultCube*> members;
+// one object for each chunk, made the first time the chunk is built
+static std::vector<UnityEngine::MeshFilter*> chunkFilters;
+static std::unordered_map<uint32_t, UnityEngine::Material*> materials;
+static std::vector<int> dirty;
+static bool frozen = false;
+static bool limitSet = false;
+
+// combined meshes have 16 bit indices, and small chunks are cheaper to rebuild after a cut
+constexpr int maxVertices = 65535;
+constexpr int maxChunkCubes = 128;
+
+int addStatic(DefaultCube* cube) {
+    if(!limitSet) {
+        int vertices = cube->GetComponent<UnityEngine::MeshFilter*>()->get_sharedMesh()->get_vertexCount();
+        batches.setChunkLimit(std::min(maxVertices / std::max(vertices, 1), maxChunkCubes));
+        limitSet = true;
+    }
+    int id = batches.add(colorKey(cube->getShownColor()));
+    if(id >= (int) members.size())
+        members.resize(id + 1);
+    members[id] = cube;
+    Stats::staticCubes.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+void removeStatic(int id) {
+    batches.remove(id);
+    members[id] = nullptr;
+    Stats::staticCubes.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void setStaticColor(int id, UnityEngine::Color color) {
+    batches.setColor(id, colorKey(color));
+}
+
+void markStaticDirty(int id) {
+    batches.markDirty(id);
+}
+
+// one copy of the cube material for each color
+static UnityEngine::Material* materialFor(uint32_t key, DefaultCube* cube) {
+    auto& material = materials[key];
+    if(!material) {
+        TRACK_ALLOC("static batch Material", sizeof(UnityEngine::Material));
+        material = UnityEngine::Material::New_ctor(cube->GetComponent<UnityEngine::MeshRenderer*>()->get_sharedMaterial());
+        material->set_color(cube->getShownColor());
+    }
+    return material;
+}
+
+static void rebuildChunk(int index) {
+    auto& chunk = batches.getChunk(index);
+    if(index >= (int) chunkFilters.size())
+        chunkFilters.resize(index + 1, nullptr);
+    auto& filter = chunkFilters[index];
+    if(!filter) {
+        auto go = UnityEngine::GameObject::New_ctor("QubesStaticBatch");
+        UnityEngine::Object::DontDestroyOnLoad(go);
+        filter = go->AddComponent<UnityEngine::MeshFilter*>();
+        go->AddComponent<UnityEngine::MeshRenderer*>();
+        filter->set_sharedMesh(UnityEngine::Mesh::New_ctor());
+    }
+
+    // hidden cubes, like ones waiting to respawn, are left out until they come back
+    DefaultCube* first = nullptr;
+    int count = 0;
+    for(int id : chunk.members) {
+        if(members[id]->get_gameObject()->get_activeSelf()) {
+            if(!first)
+                first = members[id];
+            count++;
+        }
+    }
+    filter->get_gameObject()->set_active(count > 0);
+    if(count == 0)
+        return;
+
+    // every cube is made from the same prototype, so they share a mesh
+    auto cubeMesh = first->GetComponent<UnityEngine::MeshFilter*>()->get_sharedMesh();
+    TRACK_ALLOC("static batch CombineInstance", sizeof(Array<UnityEngine::CombineInstance>) + count * sizeof(UnityEngine::CombineInstance));
+    auto combine = Array<UnityEngine::CombineInstance>::NewLength(count);
+    int i = 0;
+    for(int id : chunk.members) {
+        auto go = members[id]->get_gameObject();
+        if(!go->get_activeSelf())
+            continue;
+        auto& instance = combine->values[i++];
+        instance.set_mesh(cubeMesh);
+        instance.set_transform(go->get_transform()->get_localToWorldMatrix());
+    }
+    // the batch objects stay at the origin, so the cubes are combined in world space
+    auto mesh = filter->get_sharedMesh();
+    mesh->Clear();
+    mesh->CombineMeshes(combine, true, true);
+    filter->GetComponent<UnityEngine::MeshRenderer*>()->set_sharedMaterial(materialFor(chunk.color, first));
+}
+
+void updateStaticBatches() {
+    bool freeze = getModConfig().FreezeLayout.GetValue();
+    if(freeze != frozen) {
+        frozen = freeze;
+        for(auto cube : cubeArr)
+            cube->refreshStatic();
+    }
+    batches.takeDirty(dirty);
+    if(dirty.empty())
+        return;
+    TRACE_ZONE("rebuild static batches");
+    for(int chunk : dirty)
+        rebuildChunk(chunk);
+}